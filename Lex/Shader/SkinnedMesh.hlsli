@@ -10,6 +10,8 @@ cbuffer CONSTANT_BUFFER : register( b0 )
 {
 	row_major float4x4	worldViewProjection;
 	row_major float4x4	world;
+	float4				positionOffset;	// The decoded position is "positionOffset + pos * positionScale".
+	float4				positionScale;
 	float4				lightColor;
 	float4				lightDir;
 };
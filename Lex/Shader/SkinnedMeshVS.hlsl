@@ -2,11 +2,11 @@
 
 struct VS_IN
 {
-	float4	pos		: POSITION;
-	float4	normal	: NORMAL;
-	float2	texCoord: TEXCOORD;
-	uint4	bones	: BONES;
-	float4	weights : WEIGHTS;
+	float4	pos		: POSITION;	// R16G16B16A16_UNORM, relative to the bounds of mesh.
+	float2	normal	: NORMAL;	// R16G16_SNORM, octahedral.
+	float2	texCoord: TEXCOORD;	// R16G16_FLOAT.
+	uint4	bones	: BONES;	// R8G8B8A8_UINT.
+	float4	weights : WEIGHTS;	// R8G8B8A8_UNORM, the sum is 1.
 };
 
 float4 VisualizeBoneInfluence( uint4 boneIndices, float4 weights )
@@ -30,14 +30,26 @@ float4 VisualizeBoneInfluence( uint4 boneIndices, float4 weights )
 	return influence;
 }
 
+float3 DecodeOctahedral( float2 encoded )
+{
+	float3 normal = float3( encoded.xy, 1.0f - abs( encoded.x ) - abs( encoded.y ) );
+	if ( normal.z < 0.0f )
+	{
+		// Unfold the lower hemisphere.
+		normal.xy = ( 1.0f - abs( normal.yx ) ) * ( ( 0.0f <= normal.xy ) ? 1.0f : -1.0f );
+	}
+	return normalize( normal );
+}
+
 VS_OUT main( VS_IN vin )
 {
-	vin.normal.w = 0;
-	float4 nNorm	= normalize( mul( vin.normal, world ) );
+	float4 pos		= float4( positionOffset.xyz + vin.pos.xyz * positionScale.xyz, 1.0f );
+	float4 normal	= float4( DecodeOctahedral( vin.normal ), 0.0f );
+	float4 nNorm	= normalize( mul( normal, world ) );
 	float4 nLight	= normalize( lightDir );
 
 	VS_OUT vout = (VS_OUT)( 0 );
-	vout.pos		= mul( vin.pos, worldViewProjection );
+	vout.pos		= mul( pos, worldViewProjection );
 
 	// vout.color		= diffuse * max( dot( -nLight, nNorm ), 0.0f ); // Lambert's cosine law
 	// vout.color.a	= 1.0f;
@@ -0,0 +1,123 @@
+#include "Animation.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Common.h"
+
+using namespace DirectX;
+
+namespace Donya
+{
+	namespace Animation
+	{
+		XMMATRIX Transform::ToMatrix() const
+		{
+			return XMMatrixAffineTransformation
+			(
+				XMLoadFloat3( &scale ),
+				XMVectorZero(),
+				XMLoadFloat4( &rotation ),
+				XMLoadFloat3( &translation )
+			);
+		}
+
+		int Skeleton::FindBone( const std::string &name ) const
+		{
+			const size_t boneCount = bones.size();
+			for ( size_t i = 0; i < boneCount; ++i )
+			{
+				if ( bones[i].name == name ) { return scast<int>( i ); }
+			}
+			return -1;
+		}
+		void Skeleton::GetBindPose( Transform *pOutputPose ) const
+		{
+			const size_t boneCount = bones.size();
+			for ( size_t i = 0; i < boneCount; ++i )
+			{
+				pOutputPose[i] = bones[i].bindPose;
+			}
+		}
+		bool Skeleton::IsValid() const
+		{
+			const size_t boneCount = bones.size();
+			for ( size_t i = 0; i < boneCount; ++i )
+			{
+				if ( bones[i].parent < -1 || scast<int>( i ) <= bones[i].parent ) { return false; }
+			}
+			return true;
+		}
+
+		void Clip::Sample( float seconds, bool isLooping, Transform *pOutputPose ) const
+		{
+			// All the channels share the position between the keys.
+			float frame = 0.0f;
+			if ( 0.0f < duration && 0.0f < samplingRate )
+			{
+				float time = seconds;
+				if ( isLooping )
+				{
+					time = fmodf( time, duration );
+					if ( time < 0.0f ) { time += duration; }
+				}
+				else
+				{
+					time = std::max( 0.0f, std::min( duration, time ) );
+				}
+				frame = time * samplingRate;
+			}
+			const float		floorFrame	= floorf( frame );
+			const size_t	key			= scast<size_t>( floorFrame );
+			const XMVECTOR	percent		= XMVectorReplicate( frame - floorFrame );
+
+			// Returns the pair of keys, the constant channel has only one key.
+			auto LoadKeys = [&key]( const auto &keys, XMVECTOR *pFrom, XMVECTOR *pTo, auto Load )
+			{
+				const size_t last = keys.size() - 1;
+				*pFrom	= Load( &keys[std::min( key,		last )] );
+				*pTo	= Load( &keys[std::min( key + 1,	last )] );
+			};
+			auto Load3 = []( const Donya::Vector3 *p ) { return XMLoadFloat3( p ); };
+			auto Load4 = []( const Donya::Vector4 *p ) { return XMLoadFloat4( p ); };
+
+			const size_t trackCount = tracks.size();
+			for ( size_t i = 0; i < trackCount; ++i )
+			{
+				const Track	&track	= tracks[i];
+				Transform	&output	= pOutputPose[i];
+				output = Transform{};
+
+				XMVECTOR from{}, to{};
+				if ( !track.scales.empty() )
+				{
+					LoadKeys( track.scales, &from, &to, Load3 );
+					XMStoreFloat3( &output.scale, XMVectorLerpV( from, to, percent ) );
+				}
+				if ( !track.rotations.empty() )
+				{
+					// The normalized linear interpolation is enough between the dense keys.
+					LoadKeys( track.rotations, &from, &to, Load4 );
+					XMStoreFloat4( &output.rotation, XMQuaternionNormalize( XMVectorLerpV( from, to, percent ) ) );
+				}
+				if ( !track.translations.empty() )
+				{
+					LoadKeys( track.translations, &from, &to, Load3 );
+					XMStoreFloat3( &output.translation, XMVectorLerpV( from, to, percent ) );
+				}
+			}
+		}
+
+		void CalcModelMatrices( const Skeleton &skeleton, const Transform *pLocalPose, XMFLOAT4X4 *pOutputMatrices )
+		{
+			const size_t boneCount = skeleton.bones.size();
+			for ( size_t i = 0; i < boneCount; ++i )
+			{
+				const int		parent	= skeleton.bones[i].parent;
+				const XMMATRIX	local	= pLocalPose[i].ToMatrix();
+				const XMMATRIX	model	= ( 0 <= parent ) ? local * XMLoadFloat4x4( &pOutputMatrices[parent] ) : local;
+				XMStoreFloat4x4( &pOutputMatrices[i], model );
+			}
+		}
+	}
+}
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
+#include <DirectXMath.h>
+
+#include "Serializer.h"
+#include "Vector.h"
+
+template<> struct IsBulkSerializable<Donya::Vector4> : std::true_type {};
+static_assert( sizeof( Donya::Vector4 ) == sizeof( float ) * 4, "The bulk serialization and the native mesh format expect the Vector4 is a plain array of float." );
+
+namespace Donya
+{
+	/// <summary>
+	/// The skeleton and the animation clips in the runtime form, these are imported by the Loader.<para></para>
+	/// The rotations are the quaternions that are stored as Vector4(x, y, z, w).
+	/// </summary>
+	namespace Animation
+	{
+		/// <summary>
+		/// The transform of a bone that is relative to its parent. It is applied in the order of scale, rotation, translation.
+		/// </summary>
+		struct Transform
+		{
+			Donya::Vector3 scale{ 1.0f, 1.0f, 1.0f };
+			Donya::Vector4 rotation{ 0.0f, 0.0f, 0.0f, 1.0f };
+			Donya::Vector3 translation{ 0.0f, 0.0f, 0.0f };
+		public:
+			DirectX::XMMATRIX ToMatrix() const;
+		private:
+			friend class cereal::access;
+			template<class Archive>
+			void serialize( Archive &archive, std::uint32_t version )
+			{
+				archive
+				(
+					CEREAL_NVP( scale ),
+					CEREAL_NVP( rotation ),
+					CEREAL_NVP( translation )
+				);
+				if ( 1 <= version )
+				{
+					// archive();
+				}
+			}
+		};
+
+		struct Bone
+		{
+			std::string	name{};
+			int			parent{ -1 };	// The index of parent bone, it is always less than own index. -1 is the root.
+			Transform	bindPose{};		// The local transform at the binding.
+		private:
+			friend class cereal::access;
+			template<class Archive>
+			void serialize( Archive &archive, std::uint32_t version )
+			{
+				archive
+				(
+					CEREAL_NVP( name ),
+					CEREAL_NVP( parent ),
+					CEREAL_NVP( bindPose )
+				);
+				if ( 1 <= version )
+				{
+					// archive();
+				}
+			}
+		};
+
+		/// <summary>
+		/// The bones are ordered so that the parent is before its children, then a pose is composed by one pass from the front.
+		/// </summary>
+		struct Skeleton
+		{
+			std::vector<Bone> bones{};
+		public:
+			bool IsEmpty() const { return bones.empty(); }
+			/// <summary>
+			/// Returns -1 if not found.
+			/// </summary>
+			int FindBone( const std::string &name ) const;
+			/// <summary>
+			/// Writes the bind pose into pOutputPose[0 ~ bones.size()).
+			/// </summary>
+			void GetBindPose( Transform *pOutputPose ) const;
+			/// <summary>
+			/// Returns false if some parent is not before its child.
+			/// </summary>
+			bool IsValid() const;
+		private:
+			friend class cereal::access;
+			template<class Archive>
+			void serialize( Archive &archive, std::uint32_t version )
+			{
+				archive( CEREAL_NVP( bones ) );
+				if ( 1 <= version )
+				{
+					// archive();
+				}
+			}
+		};
+
+		/// <summary>
+		/// The keys of a bone, these are sampled at the fixed rate of the clip.<para></para>
+		/// The channel that has only one key is constant through the clip.
+		/// </summary>
+		struct Track
+		{
+			std::vector<Donya::Vector3> scales{};
+			std::vector<Donya::Vector4> rotations{};	// The neighbors are in the same hemisphere, so those can be interpolated linearly.
+			std::vector<Donya::Vector3> translations{};
+		private:
+			friend class cereal::access;
+			template<class Archive>
+			void serialize( Archive &archive, std::uint32_t version )
+			{
+				archive
+				(
+					CEREAL_BULK_NVP( scales ),
+					CEREAL_BULK_NVP( rotations ),
+					CEREAL_BULK_NVP( translations )
+				);
+				if ( 1 <= version )
+				{
+					// archive();
+				}
+			}
+		};
+
+		struct Clip
+		{
+			std::string			name{};
+			float				samplingRate{};	// Keys per second.
+			float				duration{};		// Seconds. The last key is at the duration.
+			std::vector<Track>	tracks{};		// Per bone of the skeleton.
+		public:
+			/// <summary>
+			/// Samples the local transforms of all bones at the time into pOutputPose[0 ~ tracks.size()).<para></para>
+			/// The time is wrapped into the duration if "isLooping", else it is clamped.
+			/// </summary>
+			void Sample( float seconds, bool isLooping, Transform *pOutputPose ) const;
+		private:
+			friend class cereal::access;
+			template<class Archive>
+			void serialize( Archive &archive, std::uint32_t version )
+			{
+				archive
+				(
+					CEREAL_NVP( name ),
+					CEREAL_NVP( samplingRate ),
+					CEREAL_NVP( duration ),
+					CEREAL_NVP( tracks )
+				);
+				if ( 1 <= version )
+				{
+					// archive();
+				}
+			}
+		};
+
+		/// <summary>
+		/// Composes the local pose into the matrices of the model space, these are "local * parent's".<para></para>
+		/// The "pOutputMatrices" must have skeleton.bones.size() elements.
+		/// </summary>
+		void CalcModelMatrices( const Skeleton &skeleton, const Transform *pLocalPose, DirectX::XMFLOAT4X4 *pOutputMatrices );
+	}
+}
+
+static_assert( sizeof( Donya::Animation::Transform ) == sizeof( float ) * 10, "The native mesh format expects the Transform has no padding." );
+
+CEREAL_CLASS_VERSION( Donya::Animation::Transform, 0 )
+CEREAL_CLASS_VERSION( Donya::Animation::Bone, 0 )
+CEREAL_CLASS_VERSION( Donya::Animation::Skeleton, 0 )
+CEREAL_CLASS_VERSION( Donya::Animation::Track, 0 )
+CEREAL_CLASS_VERSION( Donya::Animation::Clip, 0 )
@@ -0,0 +1,633 @@
+#include "AnimationCompression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <crtdbg.h>
+
+#include "Common.h"
+
+namespace Donya
+{
+	namespace AnimationCompression
+	{
+		constexpr float			SMALLEST_THREE_RANGE	= 0.70710678f;	// 1 / sqrt( 2 ), the components except the largest are within it.
+		constexpr float			UNORM15_MAX				= 32767.0f;
+		// The span of a segment that is tried to drop the keys, it bounds the cost of reduction.
+		constexpr size_t		MAX_KEY_INTERVAL		= 256;
+
+		void UpdateMaxError( float error, float *pMaxError )
+		{
+			if ( error <= *pMaxError ) { return; }
+			// else
+			*pMaxError = ( std::isnan( error ) ) ? HUGE_VALF : error;
+		}
+
+	#pragma region Rotation
+
+		std::uint32_t EncodeComponent( float value )
+		{
+			float normalized = ( value / SMALLEST_THREE_RANGE ) * 0.5f + 0.5f;
+			normalized = ( normalized < 0.0f ) ? 0.0f : ( 1.0f < normalized ) ? 1.0f : normalized;
+			return scast<std::uint32_t>( normalized * UNORM15_MAX + 0.5f );
+		}
+		float DecodeComponent( std::uint32_t bits )
+		{
+			return ( ( scast<float>( bits ) / UNORM15_MAX ) * 2.0f - 1.0f ) * SMALLEST_THREE_RANGE;
+		}
+
+		QuantizedRotation EncodeRotation( const Donya::Quaternion &rotation )
+		{
+			Donya::Quaternion normalized = rotation;
+			normalized.Normalize();
+			const float components[4]{ normalized.x, normalized.y, normalized.z, normalized.w };
+
+			int largest = 0;
+			for ( int i = 1; i < 4; ++i )
+			{
+				if ( fabsf( components[largest] ) < fabsf( components[i] ) ) { largest = i; }
+			}
+			// The "Q" and "-Q" are the same rotation, so the largest can be always positive.
+			const float sign = ( components[largest] < 0.0f ) ? -1.0f : 1.0f;
+
+			// [Largest:2 bits][Component:15 bits]x3, in the ascending order of the component index.
+			std::uint64_t packed = scast<std::uint64_t>( largest );
+			for ( int i = 0; i < 4; ++i )
+			{
+				if ( i == largest ) { continue; }
+				// else
+				packed = ( packed << 15 ) | EncodeComponent( components[i] * sign );
+			}
+
+			QuantizedRotation result{};
+			result.bits[0] = scast<std::uint16_t>( ( packed >> 32 ) & 0xFFFF );
+			result.bits[1] = scast<std::uint16_t>( ( packed >> 16 ) & 0xFFFF );
+			result.bits[2] = scast<std::uint16_t>( ( packed       ) & 0xFFFF );
+			return result;
+		}
+		Donya::Quaternion DecodeRotation( const QuantizedRotation &rotation )
+		{
+			std::uint64_t packed =
+				( scast<std::uint64_t>( rotation.bits[0] ) << 32 ) |
+				( scast<std::uint64_t>( rotation.bits[1] ) << 16 ) |
+				( scast<std::uint64_t>( rotation.bits[2] )       );
+			const int largest = scast<int>( ( packed >> 45 ) & 0x3 );
+
+			float components[4]{};
+			float lengthSq = 0.0f;
+			for ( int i = 3; 0 <= i; --i )
+			{
+				if ( i == largest ) { continue; }
+				// else
+				components[i] = DecodeComponent( scast<std::uint32_t>( packed & 0x7FFF ) );
+				lengthSq += components[i] * components[i];
+				packed >>= 15;
+			}
+			components[largest] = sqrtf( std::max( 0.0f, 1.0f - lengthSq ) );
+
+			Donya::Quaternion result{ components[0], components[1], components[2], components[3] };
+			result.Normalize();
+			return result;
+		}
+
+	// region Rotation
+	#pragma endregion
+
+	#pragma region Interpolation
+
+		Donya::Vector3 Lerp( const Donya::Vector3 &from, const Donya::Vector3 &to, float percent )
+		{
+			return from + ( to - from ) * percent;
+		}
+		/// <summary>
+		/// The decoded keys may be in the opposite hemispheres, then the shorter arc is taken.
+		/// </summary>
+		Donya::Quaternion Nlerp( const Donya::Quaternion &from, const Donya::Quaternion &to, float percent )
+		{
+			const float sign = ( Donya::Quaternion::Dot( from, to ) < 0.0f ) ? -1.0f : 1.0f;
+			Donya::Quaternion result = ( from * ( 1.0f - percent ) ) + ( to * ( sign * percent ) );
+			result.Normalize();
+			return result;
+		}
+
+		float CalcDistance( const Donya::Vector3 &L, const Donya::Vector3 &R )
+		{
+			return ( L - R ).Length();
+		}
+		/// <summary>
+		/// Returns the angle between the rotations in degrees.<para></para>
+		/// It is calculated from the chord length, because the acos of the dot product is not precise for the small angle.
+		/// </summary>
+		float CalcAngleDegree( const Donya::Quaternion &L, const Donya::Quaternion &R )
+		{
+			const float sign = ( Donya::Quaternion::Dot( L, R ) < 0.0f ) ? -1.0f : 1.0f;
+			const float halfChord = std::min( 1.0f, ( L - ( R * sign ) ).Length() * 0.5f );
+			return ToDegree( 4.0f * asinf( halfChord ) );
+		}
+
+	// region Interpolation
+	#pragma endregion
+
+		size_t CalcFrameCount( const Animation::Clip &clip )
+		{
+			size_t frameCount = 1;
+			for ( const auto &track : clip.tracks )
+			{
+				frameCount = std::max( frameCount, track.scales.size()		);
+				frameCount = std::max( frameCount, track.rotations.size()	);
+				frameCount = std::max( frameCount, track.translations.size()	);
+			}
+			return frameCount;
+		}
+
+		bool CanCompress( const Animation::Clip &clip )
+		{
+			return CalcFrameCount( clip ) <= MAX_FRAME_COUNT;
+		}
+
+		/// <summary>
+		/// Appends the kept keys of a channel into the frames and keys, then returns the channel of those.<para></para>
+		/// The segment from the last kept key is extended while the interpolation of its ends reproduces all the keys between those.
+		/// </summary>
+		template<typename ValueType, typename QuantizedType, typename EncodeFunction, typename DecodeFunction, typename InterpolateFunction, typename MeasureFunction>
+		Channel ReduceKeys( const std::vector<ValueType> &source, float tolerance, EncodeFunction Encode, DecodeFunction Decode, InterpolateFunction Interpolate, MeasureFunction Measure, std::vector<std::uint16_t> *pFrames, std::vector<QuantizedType> *pKeys, float *pMaxError )
+		{
+			Channel channel{};
+			channel.keyBegin = scast<std::uint32_t>( pKeys->size() );
+
+			const size_t keyCount = source.size();
+			if ( !keyCount ) { return channel; }
+			// else
+
+			// The interpolation uses the decoded keys, so the quantization error is also measured.
+			std::vector<QuantizedType>	encoded( keyCount );
+			std::vector<ValueType>		decoded( keyCount );
+			for ( size_t i = 0; i < keyCount; ++i )
+			{
+				encoded[i] = Encode( source[i] );
+				decoded[i] = Decode( encoded[i] );
+			}
+
+			// Returns the error at "index" when only the "begin" and the "end" are kept. The "end" equals to the "begin" if it is the last kept key.
+			auto CalcError = [&]( size_t begin, size_t end, size_t index )
+			{
+				if ( index == begin || end == begin ) { return Measure( decoded[begin], source[index] ); }
+				// else
+				const float percent = scast<float>( index - begin ) / scast<float>( end - begin );
+				return Measure( Interpolate( decoded[begin], decoded[end], percent ), source[index] );
+			};
+			auto IsReproducible = [&]( size_t begin, size_t end )
+			{
+				for ( size_t i = begin + 1; i < end; ++i )
+				{
+					if ( tolerance < CalcError( begin, end, i ) ) { return false; }
+				}
+				return true;
+			};
+
+			std::vector<size_t> keptIndices{ 0 };
+			size_t begin = 0;
+			while ( begin + 1 < keyCount )
+			{
+				size_t end = begin + 1;
+				while ( end + 1 < keyCount && end + 1 - begin <= MAX_KEY_INTERVAL && IsReproducible( begin, end + 1 ) )
+				{
+					++end;
+				}
+				keptIndices.emplace_back( end );
+				begin = end;
+			}
+			// The channel that keeps only the same two keys is constant.
+			if ( keptIndices.size() == 2 && memcmp( &encoded.front(), &encoded.back(), sizeof( QuantizedType ) ) == 0 )
+			{
+				keptIndices.pop_back();
+			}
+
+			float maxError = 0.0f;
+			const size_t keptCount = keptIndices.size();
+			for ( size_t k = 0; k < keptCount; ++k )
+			{
+				const size_t keyBegin	= keptIndices[k];
+				const size_t keyEnd		= ( k + 1 < keptCount ) ? keptIndices[k + 1] : keyCount;
+				for ( size_t i = keyBegin; i < keyEnd; ++i )
+				{
+					UpdateMaxError( CalcError( keyBegin, ( k + 1 < keptCount ) ? keyEnd : keyBegin, i ), &maxError );
+				}
+
+				pFrames->emplace_back( scast<std::uint16_t>( keyBegin ) );
+				pKeys->emplace_back( encoded[keyBegin] );
+			}
+			UpdateMaxError( maxError, pMaxError );
+
+			channel.keyCount = scast<std::uint32_t>( keptCount );
+			return channel;
+		}
+		/// <summary>
+		/// Discards the quantized keys that were appended from the "keyMark"(the frames are parallel to those), then appends all the keys of source as is.
+		/// </summary>
+		template<typename QuantizedType, typename RawType>
+		Channel StoreRawKeys( const std::vector<RawType> &source, size_t keyMark, std::vector<std::uint16_t> *pFrames, std::vector<QuantizedType> *pKeys, std::vector<RawType> *pRawKeys )
+		{
+			pFrames->resize( keyMark );
+			pKeys->resize( keyMark );
+
+			Channel channel{};
+			channel.keyBegin = scast<std::uint32_t>( pRawKeys->size() );
+			channel.keyCount = scast<std::uint32_t>( source.size() );
+			pRawKeys->insert( pRawKeys->end(), source.begin(), source.end() );
+			return channel;
+		}
+
+		CompressedClip Compress( const Animation::Clip &clip, const Tolerance &tolerance )
+		{
+			_ASSERT_EXPR( CanCompress( clip ), L"Error : The clip has too many frames to compress!" );
+
+			namespace Quantization = VertexQuantization;
+
+			CompressedClip result{};
+			result.name			= clip.name;
+			result.samplingRate	= clip.samplingRate;
+			result.duration		= clip.duration;
+			result.frameCount	= scast<std::uint32_t>( CalcFrameCount( clip ) );
+			result.tracks.reserve( clip.tracks.size() );
+			result.encodings.reserve( clip.tracks.size() );
+
+			Report &report = result.report;
+			std::vector<Donya::Quaternion> rotations{};
+			for ( const auto &track : clip.tracks )
+			{
+				report.sourceKeyCount += scast<std::uint32_t>( track.scales.size() + track.rotations.size() + track.translations.size() );
+
+				CompressedTrack compressed{};
+				TrackEncoding	encoding{};
+				compressed.scaleFrame		= Quantization::MakePositionFrame( track.scales );
+				compressed.translationFrame	= Quantization::MakePositionFrame( track.translations );
+
+				// The error of the Float32 channel is zero, because all the keys are kept as is.
+				float	channelError	= 0.0f;
+				size_t	keyMark			= result.scales.size();
+
+				const auto &scaleFrame = compressed.scaleFrame;
+				compressed.scale = ReduceKeys
+				(
+					track.scales, tolerance.scale,
+					[&scaleFrame]( const Donya::Vector3 &key ) { return Quantization::EncodePosition( key, scaleFrame ); },
+					[&scaleFrame]( const Quantization::QuantizedPosition &key ) { return Quantization::DecodePosition( key, scaleFrame ); },
+					Lerp, CalcDistance,
+					&result.scaleFrames, &result.scales, &channelError
+				);
+				if ( tolerance.scale < channelError )
+				{
+					compressed.scale	= StoreRawKeys( track.scales, keyMark, &result.scaleFrames, &result.scales, &result.rawScales );
+					encoding.scale		= KeyEncoding::Float32;
+					channelError		= 0.0f;
+				}
+				UpdateMaxError( channelError, &report.scaleError );
+
+				rotations.clear();
+				for ( const auto &key : track.rotations )
+				{
+					rotations.emplace_back( key.x, key.y, key.z, key.w );
+				}
+				channelError	= 0.0f;
+				keyMark			= result.rotations.size();
+				compressed.rotation = ReduceKeys
+				(
+					rotations, tolerance.rotation,
+					EncodeRotation, DecodeRotation,
+					Nlerp, CalcAngleDegree,
+					&result.rotationFrames, &result.rotations, &channelError
+				);
+				if ( tolerance.rotation < channelError )
+				{
+					compressed.rotation	= StoreRawKeys( track.rotations, keyMark, &result.rotationFrames, &result.rotations, &result.rawRotations );
+					encoding.rotation	= KeyEncoding::Float32;
+					channelError		= 0.0f;
+				}
+				UpdateMaxError( channelError, &report.rotationError );
+
+				const auto &translationFrame = compressed.translationFrame;
+				channelError	= 0.0f;
+				keyMark			= result.translations.size();
+				compressed.translation = ReduceKeys
+				(
+					track.translations, tolerance.translation,
+					[&translationFrame]( const Donya::Vector3 &key ) { return Quantization::EncodePosition( key, translationFrame ); },
+					[&translationFrame]( const Quantization::QuantizedPosition &key ) { return Quantization::DecodePosition( key, translationFrame ); },
+					Lerp, CalcDistance,
+					&result.translationFrames, &result.translations, &channelError
+				);
+				if ( tolerance.translation < channelError )
+				{
+					compressed.translation	= StoreRawKeys( track.translations, keyMark, &result.translationFrames, &result.translations, &result.rawTranslations );
+					encoding.translation	= KeyEncoding::Float32;
+					channelError			= 0.0f;
+				}
+				UpdateMaxError( channelError, &report.translationError );
+
+				result.tracks.emplace_back( compressed );
+				result.encodings.emplace_back( encoding );
+			}
+
+			report.keptKeyCount = scast<std::uint32_t>
+			(
+				result.scales.size()	+ result.rotations.size()		+ result.translations.size() +
+				result.rawScales.size()	+ result.rawRotations.size()	+ result.rawTranslations.size()
+			);
+			return result;
+		}
+
+		/// <summary>
+		/// Appends the keys of every frame of a channel, those are interpolated between the kept keys.<para></para>
+		/// The "Decode( k )" returns the kept key of index k in the key arrays.
+		/// </summary>
+		template<typename ValueType, typename DecodeFunction, typename InterpolateFunction>
+		void RestoreKeys( const std::vector<std::uint16_t> &frames, const Channel &channel, DecodeFunction Decode, InterpolateFunction Interpolate, std::vector<ValueType> *pOutput )
+		{
+			if ( !channel.keyCount ) { return; }
+			// else
+
+			const size_t keyLast = channel.keyBegin + channel.keyCount - 1;
+			pOutput->reserve( pOutput->size() + frames[keyLast] + 1 );
+			pOutput->emplace_back( Decode( channel.keyBegin ) );
+			for ( size_t k = channel.keyBegin + 1; k <= keyLast; ++k )
+			{
+				const ValueType	from	= Decode( k - 1 );
+				const ValueType	to		= Decode( k );
+				const size_t	span	= frames[k] - frames[k - 1];
+				for ( size_t f = 1; f <= span; ++f )
+				{
+					pOutput->emplace_back( Interpolate( from, to, scast<float>( f ) / scast<float>( span ) ) );
+				}
+			}
+		}
+
+		Animation::Clip Decompress( const CompressedClip &clip )
+		{
+			_ASSERT_EXPR( clip.IsValid(), L"Error : The compressed clip is broken!" );
+
+			namespace Quantization = VertexQuantization;
+
+			Animation::Clip result{};
+			result.name			= clip.name;
+			result.samplingRate	= clip.samplingRate;
+			result.duration		= clip.duration;
+			result.tracks.resize( clip.tracks.size() );
+
+			std::vector<Donya::Quaternion> rotations{};
+			const size_t trackCount = clip.tracks.size();
+			// The Float32 channel has the key of every frame as is.
+			auto CopyRawKeys = []( const auto &rawKeys, const Channel &channel, auto *pOutput )
+			{
+				pOutput->assign( rawKeys.begin() + channel.keyBegin, rawKeys.begin() + channel.keyBegin + channel.keyCount );
+			};
+
+			for ( size_t i = 0; i < trackCount; ++i )
+			{
+				const CompressedTrack	&source		= clip.tracks[i];
+				const TrackEncoding		&encoding	= clip.encodings[i];
+				Animation::Track		&output		= result.tracks[i];
+
+				if ( encoding.scale == KeyEncoding::Float32 )
+				{
+					CopyRawKeys( clip.rawScales, source.scale, &output.scales );
+				}
+				else
+				{
+					RestoreKeys
+					(
+						clip.scaleFrames, source.scale,
+						[&]( size_t k ) { return Quantization::DecodePosition( clip.scales[k], source.scaleFrame ); },
+						Lerp, &output.scales
+					);
+				}
+				if ( encoding.translation == KeyEncoding::Float32 )
+				{
+					CopyRawKeys( clip.rawTranslations, source.translation, &output.translations );
+				}
+				else
+				{
+					RestoreKeys
+					(
+						clip.translationFrames, source.translation,
+						[&]( size_t k ) { return Quantization::DecodePosition( clip.translations[k], source.translationFrame ); },
+						Lerp, &output.translations
+					);
+				}
+
+				if ( encoding.rotation == KeyEncoding::Float32 )
+				{
+					CopyRawKeys( clip.rawRotations, source.rotation, &output.rotations );
+					continue;
+				}
+				// else
+
+				rotations.clear();
+				RestoreKeys
+				(
+					clip.rotationFrames, source.rotation,
+					[&]( size_t k ) { return DecodeRotation( clip.rotations[k] ); },
+					Nlerp, &rotations
+				);
+				// The decoded keys are in the positive hemisphere of their largest components, so the neighbors are aligned as Animation::Track expects.
+				output.rotations.reserve( rotations.size() );
+				for ( size_t k = 0; k < rotations.size(); ++k )
+				{
+					if ( k && Donya::Quaternion::Dot( rotations[k - 1], rotations[k] ) < 0.0f )
+					{
+						rotations[k] = rotations[k] * -1.0f;
+					}
+					output.rotations.emplace_back( rotations[k].x, rotations[k].y, rotations[k].z, rotations[k].w );
+				}
+			}
+
+			return result;
+		}
+
+		void CompressedClip::Sample( float seconds, bool isLooping, Animation::Transform *pOutputPose ) const
+		{
+			// All the channels share the position in the frames.
+			float frame = 0.0f;
+			if ( 0.0f < duration && 0.0f < samplingRate )
+			{
+				float time = seconds;
+				if ( isLooping )
+				{
+					time = fmodf( time, duration );
+					if ( time < 0.0f ) { time += duration; }
+				}
+				else
+				{
+					time = std::max( 0.0f, std::min( duration, time ) );
+				}
+				frame = time * samplingRate;
+			}
+
+			// Returns the pair of keys around the frame and the percent between those. The pair is same at after the last key.
+			auto Locate = [&frame]( const std::vector<std::uint16_t> &frames, const Channel &channel, size_t *pFrom, size_t *pTo, float *pPercent )
+			{
+				const auto itFirst	= frames.begin() + channel.keyBegin;
+				const auto itLast	= itFirst + channel.keyCount;
+				// The first key is at frame zero, so the found one is never the first.
+				const auto itUpper	= std::upper_bound
+				(
+					itFirst + 1, itLast, frame,
+					[]( float value, std::uint16_t key ) { return value < scast<float>( key ); }
+				);
+				if ( itUpper == itLast )
+				{
+					*pFrom		= channel.keyBegin + channel.keyCount - 1;
+					*pTo		= *pFrom;
+					*pPercent	= 0.0f;
+					return;
+				}
+				// else
+
+				*pTo		= scast<size_t>( itUpper - frames.begin() );
+				*pFrom		= *pTo - 1;
+				*pPercent	= ( frame - scast<float>( frames[*pFrom] ) ) / scast<float>( frames[*pTo] - frames[*pFrom] );
+			};
+
+			// The Float32 channel has the key of every frame, so the keys are found directly.
+			auto LocateRaw = [&frame]( const Channel &channel, size_t *pFrom, size_t *pTo, float *pPercent )
+			{
+				const size_t	keyLast	= channel.keyBegin + channel.keyCount - 1;
+				const float		index	= floorf( frame );
+				*pFrom		= std::min( keyLast, channel.keyBegin + scast<size_t>( index ) );
+				*pTo		= std::min( keyLast, *pFrom + 1 );
+				*pPercent	= ( *pFrom == *pTo ) ? 0.0f : frame - index;
+			};
+			auto ToQuaternion = []( const Donya::Vector4 &key )
+			{
+				return Donya::Quaternion{ key.x, key.y, key.z, key.w };
+			};
+
+			namespace Quantization = VertexQuantization;
+
+			size_t	from	= 0;
+			size_t	to		= 0;
+			float	percent	= 0.0f;
+			const size_t trackCount = tracks.size();
+			for ( size_t i = 0; i < trackCount; ++i )
+			{
+				const CompressedTrack	&track		= tracks[i];
+				const TrackEncoding		&encoding	= encodings[i];
+				Animation::Transform	&output		= pOutputPose[i];
+				output = Animation::Transform{};
+
+				if ( track.scale.keyCount && encoding.scale == KeyEncoding::Float32 )
+				{
+					LocateRaw( track.scale, &from, &to, &percent );
+					output.scale = Lerp( rawScales[from], rawScales[to], percent );
+				}
+				else if ( track.scale.keyCount )
+				{
+					Locate( scaleFrames, track.scale, &from, &to, &percent );
+					output.scale = Lerp
+					(
+						Quantization::DecodePosition( scales[from],	track.scaleFrame ),
+						Quantization::DecodePosition( scales[to],	track.scaleFrame ),
+						percent
+					);
+				}
+
+				if ( track.rotation.keyCount )
+				{
+					Donya::Quaternion rotation{};
+					if ( encoding.rotation == KeyEncoding::Float32 )
+					{
+						LocateRaw( track.rotation, &from, &to, &percent );
+						rotation = Nlerp( ToQuaternion( rawRotations[from] ), ToQuaternion( rawRotations[to] ), percent );
+					}
+					else
+					{
+						Locate( rotationFrames, track.rotation, &from, &to, &percent );
+						rotation = Nlerp( DecodeRotation( rotations[from] ), DecodeRotation( rotations[to] ), percent );
+					}
+					output.rotation = Donya::Vector4{ rotation.x, rotation.y, rotation.z, rotation.w };
+				}
+
+				if ( track.translation.keyCount && encoding.translation == KeyEncoding::Float32 )
+				{
+					LocateRaw( track.translation, &from, &to, &percent );
+					output.translation = Lerp( rawTranslations[from], rawTranslations[to], percent );
+				}
+				else if ( track.translation.keyCount )
+				{
+					Locate( translationFrames, track.translation, &from, &to, &percent );
+					output.translation = Lerp
+					(
+						Quantization::DecodePosition( translations[from],	track.translationFrame ),
+						Quantization::DecodePosition( translations[to],		track.translationFrame ),
+						percent
+					);
+				}
+			}
+		}
+
+		bool CompressedClip::IsValid() const
+		{
+			if ( !frameCount || MAX_FRAME_COUNT < frameCount ) { return false; }
+			if ( scaleFrames.size() != scales.size() || rotationFrames.size() != rotations.size() || translationFrames.size() != translations.size() ) { return false; }
+			if ( encodings.size() != tracks.size() ) { return false; }
+			// else
+
+			auto IsValidChannel = [this]( const std::vector<std::uint16_t> &frames, const Channel &channel )
+			{
+				if ( frames.size() < channel.keyBegin || frames.size() - channel.keyBegin < channel.keyCount ) { return false; }
+				if ( !channel.keyCount ) { return true; }
+				if ( frames[channel.keyBegin] != 0 ) { return false; }
+				// else
+
+				const size_t keyEnd = channel.keyBegin + channel.keyCount;
+				for ( size_t i = channel.keyBegin + 1; i < keyEnd; ++i )
+				{
+					if ( frames[i] <= frames[i - 1] ) { return false; }
+				}
+				return frames[keyEnd - 1] < frameCount;
+			};
+			auto IsValidRawChannel = [this]( size_t rawKeyCount, const Channel &channel )
+			{
+				if ( rawKeyCount < channel.keyBegin || rawKeyCount - channel.keyBegin < channel.keyCount ) { return false; }
+				// else
+				return channel.keyCount <= frameCount;
+			};
+			auto IsValidEncodedChannel = [&]( KeyEncoding encoding, const std::vector<std::uint16_t> &frames, size_t rawKeyCount, const Channel &channel )
+			{
+				switch ( encoding )
+				{
+				case KeyEncoding::Quantized:	return IsValidChannel( frames, channel );
+				case KeyEncoding::Float32:		return IsValidRawChannel( rawKeyCount, channel );
+				default: break;
+				}
+				return false;
+			};
+
+			const size_t trackCount = tracks.size();
+			for ( size_t i = 0; i < trackCount; ++i )
+			{
+				const auto &track		= tracks[i];
+				const auto &encoding	= encodings[i];
+				if ( !IsValidEncodedChannel( encoding.scale,		scaleFrames,		rawScales.size(),		track.scale			) ) { return false; }
+				if ( !IsValidEncodedChannel( encoding.rotation,		rotationFrames,		rawRotations.size(),	track.rotation		) ) { return false; }
+				if ( !IsValidEncodedChannel( encoding.translation,	translationFrames,	rawTranslations.size(),	track.translation	) ) { return false; }
+			}
+			return true;
+		}
+
+		size_t CompressedClip::GetByteSize() const
+		{
+			const size_t keyCount = scales.size() + rotations.size() + translations.size();
+			return
+				( tracks.size()				* sizeof( CompressedTrack )						) +
+				( encodings.size()			* sizeof( TrackEncoding )						) +
+				( keyCount					* sizeof( std::uint16_t )						) +
+				( scales.size()				* sizeof( VertexQuantization::QuantizedPosition )	) +
+				( rotations.size()			* sizeof( QuantizedRotation )					) +
+				( translations.size()		* sizeof( VertexQuantization::QuantizedPosition )	) +
+				( rawScales.size()			* sizeof( Donya::Vector3 )						) +
+				( rawRotations.size()		* sizeof( Donya::Vector4 )						) +
+				( rawTranslations.size()	* sizeof( Donya::Vector3 )						);
+		}
+	}
+}
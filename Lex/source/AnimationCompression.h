@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Animation.h"
+#include "Quaternion.h"
+#include "VertexQuantization.h"
+
+namespace Donya
+{
+	/// <summary>
+	/// The compact form of the animation clips, for the native file(and the import cache) and the runtime.<para></para>
+	/// Rotations : Smallest-three in 48 bits.<para></para>
+	/// Translations, Scales : UNORM16 relative to the range of track.<para></para>
+	/// The keys that the interpolation of neighbors can reproduce within the tolerance are dropped.<para></para>
+	/// The channel that the quantization can not keep within the tolerance(e.g. the translation of long range) is stored as Float32 with all the keys.
+	/// </summary>
+	namespace AnimationCompression
+	{
+		/// <summary>
+		/// The frame indices of keys are 16 bits, so the longer clip can not be compressed.
+		/// </summary>
+		constexpr std::uint32_t MAX_FRAME_COUNT = 65536U;
+
+		/// <summary>
+		/// The max error that is allowed per channel at any frame, it includes the quantization error.<para></para>
+		/// The channel that exceeds it even if all the keys are kept is not quantized.
+		/// </summary>
+		struct Tolerance
+		{
+			float rotation		= 0.05f;	// Degrees.
+			float translation	= 1.0e-3f;	// Model units.
+			float scale			= 1.0e-4f;
+		};
+
+		/// <summary>
+		/// The key counts and the measured max errors of a clip. The units of errors are the same as Tolerance.
+		/// </summary>
+		struct Report
+		{
+			std::uint32_t	sourceKeyCount		= 0;
+			std::uint32_t	keptKeyCount		= 0;
+			float			rotationError		= 0.0f;
+			float			translationError	= 0.0f;
+			float			scaleError			= 0.0f;
+		};
+
+	#pragma region Elements
+
+		/// <summary>
+		/// The index of largest component(2 bits) and the other three components(15 bits each) of a normalized quaternion.<para></para>
+		/// The largest component is restored from the unit length, the sign of quaternion is chosen as it is positive.
+		/// </summary>
+		struct QuantizedRotation
+		{
+			std::uint16_t bits[3];
+		};
+
+		/// <summary>
+		/// The keys of a channel are [keyBegin ~ keyBegin + keyCount) of the key arrays(and the frame arrays) of the clip.<para></para>
+		/// The Float32 channel refers the raw key arrays instead, and its key is at every frame, so it has no frame array.<para></para>
+		/// The empty channel keeps the default of Animation::Transform, the channel that has only one key is constant.
+		/// </summary>
+		struct Channel
+		{
+			std::uint32_t keyBegin;
+			std::uint32_t keyCount;
+		};
+		enum class KeyEncoding : std::uint32_t
+		{
+			Quantized	= 0,	// Smallest-three for rotations, UNORM16 for others.
+			Float32		= 1,	// Not quantized, and all the keys are kept.
+		};
+		struct TrackEncoding
+		{
+			KeyEncoding scale		= KeyEncoding::Quantized;
+			KeyEncoding rotation	= KeyEncoding::Quantized;
+			KeyEncoding translation	= KeyEncoding::Quantized;
+		};
+		struct CompressedTrack
+		{
+			VertexQuantization::PositionFrame	scaleFrame;
+			VertexQuantization::PositionFrame	translationFrame;
+			Channel								scale;
+			Channel								rotation;
+			Channel								translation;
+		};
+
+		static_assert( sizeof( QuantizedRotation	) == 6,  "The size is saved in the file." );
+		static_assert( sizeof( CompressedTrack		) == 72, "The size is saved in the file." );
+		static_assert( sizeof( TrackEncoding		) == 12, "The size is saved in the file." );
+
+	// region Elements
+	#pragma endregion
+
+		/// <summary>
+		/// The rotation is not need to be normalized. The decoded one is normalized.
+		/// </summary>
+		QuantizedRotation	EncodeRotation( const Donya::Quaternion &rotation );
+		Donya::Quaternion	DecodeRotation( const QuantizedRotation &rotation );
+
+		struct CompressedClip
+		{
+			std::string											name{};
+			float												samplingRate{};	// Frames per second.
+			float												duration{};		// Seconds.
+			std::uint32_t										frameCount{};	// The last frame is at the duration.
+			Report												report{};
+			std::vector<CompressedTrack>						tracks{};		// Per bone of the skeleton.
+			std::vector<TrackEncoding>							encodings{};	// Parallel to the tracks.
+			// The frame index of each key, it is parallel to the key array. The first key of a channel is at frame zero, and the frames are increasing.
+			std::vector<std::uint16_t>							scaleFrames{};
+			std::vector<std::uint16_t>							rotationFrames{};
+			std::vector<std::uint16_t>							translationFrames{};
+			std::vector<VertexQuantization::QuantizedPosition>	scales{};
+			std::vector<QuantizedRotation>						rotations{};
+			std::vector<VertexQuantization::QuantizedPosition>	translations{};
+			// The keys of the Float32 channels.
+			std::vector<Donya::Vector3>							rawScales{};
+			std::vector<Donya::Vector4>							rawRotations{};
+			std::vector<Donya::Vector3>							rawTranslations{};
+		public:
+			/// <summary>
+			/// Samples the local transforms of all bones at the time into pOutputPose[0 ~ tracks.size()), as same as Animation::Clip::Sample().<para></para>
+			/// It does not allocate, the keys are found by the binary search in each channel.
+			/// </summary>
+			void	Sample( float seconds, bool isLooping, Animation::Transform *pOutputPose ) const;
+			/// <summary>
+			/// Returns false if some channel is out of the key arrays or its frames are broken. The Sample() expects it is valid.
+			/// </summary>
+			bool	IsValid() const;
+			/// <summary>
+			/// The bytes of the tracks and keys.
+			/// </summary>
+			size_t	GetByteSize() const;
+		};
+
+		/// <summary>
+		/// Returns false if the clip has too many frames.
+		/// </summary>
+		bool CanCompress( const Animation::Clip &clip );
+		/// <summary>
+		/// Quantizes the keys, then drops the keys that the interpolation of kept neighbors can reproduce within the tolerance.<para></para>
+		/// The errors are measured by decoding, not estimated. The channel that can not be kept within the tolerance by quantization is stored as Float32 with all the keys.
+		/// </summary>
+		CompressedClip Compress( const Animation::Clip &clip, const Tolerance &tolerance );
+		/// <summary>
+		/// Restores the keys of every frame by the interpolation of kept keys, so the result has the same key counts as the source of Compress().<para></para>
+		/// The clip must be valid(see CompressedClip::IsValid()).
+		/// </summary>
+		Animation::Clip Decompress( const CompressedClip &clip );
+	}
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vector>
+
+namespace Donya
+{
+	/// <summary>
+	/// The read-only view of contiguous elements. This does not own the elements.<para></para>
+	/// The owner(e.g. std::vector, memory-mapped file) must be alive while using this.
+	/// </summary>
+	template<typename T>
+	class ArrayView
+	{
+	private:
+		const T	*pData;
+		size_t	count;
+	public:
+		ArrayView() : pData( nullptr ), count( 0 ) {}
+		ArrayView( const T *pData, size_t count ) : pData( pData ), count( count ) {}
+		ArrayView( const std::vector<T> &source ) : pData( source.data() ), count( source.size() ) {}
+	public:
+		const T	*data()		const { return pData;			}
+		size_t	size()		const { return count;			}
+		bool	empty()		const { return !count;			}
+		const T	*begin()	const { return pData;			}
+		const T	*end()		const { return pData + count;	}
+		const T	&operator[]( size_t index ) const { return pData[index]; }
+	public:
+		/// <summary>
+		/// Copy the elements into new std::vector.
+		/// </summary>
+		std::vector<T> ToVector() const { return std::vector<T>( begin(), end() ); }
+	};
+}
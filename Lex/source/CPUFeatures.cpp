@@ -0,0 +1,47 @@
+#include "CPUFeatures.h"
+
+#include <intrin.h>
+
+namespace Donya
+{
+	bool IsBitSet( int value, int bit )
+	{
+		return ( ( value >> bit ) & 1 ) != 0;
+	}
+
+	CPUFeatures DetectCPUFeatures()
+	{
+		CPUFeatures features{};
+
+		// The registers of CPUID are EAX, EBX, ECX, EDX.
+		int registers[4]{};
+		__cpuid( registers, 0 );
+		const int maxLeaf = registers[0];
+		if ( maxLeaf < 1 ) { return features; }
+		// else
+
+		__cpuid( registers, 1 );
+		features.sse2	= IsBitSet( registers[3], 26 );
+		features.sse41	= IsBitSet( registers[2], 19 );
+
+		// The AVX needs the OS to save the XMM and the YMM registers at the context switch.
+		const bool useXSAVE		= IsBitSet( registers[2], 27 );
+		const bool enableYMM	= useXSAVE && ( ( _xgetbv( 0 ) & 0x6 ) == 0x6 );
+		features.avx	= enableYMM && IsBitSet( registers[2], 28 );
+		features.fma	= enableYMM && IsBitSet( registers[2], 12 );
+
+		if ( 7 <= maxLeaf )
+		{
+			__cpuidex( registers, 7, 0 );
+			features.avx2 = features.avx && IsBitSet( registers[1], 5 );
+		}
+
+		return features;
+	}
+
+	const CPUFeatures &GetCPUFeatures()
+	{
+		static const CPUFeatures features = DetectCPUFeatures();
+		return features;
+	}
+}
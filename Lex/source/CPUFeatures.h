@@ -0,0 +1,21 @@
+#pragma once
+
+namespace Donya
+{
+	/// <summary>
+	/// The instruction sets that the running CPU(and the OS) supports. These are used to choose the SIMD kernels at run time.
+	/// </summary>
+	struct CPUFeatures
+	{
+		bool sse2	= false;
+		bool sse41	= false;
+		bool avx	= false;	// It is false if the OS does not save the YMM registers, even if the CPU supports it.
+		bool avx2	= false;
+		bool fma	= false;
+	};
+
+	/// <summary>
+	/// Detects by CPUID at the first call, then returns the cached result.
+	/// </summary>
+	const CPUFeatures &GetCPUFeatures();
+}
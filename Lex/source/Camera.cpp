@@ -101,6 +101,31 @@ XMMATRIX Camera::GetProjectionMatrix() const
 	return XMLoadFloat4x4( &projection );
 }
 
+bool Camera::CalcRayFromScreen( const Donya::Vector2 &screenPos, Donya::Vector3 *pOutputOrigin, Donya::Vector3 *pOutputDirection ) const
+{
+	XMVECTOR determinant{};
+	const XMMATRIX inverseVP = XMMatrixInverse( &determinant, CalcViewMatrix() * GetProjectionMatrix() );
+	if ( ZeroEqual( XMVectorGetX( determinant ) ) ) { return false; }
+	// else
+
+	// The screen position to NDC, the Y-axis is flipped.
+	const float ndcX = ( screenPos.x / Common::HalfScreenWidthF()  ) - 1.0f;
+	const float ndcY = 1.0f - ( screenPos.y / Common::HalfScreenHeightF() );
+
+	Donya::Vector3 nearPos{};
+	Donya::Vector3 farPos{};
+	XMStoreFloat3( &nearPos,	XMVector3TransformCoord( XMVectorSet( ndcX, ndcY, 0.0f, 1.0f ), inverseVP ) );
+	XMStoreFloat3( &farPos,		XMVector3TransformCoord( XMVectorSet( ndcX, ndcY, 1.0f, 1.0f ), inverseVP ) );
+
+	Donya::Vector3 direction = farPos - nearPos;
+	if ( ZeroEqual( direction.LengthSq() ) ) { return false; }
+	// else
+
+	*pOutputOrigin		= nearPos;
+	*pOutputDirection	= direction.Normalize();
+	return true;
+}
+
 void Camera::Update( const Donya::Vector3 &targetPos )
 {
 	MouseUpdate();
@@ -56,6 +56,11 @@ public:
 	DirectX::XMMATRIX CalcViewMatrix() const;
 	DirectX::XMMATRIX GetProjectionMatrix() const;
 	Donya::Vector3 GetPos() const { return pos; }
+	/// <summary>
+	/// Makes the ray that passes through the screen position(the origin is left-top of client area, pixel unit) by unprojecting with the inverse of view-projection.<para></para>
+	/// The origin is on the near plane, the direction is normalized. Returns false if the matrix can not be inverted, then the outputs are not changed.
+	/// </summary>
+	bool CalcRayFromScreen( const Donya::Vector2 &screenPos, Donya::Vector3 *pOutputOrigin, Donya::Vector3 *pOutputDirection ) const;
 public:
 	void Update( const Donya::Vector3 &targetPos );	// You can set nullptr.
 private:
@@ -38,17 +38,21 @@ HRESULT CreateVertexBuffer( ID3D11Device *pDevice, const std::vector<Vertex> &ve
 
 /// <summary>
 /// Settings detail:<para></para>
-/// BUFFER_DESC::ByteWidth = sizeof( unsigned int ) * indices.size()<para></para>
+/// BUFFER_DESC::ByteWidth = sizeof( Index ) * indexCount<para></para>
 /// BUFFER_DESC::Usage = D3D11_USAGE_IMMUTABLE<para></para>
 /// BUFFER_DESC::BindFlags = D3D11_BIND_INDEX_BUFFER<para></para>
 /// BUFFER_DESC::CPUAccessFlags = 0<para></para>
 /// BUFFER_DESC::MiscFlags = 0;<para></para>
 /// BUFFER_DESC::StructureByteStride = 0;<para></para>
+/// The Index must be 16-bit(bind as DXGI_FORMAT_R16_UINT) or 32-bit(bind as DXGI_FORMAT_R32_UINT).
 /// </summary>
-HRESULT CreateIndexBuffer( ID3D11Device *pDevice, const std::vector<unsigned int> &indices, ID3D11Buffer **bufferAddress )
+template<typename Index>
+HRESULT CreateIndexBuffer( ID3D11Device *pDevice, const Index *pIndices, size_t indexCount, ID3D11Buffer **bufferAddress )
 {
+	static_assert( sizeof( Index ) == 2 || sizeof( Index ) == 4, "The index buffer supports only 16-bit or 32-bit index." );
+
 	D3D11_BUFFER_DESC bufferDesc{};
-	bufferDesc.ByteWidth			= sizeof( unsigned int ) * indices.size();
+	bufferDesc.ByteWidth			= sizeof( Index ) * indexCount;
 	bufferDesc.Usage				= D3D11_USAGE_IMMUTABLE;
 	bufferDesc.BindFlags			= D3D11_BIND_INDEX_BUFFER;
 	bufferDesc.CPUAccessFlags		= 0;
@@ -56,7 +60,7 @@ HRESULT CreateIndexBuffer( ID3D11Device *pDevice, const std::vector<unsigned int
 	bufferDesc.StructureByteStride	= 0;
 
 	D3D11_SUBRESOURCE_DATA subResource{};
-	subResource.pSysMem				= indices.data();
+	subResource.pSysMem				= pIndices;
 	subResource.SysMemPitch			= 0;
 	subResource.SysMemSlicePitch	= 0;
 
@@ -68,6 +72,12 @@ HRESULT CreateIndexBuffer( ID3D11Device *pDevice, const std::vector<unsigned int
 	);
 }
 
+template<typename Index>
+HRESULT CreateIndexBuffer( ID3D11Device *pDevice, const std::vector<Index> &indices, ID3D11Buffer **bufferAddress )
+{
+	return CreateIndexBuffer( pDevice, indices.data(), indices.size(), bufferAddress );
+}
+
 /// <summary>
 /// Settings detail:<para></para>
 /// BUFFER_DESC::ByteWidth = sizeOfConstantBuffer<para></para>
@@ -0,0 +1,104 @@
+#include "Frustum.h"
+
+#include <cmath>
+
+#include "Common.h"
+
+using namespace DirectX;
+
+namespace Donya
+{
+	XMFLOAT4 NormalizePlane( const XMFLOAT4 &plane )
+	{
+		const float length = sqrtf( plane.x * plane.x + plane.y * plane.y + plane.z * plane.z );
+		if ( ZeroEqual( length ) ) { return plane; }
+		// else
+
+		const float inverse = 1.0f / length;
+		return XMFLOAT4{ plane.x * inverse, plane.y * inverse, plane.z * inverse, plane.w * inverse };
+	}
+
+	Frustum Frustum::FromMatrix( const XMFLOAT4X4 &m )
+	{
+		// Gribb and Hartmann. The clip position is "v * m", so the columns of "m" make the planes.
+		const XMFLOAT4 column1{ m._11, m._21, m._31, m._41 };
+		const XMFLOAT4 column2{ m._12, m._22, m._32, m._42 };
+		const XMFLOAT4 column3{ m._13, m._23, m._33, m._43 };
+		const XMFLOAT4 column4{ m._14, m._24, m._34, m._44 };
+
+		auto Add = []( const XMFLOAT4 &L, const XMFLOAT4 &R ) { return XMFLOAT4{ L.x + R.x, L.y + R.y, L.z + R.z, L.w + R.w }; };
+		auto Sub = []( const XMFLOAT4 &L, const XMFLOAT4 &R ) { return XMFLOAT4{ L.x - R.x, L.y - R.y, L.z - R.z, L.w - R.w }; };
+
+		Frustum frustum{};
+		frustum.planes[Left]	= NormalizePlane( Add( column4, column1 ) );	// -w <= x
+		frustum.planes[Right]	= NormalizePlane( Sub( column4, column1 ) );	//  x <= w
+		frustum.planes[Bottom]	= NormalizePlane( Add( column4, column2 ) );	// -w <= y
+		frustum.planes[Top]		= NormalizePlane( Sub( column4, column2 ) );	//  y <= w
+		frustum.planes[Near]	= NormalizePlane( column3 );					//  0 <= z
+		frustum.planes[Far]		= NormalizePlane( Sub( column4, column3 ) );	//  z <= w
+		return frustum;
+	}
+
+	Frustum Frustum::Transformed( const XMFLOAT4X4 &m ) const
+	{
+		// The point "p" of other space is "p * m" in this space, so the plane of other space is "m * plane".
+		Frustum transformed{};
+		for ( size_t i = 0; i < PlaneCount; ++i )
+		{
+			const XMFLOAT4 &p = planes[i];
+			const XMFLOAT4 plane
+			{
+				m._11 * p.x + m._12 * p.y + m._13 * p.z + m._14 * p.w,
+				m._21 * p.x + m._22 * p.y + m._23 * p.z + m._24 * p.w,
+				m._31 * p.x + m._32 * p.y + m._33 * p.z + m._34 * p.w,
+				m._41 * p.x + m._42 * p.y + m._43 * p.z + m._44 * p.w
+			};
+			transformed.planes[i] = NormalizePlane( plane );
+		}
+		return transformed;
+	}
+
+	void Frustum::TestSpheres( const XMFLOAT4 *pSpheres, size_t sphereCount, std::uint8_t *pOutputVisibles ) const
+	{
+		for ( size_t i = 0; i < sphereCount; i += 4 )
+		{
+			const size_t batchCount = ( sphereCount - i < 4 ) ? sphereCount - i : 4;
+
+			// The rows are the spheres, then transposing makes the rows x, y, z, radius of the four spheres.
+			XMFLOAT4 batch[4]{};
+			for ( size_t k = 0; k < batchCount; ++k )
+			{
+				batch[k] = pSpheres[i + k];
+			}
+			const XMMATRIX soa = XMMatrixTranspose
+			(
+				XMMATRIX
+				(
+					XMLoadFloat4( &batch[0] ),
+					XMLoadFloat4( &batch[1] ),
+					XMLoadFloat4( &batch[2] ),
+					XMLoadFloat4( &batch[3] )
+				)
+			);
+			const XMVECTOR negativeRadius = XMVectorNegate( soa.r[3] );
+
+			XMVECTOR visible = XMVectorTrueInt();
+			for ( const auto &plane : planes )
+			{
+				XMVECTOR distance = XMVectorReplicate( plane.w );
+				distance = XMVectorMultiplyAdd( soa.r[0], XMVectorReplicate( plane.x ), distance );
+				distance = XMVectorMultiplyAdd( soa.r[1], XMVectorReplicate( plane.y ), distance );
+				distance = XMVectorMultiplyAdd( soa.r[2], XMVectorReplicate( plane.z ), distance );
+				visible  = XMVectorAndInt( visible, XMVectorGreaterOrEqual( distance, negativeRadius ) );
+			}
+
+			XMUINT4 results{};
+			XMStoreUInt4( &results, visible );
+			const std::uint32_t resultArray[4]{ results.x, results.y, results.z, results.w };
+			for ( size_t k = 0; k < batchCount; ++k )
+			{
+				pOutputVisibles[i + k] = ( resultArray[k] ) ? 1 : 0;
+			}
+		}
+	}
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <DirectXMath.h>
+
+namespace Donya
+{
+	/// <summary>
+	/// The six planes of a view frustum. The plane is (a, b, c, d), the point is inside if "ax + by + cz + d" is greater than or equal to zero.<para></para>
+	/// The normals(a, b, c) are normalized, so the "ax + by + cz + d" is the signed distance.
+	/// </summary>
+	struct Frustum
+	{
+		enum Plane
+		{
+			Left = 0,
+			Right,
+			Bottom,
+			Top,
+			Near,
+			Far,
+
+			PlaneCount
+		};
+		std::array<DirectX::XMFLOAT4, PlaneCount> planes;
+	public:
+		/// <summary>
+		/// Extracts the planes from the matrix that transforms a row vector into the clip space of Direct3D(the depth is 0.0f ~ 1.0f).<para></para>
+		/// The planes are in the source space of the matrix, e.g. the view-projection gives the planes in world space.
+		/// </summary>
+		static Frustum FromMatrix( const DirectX::XMFLOAT4X4 &matrix );
+	public:
+		/// <summary>
+		/// Returns the frustum in the other space. The "toThisSpace" transforms a row vector from the other space into the space of this frustum.
+		/// </summary>
+		Frustum Transformed( const DirectX::XMFLOAT4X4 &toThisSpace ) const;
+		/// <summary>
+		/// Tests the spheres(xyz is the center, w is the radius) by four at once with SIMD.<para></para>
+		/// The pOutputVisibles[i] is 1 if the sphere[i] intersects or is inside of the frustum, otherwise 0.
+		/// </summary>
+		void TestSpheres( const DirectX::XMFLOAT4 *pSpheres, size_t sphereCount, std::uint8_t *pOutputVisibles ) const;
+	};
+}
@@ -0,0 +1,118 @@
+#include "ImportCache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <Windows.h>
+
+#include "Common.h"
+#include "MappedFile.h"
+#include "NativeMesh.h"
+
+namespace Donya
+{
+	namespace ImportCache
+	{
+		constexpr std::uint64_t FNV_OFFSET_BASIS	= 14695981039346656037ULL;
+		constexpr std::uint64_t FNV_PRIME			= 1099511628211ULL;
+
+		/// <summary>
+		/// FNV-1a, but mixes 8 bytes at a time. It is much faster than byte-wise one for the large file.
+		/// </summary>
+		std::uint64_t HashBytes( const void *pData, size_t byteSize, std::uint64_t hash = FNV_OFFSET_BASIS )
+		{
+			const unsigned char *pBytes = static_cast<const unsigned char *>( pData );
+
+			const size_t wordCount = byteSize / sizeof( std::uint64_t );
+			for ( size_t i = 0; i < wordCount; ++i )
+			{
+				std::uint64_t word{};
+				memcpy( &word, pBytes + i * sizeof( std::uint64_t ), sizeof( std::uint64_t ) );
+
+				hash ^= word;
+				hash *= FNV_PRIME;
+			}
+			for ( size_t i = wordCount * sizeof( std::uint64_t ); i < byteSize; ++i )
+			{
+				hash ^= scast<std::uint64_t>( pBytes[i] );
+				hash *= FNV_PRIME;
+			}
+
+			return hash;
+		}
+		template<typename T>
+		std::uint64_t HashValue( const T &value, std::uint64_t hash )
+		{
+			return HashBytes( &value, sizeof( T ), hash );
+		}
+
+		bool MakeFingerprint( const std::string &filePath, Fingerprint *pOutput )
+		{
+			if ( !pOutput ) { return false; }
+			// else
+
+			constexpr DWORD FILE_PATH_LENGTH = 512U;
+			char fullPath[FILE_PATH_LENGTH]{};
+			const DWORD writeLength = GetFullPathNameA( filePath.c_str(), FILE_PATH_LENGTH, fullPath, nullptr );
+			if ( !writeLength || FILE_PATH_LENGTH <= writeLength ) { return false; }
+			// else
+
+			WIN32_FILE_ATTRIBUTE_DATA attributes{};
+			if ( !GetFileAttributesExA( fullPath, GetFileExInfoStandard, &attributes ) ) { return false; }
+			// else
+
+			MappedFile file{};
+			if ( !file.Open( std::string{ fullPath } ) ) { return false; }
+			// else
+
+			pOutput->absFilePath	= fullPath;
+			pOutput->fileSize		= ( scast<std::uint64_t>( attributes.nFileSizeHigh ) << 32 ) | attributes.nFileSizeLow;
+			pOutput->lastWriteTime	= ( scast<std::uint64_t>( attributes.ftLastWriteTime.dwHighDateTime ) << 32 ) | attributes.ftLastWriteTime.dwLowDateTime;
+			pOutput->contentHash	= HashBytes( file.GetData(), file.GetSize() );
+
+			return true;
+		}
+
+		static std::mutex	directoryMutex{};
+		static std::string	cacheDirectory{ "./ImportCache/" };
+
+		void		SetCacheDirectory( const std::string &directory )
+		{
+			std::lock_guard<std::mutex> lock( directoryMutex );
+			cacheDirectory = directory;
+		}
+		std::string	GetCacheDirectory()
+		{
+			std::lock_guard<std::mutex> lock( directoryMutex );
+			return cacheDirectory;
+		}
+
+		std::string MakeEntryPath( const Fingerprint &fingerprint, std::uint32_t importOptionsKey, std::uint32_t quantizationOptionsKey )
+		{
+			// The entry is invalidated when the source file, the options or the format of entry is changed.
+			std::uint64_t key = HashBytes( fingerprint.absFilePath.data(), fingerprint.absFilePath.size() );
+			key = HashValue( fingerprint.fileSize,		key );
+			key = HashValue( fingerprint.lastWriteTime,	key );
+			key = HashValue( fingerprint.contentHash,	key );
+			key = HashValue( importOptionsKey,			key );
+			key = HashValue( quantizationOptionsKey,	key );
+			key = HashValue( IMPORTER_VERSION,			key );
+
+			key = HashValue( NativeMesh::VERSION,		key );
+
+			char keyString[17]{};
+			sprintf_s( keyString, "%016llX", scast<unsigned long long>( key ) );
+
+			return GetCacheDirectory() + keyString + ".nmesh";
+		}
+
+		bool PrepareCacheDirectory()
+		{
+			const std::string directory = GetCacheDirectory();
+			if ( CreateDirectoryA( directory.c_str(), nullptr ) ) { return true; }
+			// else
+			return ( GetLastError() == ERROR_ALREADY_EXISTS );
+		}
+	}
+}
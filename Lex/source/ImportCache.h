@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace Donya
+{
+	/// <summary>
+	/// The cache of imported results, that is keyed by the fingerprint of the source file.<para></para>
+	/// The entries are the native mesh files(.nmesh) in the cache directory.
+	/// </summary>
+	namespace ImportCache
+	{
+		/// <summary>
+		/// Increase this when the result of import is changed(e.g. the vertex welding, the optimization),
+		/// then the old entries will not be hit.
+		/// </summary>
+		constexpr std::uint32_t IMPORTER_VERSION = 9;
+
+		struct Fingerprint
+		{
+			std::string		absFilePath;
+			std::uint64_t	fileSize{};
+			std::uint64_t	lastWriteTime{};	// FILETIME.
+			std::uint64_t	contentHash{};		// FNV-1a of the whole file.
+		};
+
+		/// <summary>
+		/// Returns false if the file can not be read.
+		/// </summary>
+		bool MakeFingerprint( const std::string &filePath, Fingerprint *pOutput );
+
+		/// <summary>
+		/// The directory is '/' terminated. Default is "./ImportCache/".
+		/// </summary>
+		void		SetCacheDirectory( const std::string &directory );
+		std::string	GetCacheDirectory();
+
+		/// <summary>
+		/// Returns the path of the cache entry of the fingerprint and the options. The file may not exist.
+		/// </summary>
+		std::string MakeEntryPath( const Fingerprint &fingerprint, std::uint32_t importOptionsKey, std::uint32_t quantizationOptionsKey );
+
+		/// <summary>
+		/// Create the cache directory if not exists. Returns false if failed.
+		/// </summary>
+		bool PrepareCacheDirectory();
+	}
+}
@@ -1,7 +1,13 @@
 #include "Loader.h"
 
+#include <algorithm>
 #include <array>
+#include <cfloat>
+#include <cmath>
 #include <crtdbg.h>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
 #include <Windows.h>
 
 #if USE_FBX_SDK
@@ -10,6 +16,9 @@
 
 #include "Benchmark.h"
 #include "Common.h"
+#include "ImportCache.h"
+#include "MeshSimplifier.h"
+#include "NativeMesh.h"
 #include "Useful.h"
 
 #undef min
@@ -23,7 +32,7 @@ namespace Donya
 {
 	Loader::Loader() :
 		absFilePath(), fileName(), fileDirectory(),
-		meshes()
+		meshes(), skeleton(), clips(), importOptions(), quantizationOptions(), quantizationReports(), compressedClips(), optimizationStatistics(), pNativeFile(), nativeViews()
 	{
 
 	}
@@ -33,10 +42,84 @@ namespace Donya
 		meshes.shrink_to_fit();
 	}
 
-	std::mutex Loader::cerealMutex{};
+	Loader::Bounds Loader::Bounds::MakeEmpty()
+	{
+		Bounds empty{};
+		empty.min = Donya::Vector3{  FLT_MAX,  FLT_MAX,  FLT_MAX };
+		empty.max = Donya::Vector3{ -FLT_MAX, -FLT_MAX, -FLT_MAX };
+		return empty;
+	}
+	Loader::Bounds Loader::Bounds::Merge( const Bounds &lhs, const Bounds &rhs )
+	{
+		if ( lhs.IsEmpty() ) { return rhs; }
+		if ( rhs.IsEmpty() ) { return lhs; }
+		// else
+
+		Bounds merged{};
+		merged.min.x	= std::min( lhs.min.x, rhs.min.x );
+		merged.min.y	= std::min( lhs.min.y, rhs.min.y );
+		merged.min.z	= std::min( lhs.min.z, rhs.min.z );
+		merged.max.x	= std::max( lhs.max.x, rhs.max.x );
+		merged.max.y	= std::max( lhs.max.y, rhs.max.y );
+		merged.max.z	= std::max( lhs.max.z, rhs.max.z );
+		merged.center	= ( merged.min + merged.max ) * 0.5f;
+		merged.radius	= std::max
+		(
+			( lhs.center - merged.center ).Length() + lhs.radius,
+			( rhs.center - merged.center ).Length() + rhs.radius
+		);
+		return merged;
+	}
+
+	std::uint32_t Loader::ImportOptions::MakeKey() const
+	{
+		std::uint32_t key = 0;
+		if ( splitLargeMesh			) { key |= 1U << 0; }
+		if ( optimizeVertexCache	) { key |= 1U << 1; }
+
+		// The LOD errors and the sampling rate are mixed into the upper bits by FNV-1a.
+		std::uint32_t hash = 2166136261U;
+		auto HashFloat = [&hash]( float value )
+		{
+			unsigned char bytes[sizeof( float )]{};
+			memcpy( bytes, &value, sizeof( float ) );
+			for ( const auto &byte : bytes )
+			{
+				hash ^= byte;
+				hash *= 16777619U;
+			}
+		};
+		for ( const auto &it : lodErrors )
+		{
+			HashFloat( it );
+		}
+		HashFloat( animationSamplingRate );
+		return key | ( hash << 2 );
+	}
+	std::uint32_t Loader::QuantizationOptions::MakeKey() const
+	{
+		if ( !enable ) { return 0U; }
+		// else
+
+		// FNV-1a of the tolerances. The lowest bit is always set, so it is never zero.
+		const float values[]
+		{
+			tolerance.position, tolerance.normal, tolerance.texCoord,
+			animationTolerance.rotation, animationTolerance.translation, animationTolerance.scale
+		};
+		unsigned char bytes[sizeof( values )]{};
+		memcpy( bytes, values, sizeof( values ) );
+
+		std::uint32_t key = 2166136261U;
+		for ( const auto &it : bytes )
+		{
+			key ^= it;
+			key *= 16777619U;
+		}
+		return key | 1U;
+	}
 
 #if USE_FBX_SDK
-	std::mutex Loader::fbxMutex{};
 
 	Donya::Vector2 Convert( const FBX::FbxDouble2 &source )
 	{
@@ -66,6 +149,29 @@ namespace Donya
 		};
 	}
 
+	void ConvertFloat4x4( DirectX::XMFLOAT4X4 *pOutput, const FBX::FbxAMatrix &affineMatrix )
+	{
+		for ( int r = 0; r < 4; ++r )
+		{
+			for ( int c = 0; c < 4; ++c )
+			{
+				pOutput->m[r][c] = scast<float>( affineMatrix[r][c] );
+			}
+		}
+	}
+	Animation::Transform Decompose( const FBX::FbxAMatrix &affineMatrix )
+	{
+		const FBX::FbxVector4		scale		= affineMatrix.GetS();
+		const FBX::FbxQuaternion	rotation	= affineMatrix.GetQ();
+		const FBX::FbxVector4		translation	= affineMatrix.GetT();
+
+		Animation::Transform transform{};
+		transform.scale			= Donya::Vector3{ scast<float>( scale[0] ), scast<float>( scale[1] ), scast<float>( scale[2] ) };
+		transform.rotation		= Convert( rotation );
+		transform.translation	= Donya::Vector3{ scast<float>( translation[0] ), scast<float>( translation[1] ), scast<float>( translation[2] ) };
+		return transform;
+	}
+
 	void Traverse( FBX::FbxNode *pNode, std::vector<FBX::FbxNode *> *pFetchedMeshes )
 	{
 		if ( !pNode ) { return; }
@@ -90,137 +196,1758 @@ namespace Donya
 		int end = pNode->GetChildCount();
 		for ( int i = 0; i < end; ++i )
 		{
-			Traverse( pNode->GetChild( i ), pFetchedMeshes );
+			Traverse( pNode->GetChild( i ), pFetchedMeshes );
+		}
+	}
+
+	/// <summary>
+	/// The influences of control point[c] are entries[offsets[c] ~ offsets[c + 1]).<para></para>
+	/// The clusters are visited twice(count, then fill), so the entries are allocated only once.
+	/// </summary>
+	void FetchBoneInfluences( const fbxsdk::FbxMesh *pMesh, std::vector<std::uint32_t> &offsets, std::vector<Loader::BoneInfluence> &entries )
+	{
+		const int ctrlPointCount = pMesh->GetControlPointsCount();
+
+		// The index of cluster is numbered per skin.
+		std::vector<std::pair<const FBX::FbxCluster *, int>> clusters{};
+		const int deformersCount = pMesh->GetDeformerCount( FBX::FbxDeformer::eSkin );
+		for ( int i = 0; i < deformersCount; ++i )
+		{
+			const FBX::FbxSkin *pSkin = scast<FBX::FbxSkin *>( pMesh->GetDeformer( i, FBX::FbxDeformer::eSkin ) );
+
+			const int clusterCount = pSkin->GetClusterCount();
+			for ( int j = 0; j < clusterCount; ++j )
+			{
+				clusters.emplace_back( pSkin->GetCluster( j ), j );
+			}
+		}
+
+		auto ForEachInfluence = [&clusters, &ctrlPointCount]( const auto &function )
+		{
+			for ( const auto &it : clusters )
+			{
+				const FBX::FbxCluster *pCluster = it.first;
+
+				const int		ctrlPointIndicesSize	= pCluster->GetControlPointIndicesCount();
+				const int		*ctrlPointIndices		= pCluster->GetControlPointIndices();
+				const double	*ctrlPointWeights		= pCluster->GetControlPointWeights();
+
+				if ( !ctrlPointIndicesSize || !ctrlPointIndices || !ctrlPointWeights ) { continue; }
+				// else
+
+				for ( int i = 0; i < ctrlPointIndicesSize; ++i )
+				{
+					const int ctrlPointIndex = ctrlPointIndices[i];
+					if ( ctrlPointIndex < 0 || ctrlPointCount <= ctrlPointIndex ) { continue; }
+					// else
+
+					function( ctrlPointIndex, Loader::BoneInfluence{ it.second, scast<float>( ctrlPointWeights[i] ) } );
+				}
+			}
+		};
+
+		offsets.assign( scast<size_t>( ctrlPointCount ) + 1, 0U );
+		ForEachInfluence
+		(
+			[&offsets]( int ctrlPointIndex, const Loader::BoneInfluence & )
+			{
+				++offsets[ctrlPointIndex + 1];
+			}
+		);
+		for ( int i = 0; i < ctrlPointCount; ++i )
+		{
+			offsets[i + 1] += offsets[i];
+		}
+
+		entries.resize( offsets.back() );
+		std::vector<std::uint32_t> writePositions( offsets.begin(), offsets.end() - 1 );
+		ForEachInfluence
+		(
+			[&entries, &writePositions]( int ctrlPointIndex, const Loader::BoneInfluence &influence )
+			{
+				entries[writePositions[ctrlPointIndex]++] = influence;
+			}
+		);
+	}
+
+	/// <summary>
+	/// Keeps the strongest "maxCountPerElement" influences of each element, and renormalizes those.<para></para>
+	/// The kept influences are sorted by weight in descending order. The arrays are compacted in place.
+	/// </summary>
+	void LimitBoneInfluences( std::vector<std::uint32_t> &offsets, std::vector<Loader::BoneInfluence> &entries, size_t maxCountPerElement )
+	{
+		if ( offsets.empty() ) { return; }
+		// else
+
+		const size_t elementCount = offsets.size() - 1;
+		std::uint32_t writePos = 0;
+		for ( size_t i = 0; i < elementCount; ++i )
+		{
+			const auto begin	= entries.begin() + offsets[i];
+			const auto end		= entries.begin() + offsets[i + 1];
+			std::stable_sort
+			(
+				begin, end,
+				[]( const Loader::BoneInfluence &L, const Loader::BoneInfluence &R )
+				{
+					return R.weight < L.weight;
+				}
+			);
+
+			const size_t influenceCount	= scast<size_t>( end - begin );
+			const size_t keepCount		= ( maxCountPerElement < influenceCount ) ? maxCountPerElement : influenceCount;
+
+			float sum = 0.0f;
+			for ( size_t k = 0; k < keepCount; ++k )
+			{
+				sum += begin[k].weight;
+			}
+
+			// The write position never overtakes the read position, so the compaction does not break the unread entries.
+			offsets[i] = writePos;
+			for ( size_t k = 0; k < keepCount; ++k )
+			{
+				Loader::BoneInfluence influence = begin[k];
+				if ( 0.0f < sum ) { influence.weight /= sum; }
+
+				entries[writePos++] = influence;
+			}
+		}
+
+		offsets[elementCount] = writePos;
+		entries.resize( writePos );
+		entries.shrink_to_fit();
+	}
+
+	/// <summary>
+	/// The global matrices of the bones at the binding, these are fetched from the clusters.
+	/// </summary>
+	using BindMatrixMap = std::unordered_map<const FBX::FbxNode *, FBX::FbxAMatrix>;
+
+	void FetchBindMatrices( const std::vector<FBX::FbxNode *> &meshNodes, BindMatrixMap *pOutput )
+	{
+		for ( const auto &pNode : meshNodes )
+		{
+			const FBX::FbxMesh *pMesh = pNode->GetMesh();
+			const int deformersCount = pMesh->GetDeformerCount( FBX::FbxDeformer::eSkin );
+			for ( int i = 0; i < deformersCount; ++i )
+			{
+				const FBX::FbxSkin *pSkin = scast<FBX::FbxSkin *>( pMesh->GetDeformer( i, FBX::FbxDeformer::eSkin ) );
+
+				const int clusterCount = pSkin->GetClusterCount();
+				for ( int j = 0; j < clusterCount; ++j )
+				{
+					const FBX::FbxCluster	*pCluster	= pSkin->GetCluster( j );
+					const FBX::FbxNode		*pLink		= pCluster->GetLink();
+					if ( !pLink || pOutput->find( pLink ) != pOutput->end() ) { continue; }
+					// else
+
+					FBX::FbxAMatrix linkMatrix{};
+					pCluster->GetTransformLinkMatrix( linkMatrix );
+					pOutput->emplace( pLink, linkMatrix );
+				}
+			}
+		}
+	}
+
+	/// <summary>
+	/// Collects the nodes that have the skeleton attribute or are linked by the clusters, in the depth-first order.<para></para>
+	/// The parent of a bone is the nearest ancestor that is also a bone.
+	/// </summary>
+	void CollectBones( FBX::FbxNode *pNode, int parentBone, const BindMatrixMap &bindMatrices, std::vector<FBX::FbxNode *> *pBoneNodes, std::vector<int> *pParents )
+	{
+		if ( !pNode ) { return; }
+		// else
+
+		const FBX::FbxNodeAttribute *pNodeAttr = pNode->GetNodeAttribute();
+		const bool isSkeleton	= ( pNodeAttr && pNodeAttr->GetAttributeType() == FBX::FbxNodeAttribute::eSkeleton );
+		const bool isLinked		= ( bindMatrices.find( pNode ) != bindMatrices.end() );
+
+		int boneIndex = parentBone;
+		if ( isSkeleton || isLinked )
+		{
+			boneIndex = scast<int>( pBoneNodes->size() );
+			pBoneNodes->emplace_back( pNode );
+			pParents->emplace_back( parentBone );
+		}
+
+		const int end = pNode->GetChildCount();
+		for ( int i = 0; i < end; ++i )
+		{
+			CollectBones( pNode->GetChild( i ), boneIndex, bindMatrices, pBoneNodes, pParents );
+		}
+	}
+
+	void FetchSkeleton( FBX::FbxScene *pScene, const BindMatrixMap &bindMatrices, Animation::Skeleton *pSkeleton, std::vector<FBX::FbxNode *> *pBoneNodes )
+	{
+		std::vector<int> parents{};
+		CollectBones( pScene->GetRootNode(), -1, bindMatrices, pBoneNodes, &parents );
+
+		// The bones that are not linked(e.g. the end sites) use the default transform of the node.
+		const size_t boneCount = pBoneNodes->size();
+		std::vector<FBX::FbxAMatrix> globals( boneCount );
+		for ( size_t i = 0; i < boneCount; ++i )
+		{
+			FBX::FbxNode *pNode = ( *pBoneNodes )[i];
+			const auto found = bindMatrices.find( pNode );
+			globals[i] = ( found != bindMatrices.end() )
+			? found->second
+			: pNode->EvaluateGlobalTransform( FBXSDK_TIME_INFINITE );
+		}
+
+		pSkeleton->bones.resize( boneCount );
+		for ( size_t i = 0; i < boneCount; ++i )
+		{
+			auto &bone = pSkeleton->bones[i];
+			bone.name	= ( *pBoneNodes )[i]->GetName();
+			bone.parent	= parents[i];
+
+			const FBX::FbxAMatrix local = ( 0 <= bone.parent ) ? globals[bone.parent].Inverse() * globals[i] : globals[i];
+			bone.bindPose = Decompose( local );
+		}
+	}
+
+	/// <summary>
+	/// The binding[j] is made from the cluster[j] of each skin, as the FetchBoneInfluences() numbers the influences.
+	/// </summary>
+	void FetchBoneBindings( const FBX::FbxMesh *pMesh, const std::unordered_map<const FBX::FbxNode *, int> &boneIndices, std::vector<Loader::BoneBinding> *pOutput )
+	{
+		pOutput->clear();
+
+		const int deformersCount = pMesh->GetDeformerCount( FBX::FbxDeformer::eSkin );
+		for ( int i = 0; i < deformersCount; ++i )
+		{
+			const FBX::FbxSkin *pSkin = scast<FBX::FbxSkin *>( pMesh->GetDeformer( i, FBX::FbxDeformer::eSkin ) );
+
+			const int clusterCount = pSkin->GetClusterCount();
+			if ( pOutput->size() < scast<size_t>( clusterCount ) ) { pOutput->resize( clusterCount ); }
+
+			for ( int j = 0; j < clusterCount; ++j )
+			{
+				const FBX::FbxCluster *pCluster = pSkin->GetCluster( j );
+
+				Loader::BoneBinding binding{};
+				const auto found = boneIndices.find( pCluster->GetLink() );
+				if ( found != boneIndices.end() ) { binding.boneIndex = found->second; }
+
+				// The vertex is moved into the global space at the binding, then into the space of bone.
+				FBX::FbxAMatrix meshMatrix{};
+				FBX::FbxAMatrix linkMatrix{};
+				pCluster->GetTransformMatrix( meshMatrix );
+				pCluster->GetTransformLinkMatrix( linkMatrix );
+				ConvertFloat4x4( &binding.inverseBindMatrix, linkMatrix.Inverse() * meshMatrix );
+
+				( *pOutput )[j] = binding;
+			}
+		}
+	}
+
+	/// <summary>
+	/// The SkinnedMesh::Vertex can have the influence indices only in [0, 255].
+	/// A skin often has the clusters of all bones even if most of those do not influence any vertex,
+	/// so if the mesh has bindings over that, I remove the unused bindings and renumber the influences by the remaining ones.
+	/// </summary>
+	void CompactBoneBindings( Loader::Mesh *pMesh )
+	{
+		constexpr size_t MAX_PACKABLE_COUNT = UINT8_MAX + 1;
+		if ( pMesh->bindings.size() <= MAX_PACKABLE_COUNT ) { return; }
+		// else
+
+		constexpr int UNUSED = -1;
+		std::vector<int> remap( pMesh->bindings.size(), UNUSED );
+		for ( const auto &influence : pMesh->influenceEntries )
+		{
+			if ( influence.index < 0 || pMesh->bindings.size() <= scast<size_t>( influence.index ) ) { continue; }
+			// else
+			remap[influence.index] = 0;
+		}
+
+		std::vector<Loader::BoneBinding> usedBindings{};
+		for ( size_t i = 0; i < remap.size(); ++i )
+		{
+			if ( remap[i] == UNUSED ) { continue; }
+			// else
+
+			remap[i] = scast<int>( usedBindings.size() );
+			usedBindings.emplace_back( pMesh->bindings[i] );
+		}
+
+		for ( auto &influence : pMesh->influenceEntries )
+		{
+			influence.index = ( influence.index < 0 || remap.size() <= scast<size_t>( influence.index ) ) ? UNUSED : remap[influence.index];
+		}
+		pMesh->bindings = std::move( usedBindings );
+	}
+
+	/// <summary>
+	/// Leaves only the first key if all the keys are same, the Clip::Sample() treats it as constant.
+	/// </summary>
+	template<typename VectorType>
+	void RemoveConstantKeys( std::vector<VectorType> *pKeys )
+	{
+		constexpr float		TOLERANCE		= 1.0e-6f;
+		constexpr size_t	COMPONENT_COUNT	= sizeof( VectorType ) / sizeof( float );
+		if ( pKeys->size() < 2 ) { return; }
+		// else
+
+		const float *pFront = &pKeys->front().x;
+		for ( const auto &key : *pKeys )
+		{
+			const float *pKey = &key.x;
+			for ( size_t c = 0; c < COMPONENT_COUNT; ++c )
+			{
+				if ( TOLERANCE < fabsf( pKey[c] - pFront[c] ) ) { return; }
+			}
+		}
+
+		pKeys->resize( 1 );
+		pKeys->shrink_to_fit();
+	}
+
+	/// <summary>
+	/// Resamples each FbxAnimStack at the fixed rate into a clip. The local transforms are relative to the parent bone,
+	/// so the nodes between the bones(that are not bone) are baked into those.
+	/// </summary>
+	void FetchAnimationClips( FBX::FbxScene *pScene, const std::vector<FBX::FbxNode *> &boneNodes, const Animation::Skeleton &skeleton, float samplingRate, std::vector<Animation::Clip> *pOutput )
+	{
+		pOutput->clear();
+		if ( boneNodes.empty() || samplingRate <= 0.0f ) { return; }
+		// else
+
+		const size_t boneCount = boneNodes.size();
+		std::vector<FBX::FbxAMatrix> globals( boneCount );
+
+		const int stackCount = pScene->GetSrcObjectCount<FBX::FbxAnimStack>();
+		for ( int s = 0; s < stackCount; ++s )
+		{
+			FBX::FbxAnimStack *pStack = pScene->GetSrcObject<FBX::FbxAnimStack>( s );
+			if ( !pStack ) { continue; }
+			// else
+
+			pScene->SetCurrentAnimationStack( pStack );
+
+			// The span of take info is written by the exporter, so it is preferred.
+			FBX::FbxTimeSpan span = pStack->GetLocalTimeSpan();
+			const FBX::FbxTakeInfo *pTakeInfo = pScene->GetTakeInfo( pStack->GetName() );
+			if ( pTakeInfo ) { span = pTakeInfo->mLocalTimeSpan; }
+
+			const double start		= span.GetStart().GetSecondDouble();
+			const double length		= std::max( 0.0, span.GetDuration().GetSecondDouble() );
+			const size_t keyCount	= scast<size_t>( floor( length * samplingRate + 0.5 ) ) + 1;
+
+			Animation::Clip clip{};
+			clip.name			= pStack->GetName();
+			clip.samplingRate	= samplingRate;
+			clip.duration		= scast<float>( keyCount - 1 ) / samplingRate;
+			clip.tracks.resize( boneCount );
+			for ( auto &track : clip.tracks )
+			{
+				track.scales.resize( keyCount );
+				track.rotations.resize( keyCount );
+				track.translations.resize( keyCount );
+			}
+
+			for ( size_t k = 0; k < keyCount; ++k )
+			{
+				FBX::FbxTime time{};
+				time.SetSecondDouble( start + scast<double>( k ) / samplingRate );
+
+				for ( size_t i = 0; i < boneCount; ++i )
+				{
+					globals[i] = boneNodes[i]->EvaluateGlobalTransform( time );
+				}
+				for ( size_t i = 0; i < boneCount; ++i )
+				{
+					const int parent = skeleton.bones[i].parent;
+					const FBX::FbxAMatrix local = ( 0 <= parent ) ? globals[parent].Inverse() * globals[i] : globals[i];
+					const Animation::Transform transform = Decompose( local );
+
+					auto &track = clip.tracks[i];
+					track.scales[k]			= transform.scale;
+					track.rotations[k]		= transform.rotation;
+					track.translations[k]	= transform.translation;
+
+					// Keep the neighbors in the same hemisphere for the linear interpolation.
+					if ( k )
+					{
+						const Donya::Vector4 &prev = track.rotations[k - 1];
+						Donya::Vector4 &current = track.rotations[k];
+						if ( prev.x * current.x + prev.y * current.y + prev.z * current.z + prev.w * current.w < 0.0f )
+						{
+							current = -current;
+						}
+					}
+				}
+			}
+
+			for ( auto &track : clip.tracks )
+			{
+				RemoveConstantKeys( &track.scales );
+				RemoveConstantKeys( &track.rotations );
+				RemoveConstantKeys( &track.translations );
+			}
+
+			pOutput->emplace_back( std::move( clip ) );
+		}
+	}
+
+	/// <summary>
+	/// Splits the mesh into the parts that have vertices less than or equal to "maxVertexCount".<para></para>
+	/// The order of triangles is kept, and the subsets are split along the parts.
+	/// </summary>
+	std::vector<Loader::Mesh> SplitByVertexCount( const Loader::Mesh &source, size_t maxVertexCount )
+	{
+		constexpr std::uint32_t UNASSIGNED = ~0U;
+		const bool hasTexCoords		= !source.texCoords.empty();
+		const bool hasInfluences	= ( source.influenceOffsets.size() == source.positions.size() + 1 );
+
+		std::vector<Loader::Mesh>	parts{};
+		std::vector<std::uint32_t>	remap( source.positions.size(), UNASSIGNED );	// Source vertex -> vertex of current part.
+		std::vector<std::uint32_t>	assignedVertices{};								// For resetting the remap.
+
+		auto StartPart = [&]()
+		{
+			for ( const auto &it : assignedVertices )
+			{
+				remap[it] = UNASSIGNED;
+			}
+			assignedVertices.clear();
+
+			Loader::Mesh part{};
+			part.coordinateConversion	= source.coordinateConversion;
+			part.globalTransform		= source.globalTransform;
+			part.bindings				= source.bindings;
+			if ( hasInfluences ) { part.influenceOffsets.assign( 1, 0U ); }
+			parts.emplace_back( std::move( part ) );
+		};
+		auto AddVertex = [&]( Loader::Mesh &part, std::uint32_t sourceIndex )
+		{
+			if ( remap[sourceIndex] != UNASSIGNED ) { return remap[sourceIndex]; }
+			// else
+
+			const std::uint32_t newIndex = scast<std::uint32_t>( part.positions.size() );
+			remap[sourceIndex] = newIndex;
+			assignedVertices.emplace_back( sourceIndex );
+
+			part.positions.emplace_back( source.positions[sourceIndex] );
+			part.normals.emplace_back( source.normals[sourceIndex] );
+			if ( hasTexCoords ) { part.texCoords.emplace_back( source.texCoords[sourceIndex] ); }
+			if ( hasInfluences )
+			{
+				part.influenceEntries.insert
+				(
+					part.influenceEntries.end(),
+					source.influenceEntries.begin() + source.influenceOffsets[sourceIndex],
+					source.influenceEntries.begin() + source.influenceOffsets[sourceIndex + 1]
+				);
+				part.influenceOffsets.emplace_back( scast<std::uint32_t>( part.influenceEntries.size() ) );
+			}
+			return newIndex;
+		};
+
+		StartPart();
+		for ( const auto &subset : source.subsets )
+		{
+			bool isSubsetOpened = false;
+
+			const size_t end = subset.indexStart + subset.indexCount;
+			for ( size_t i = subset.indexStart; i + 2 < end; i += 3 )
+			{
+				const std::uint32_t *pTriangle = &source.indices[i];
+
+				// The duplicated vertex in a triangle is counted twice, it is only conservative.
+				size_t newVertexCount = 0;
+				for ( size_t k = 0; k < 3; ++k )
+				{
+					if ( remap[pTriangle[k]] == UNASSIGNED ) { ++newVertexCount; }
+				}
+				if ( maxVertexCount < parts.back().positions.size() + newVertexCount )
+				{
+					StartPart();
+					isSubsetOpened = false;
+				}
+
+				Loader::Mesh &part = parts.back();
+				if ( !isSubsetOpened )
+				{
+					Loader::Subset partSubset = subset;
+					partSubset.indexStart = part.indices.size();
+					partSubset.indexCount = 0;
+					part.subsets.emplace_back( std::move( partSubset ) );
+					isSubsetOpened = true;
+				}
+
+				for ( size_t k = 0; k < 3; ++k )
+				{
+					part.indices.emplace_back( AddVertex( part, pTriangle[k] ) );
+				}
+				part.subsets.back().indexCount += 3;
+			}
+		}
+
+		return parts;
+	}
+
+	/// <summary>
+	/// Reorders the triangles of each subset for the post-transform vertex cache, then reorders the vertices by first use.<para></para>
+	/// The order of subsets and the ranges of those are not changed.
+	/// </summary>
+	void OptimizeForVertexCache( Loader::Mesh *pMesh, Loader::OptimizationStatistics *pStatistics )
+	{
+		namespace Optimizer = Donya::MeshOptimizer;
+
+		Loader::Mesh &mesh = *pMesh;
+		const size_t vertexCount = mesh.positions.size();
+		if ( mesh.indices.empty() || !vertexCount ) { return; }
+		// else
+
+		pStatistics->before = Optimizer::AnalyzeVertexCache( mesh.indices.data(), mesh.indices.size(), vertexCount );
+
+		for ( const auto &subset : mesh.subsets )
+		{
+			if ( mesh.indices.size() < subset.indexStart + subset.indexCount ) { continue; }
+			// else
+			Optimizer::OptimizeVertexCache( mesh.indices.data() + subset.indexStart, subset.indexCount, vertexCount );
+		}
+
+		std::vector<std::uint32_t> remap{};
+		const size_t newVertexCount = Optimizer::OptimizeVertexFetch( mesh.indices.data(), mesh.indices.size(), vertexCount, &remap );
+
+		mesh.positions = Optimizer::RemapVertices( mesh.positions, remap, newVertexCount );
+		mesh.normals   = Optimizer::RemapVertices( mesh.normals,   remap, newVertexCount );
+		if ( mesh.texCoords.size() == vertexCount )
+		{
+			mesh.texCoords = Optimizer::RemapVertices( mesh.texCoords, remap, newVertexCount );
+		}
+		if ( mesh.influenceOffsets.size() == vertexCount + 1 )
+		{
+			std::vector<std::uint32_t> oldVertices( newVertexCount );
+			for ( size_t v = 0; v < vertexCount; ++v )
+			{
+				if ( remap[v] == Optimizer::UNUSED_VERTEX ) { continue; }
+				// else
+				oldVertices[remap[v]] = scast<std::uint32_t>( v );
+			}
+
+			std::vector<std::uint32_t>			offsets{};
+			std::vector<Loader::BoneInfluence>	entries{};
+			offsets.reserve( newVertexCount + 1 );
+			offsets.emplace_back( 0U );
+			entries.reserve( mesh.influenceEntries.size() );
+			for ( const auto &oldVertex : oldVertices )
+			{
+				entries.insert
+				(
+					entries.end(),
+					mesh.influenceEntries.begin() + mesh.influenceOffsets[oldVertex],
+					mesh.influenceEntries.begin() + mesh.influenceOffsets[oldVertex + 1]
+				);
+				offsets.emplace_back( scast<std::uint32_t>( entries.size() ) );
+			}
+			mesh.influenceOffsets = std::move( offsets );
+			mesh.influenceEntries = std::move( entries );
+		}
+
+		pStatistics->after = Optimizer::AnalyzeVertexCache( mesh.indices.data(), mesh.indices.size(), newVertexCount );
+	}
+
+	/// <summary>
+	/// Appends the simplified indices of each level after the indices of full resolution, and records the ranges to "lods".<para></para>
+	/// The "relativeErrors" are relative to the largest extent of mesh. The level that does not reduce the triangles enough is skipped.
+	/// </summary>
+	void GenerateLODs( Loader::Mesh *pMesh, std::vector<float> relativeErrors, bool optimizeVertexCache )
+	{
+		// The level must remove at least this ratio of indices from the previous level, otherwise it is not worth the memory.
+		constexpr float MIN_REDUCTION_RATIO = 0.15f;
+
+		Loader::Mesh &mesh = *pMesh;
+		mesh.lods.clear();
+
+		const size_t vertexCount = mesh.positions.size();
+		if ( mesh.indices.empty() || !vertexCount || relativeErrors.empty() ) { return; }
+		// else
+
+		std::sort( relativeErrors.begin(), relativeErrors.end() );
+
+		// The UV seams and the hard edges are made by the vertices that share the position, so those are locked.
+		// The boundaries of subsets are kept by the simplifier, because those are the borders of each subset.
+		std::vector<std::uint8_t> locks( vertexCount, 0 );
+		{
+			auto Less = [&]( std::uint32_t lhs, std::uint32_t rhs )
+			{
+				return memcmp( &mesh.positions[lhs], &mesh.positions[rhs], sizeof( Donya::Vector3 ) ) < 0;
+			};
+
+			std::vector<std::uint32_t> order( vertexCount );
+			for ( size_t v = 0; v < vertexCount; ++v )
+			{
+				order[v] = scast<std::uint32_t>( v );
+			}
+			std::sort( order.begin(), order.end(), Less );
+
+			for ( size_t i = 1; i < vertexCount; ++i )
+			{
+				if ( Less( order[i - 1], order[i] ) ) { continue; }
+				// else
+				locks[order[i - 1]] = 1;
+				locks[order[i    ]] = 1;
+			}
+		}
+
+		Donya::Vector3 min = mesh.positions.front();
+		Donya::Vector3 max = mesh.positions.front();
+		for ( const auto &it : mesh.positions )
+		{
+			min.x = std::min( min.x, it.x );	max.x = std::max( max.x, it.x );
+			min.y = std::min( min.y, it.y );	max.y = std::max( max.y, it.y );
+			min.z = std::min( min.z, it.z );	max.z = std::max( max.z, it.z );
+		}
+		const float extent = std::max( max.x - min.x, std::max( max.y - min.y, max.z - min.z ) );
+		if ( extent <= 0.0f ) { return; }
+		// else
+
+		const size_t	baseIndexCount		= mesh.indices.size();
+		size_t			prevLevelIndexCount	= baseIndexCount;
+		for ( const auto &relativeError : relativeErrors )
+		{
+			Loader::LODLevel			level{};
+			std::vector<std::uint32_t>	levelIndices{};
+			for ( const auto &subset : mesh.subsets )
+			{
+				Loader::IndexRange range{};
+				range.indexStart = scast<std::uint32_t>( baseIndexCount + levelIndices.size() );
+				if ( subset.indexStart + subset.indexCount <= baseIndexCount )
+				{
+					float error = 0.0f;
+					std::vector<std::uint32_t> simplified = Donya::MeshSimplifier::Simplify
+					(
+						mesh.indices.data() + subset.indexStart, subset.indexCount,
+						mesh.positions.data(), vertexCount,
+						locks.data(),
+						0U, relativeError * extent,
+						&error
+					);
+					if ( optimizeVertexCache )
+					{
+						Donya::MeshOptimizer::OptimizeVertexCache( simplified.data(), simplified.size(), vertexCount );
+					}
+
+					range.indexCount	= scast<std::uint32_t>( simplified.size() );
+					level.error			= std::max( level.error, error );
+					levelIndices.insert( levelIndices.end(), simplified.begin(), simplified.end() );
+				}
+				level.subsetRanges.emplace_back( range );
+			}
+
+			if ( scast<float>( prevLevelIndexCount ) * ( 1.0f - MIN_REDUCTION_RATIO ) < scast<float>( levelIndices.size() ) ) { continue; }
+			// else
+
+			prevLevelIndexCount = levelIndices.size();
+			mesh.indices.insert( mesh.indices.end(), levelIndices.begin(), levelIndices.end() );
+			mesh.lods.emplace_back( std::move( level ) );
+		}
+	}
+
+#endif // USE_FBX_SDK
+
+	/// <summary>
+	/// Calculates the bounds of the mesh and the subsets, from the positions that the globalTransform is applied.<para></para>
+	/// The sphere is centered at the box, and the radius is the distance to the farthest position.
+	/// </summary>
+	void CalcBounds( Loader::Mesh *pMesh, const Loader::MeshView &view )
+	{
+		Loader::Mesh &mesh = *pMesh;
+		const DirectX::XMFLOAT4X4 &m = mesh.globalTransform;
+
+		const size_t vertexCount = view.positions.size();
+		std::vector<Donya::Vector3> transformed( vertexCount );
+		for ( size_t v = 0; v < vertexCount; ++v )
+		{
+			const Donya::Vector3 &p = view.positions[v];
+			transformed[v] = Donya::Vector3
+			{
+				p.x * m._11 + p.y * m._21 + p.z * m._31 + m._41,
+				p.x * m._12 + p.y * m._22 + p.z * m._32 + m._42,
+				p.x * m._13 + p.y * m._23 + p.z * m._33 + m._43
+			};
+		}
+
+		// The "ForEachVertex" calls the passed function with each vertex index.
+		auto MakeBounds = [&transformed]( const auto &ForEachVertex )
+		{
+			Loader::Bounds bounds = Loader::Bounds::MakeEmpty();
+			ForEachVertex
+			(
+				[&]( size_t v )
+				{
+					const Donya::Vector3 &p = transformed[v];
+					bounds.min.x = std::min( bounds.min.x, p.x );	bounds.max.x = std::max( bounds.max.x, p.x );
+					bounds.min.y = std::min( bounds.min.y, p.y );	bounds.max.y = std::max( bounds.max.y, p.y );
+					bounds.min.z = std::min( bounds.min.z, p.z );	bounds.max.z = std::max( bounds.max.z, p.z );
+				}
+			);
+			if ( bounds.IsEmpty() ) { return bounds; }
+			// else
+
+			bounds.center = ( bounds.min + bounds.max ) * 0.5f;
+
+			float maxDistanceSq = 0.0f;
+			ForEachVertex
+			(
+				[&]( size_t v )
+				{
+					maxDistanceSq = std::max( maxDistanceSq, ( transformed[v] - bounds.center ).LengthSq() );
+				}
+			);
+			bounds.radius = sqrtf( maxDistanceSq );
+			return bounds;
+		};
+
+		mesh.bounds = MakeBounds
+		(
+			[&]( const auto &Function )
+			{
+				for ( size_t v = 0; v < vertexCount; ++v ) { Function( v ); }
+			}
+		);
+
+		const size_t indexCount = view.GetIndexCount();
+		for ( auto &subset : mesh.subsets )
+		{
+			if ( indexCount < subset.indexStart + subset.indexCount )
+			{
+				subset.bounds = Loader::Bounds::MakeEmpty();
+				continue;
+			}
+			// else
+
+			subset.bounds = MakeBounds
+			(
+				[&]( const auto &Function )
+				{
+					const size_t end = subset.indexStart + subset.indexCount;
+					for ( size_t i = subset.indexStart; i < end; ++i )
+					{
+						const std::uint32_t v = view.GetIndex( i );
+						if ( v < vertexCount ) { Function( v ); }
+					}
+				}
+			);
+		}
+	}
+
+#define USE_IMPORT_CACHE ( true )
+
+	bool Loader::Load( const std::string &filePath, std::string *outputErrorString )
+	{
+		// The previous views will be invalid.
+		pNativeFile.reset();
+		nativeViews.clear();
+		optimizationStatistics.clear();
+		quantizationReports.clear();
+		skeleton = Animation::Skeleton{};
+		clips.clear();
+		compressedClips.clear();
+
+	#if USE_FBX_SDK
+
+		auto ShouldUseFBXSDK = []( const std::string &filePath )
+		{
+			constexpr std::array<const char *, 4> EXTENSIONS
+			{
+				".obj", ".OBJ",
+				".fbx", ".FBX"
+			};
+
+			for ( size_t i = 0; i < EXTENSIONS.size(); ++i )
+			{
+				if ( filePath.find( EXTENSIONS[i] ) != std::string::npos )
+				{
+					return true;
+				}
+			}
+
+			return false;
+		};
+
+		if ( ShouldUseFBXSDK( filePath ) )
+		{
+		#if USE_IMPORT_CACHE
+			return LoadThroughImportCache( filePath, outputErrorString );
+		#else
+			return LoadByFBXSDK( filePath, outputErrorString );
+		#endif // USE_IMPORT_CACHE
+		}
+		// else
+
+	#endif // USE_FBX_SDK
+
+		auto ShouldLoadByCereal = []( const std::string &filePath )->const char *
+		{
+			constexpr std::array<const char *, 2> EXTENSIONS
+			{
+				".bin", ".nmesh"
+			};
+
+			for ( size_t i = 0; i < EXTENSIONS.size(); ++i )
+			{
+				if ( filePath.find( EXTENSIONS[i] ) != std::string::npos )
+				{
+					return EXTENSIONS[i];
+				}
+			}
+
+			return "NOT FOUND";
+		};
+
+		auto resultExt = ShouldLoadByCereal( filePath );
+		if ( !strcmp( ".bin", resultExt ) )
+		{
+			return LoadByCereal( filePath, outputErrorString );
+		}
+		if ( !strcmp( ".nmesh", resultExt ) )
+		{
+			return LoadByNative( filePath, outputErrorString );
+		}
+
+		return false;
+	}
+
+	void Loader::SaveByCereal( const std::string &filePath ) const
+	{
+		Serializer::Extension bin  = Serializer::Extension::BINARY;
+
+		// The archives are per-instance, and the Serializer writes to an unique temporary file, so no lock is needed.
+		Serializer seria;
+		if ( IsMappedNativeFile() )
+		{
+			// The cereal can serialize only own vectors.
+			Loader materialized = Clone();
+			materialized.Materialize();
+			seria.Save( bin, filePath.c_str(),  SERIAL_ID, materialized );
+		}
+		else
+		{
+			seria.Save( bin, filePath.c_str(),  SERIAL_ID, *this );
+		}
+	}
+	
+	bool Loader::LoadByCereal( const std::string &filePath, std::string *outputErrorString )
+	{
+		Serializer::Extension ext = Serializer::Extension::BINARY;
+
+		Serializer seria;
+		if ( !seria.Load( ext, filePath.c_str(), SERIAL_ID, *this ) )
+		{
+			if ( outputErrorString != nullptr )
+			{
+				*outputErrorString = "Failed : Open the file : " + filePath;
+			}
+			return false;
+		}
+		// else
+
+		if ( !skeleton.IsValid() )
+		{
+			if ( outputErrorString != nullptr )
+			{
+				*outputErrorString = "Failed : The bone hierarchy is broken : " + filePath;
+			}
+			return false;
+		}
+		// else
+
+		// The data that saved before the bounds was introduced.
+		for ( size_t i = 0; i < meshes.size(); ++i )
+		{
+			if ( meshes[i].bounds.IsEmpty() && !meshes[i].positions.empty() )
+			{
+				CalcBounds( &meshes[i], GetMeshView( i ) );
+			}
+		}
+
+		return true;
+	}
+
+	bool Loader::SaveByNative( const std::string &filePath, std::string *outputErrorString, std::vector<VertexQuantization::Report> *pOutputReports ) const
+	{
+		// The writer does not copy the chunks, so the quantized attributes must be alive until the save is finished.
+		const std::vector<VertexQuantization::QuantizedAttributes> quantizedMeshes = QuantizeMeshes();
+		return SaveByNative( filePath, outputErrorString, pOutputReports, quantizedMeshes );
+	}
+	bool Loader::SaveByNative( const std::string &filePath, std::string *outputErrorString, std::vector<VertexQuantization::Report> *pOutputReports, const std::vector<VertexQuantization::QuantizedAttributes> &quantizedMeshes ) const
+	{
+		using NativeMesh::ChunkKind;
+		using VertexQuantization::Encoding;
+
+		const size_t meshCount = meshes.size();
+
+		const VertexQuantization::QuantizedAttributes notQuantized{};
+		std::vector<VertexQuantization::Report> reports{};
+
+		NativeMesh::Writer writer{ meshCount };
+		writer.AddStrings( ChunkKind::FileInfo, 0, { absFilePath, fileName, fileDirectory } );
+
+		for ( size_t i = 0; i < meshCount; ++i )
+		{
+			const auto		&mesh	= meshes[i];
+			const MeshView	view	= GetMeshView( i );
+
+			NativeMesh::TransformRecord transform{};
+			transform.coordinateConversion	= mesh.coordinateConversion;
+			transform.globalTransform		= mesh.globalTransform;
+			writer.AddCopiedChunk( ChunkKind::Transform, i, &transform, sizeof( NativeMesh::TransformRecord ), 1 );
+
+			// The texture names of all materials are stored into one chunk, the material records refer to a range of it.
+			std::vector<std::string> textureNames{};
+			auto ToRecord = [&textureNames]( const Material &source )
+			{
+				NativeMesh::MaterialRecord record{};
+				record.color[0]		= source.color.x;
+				record.color[1]		= source.color.y;
+				record.color[2]		= source.color.z;
+				record.color[3]		= source.color.w;
+				record.textureBegin	= scast<std::uint32_t>( textureNames.size() );
+				record.textureCount	= scast<std::uint32_t>( source.textureNames.size() );
+
+				textureNames.insert( textureNames.end(), source.textureNames.begin(), source.textureNames.end() );
+				return record;
+			};
+
+			std::vector<NativeMesh::SubsetRecord> subsetRecords{};
+			subsetRecords.reserve( mesh.subsets.size() );
+			for ( const auto &subset : mesh.subsets )
+			{
+				NativeMesh::SubsetRecord record{};
+				record.indexStart	= scast<std::uint32_t>( subset.indexStart );
+				record.indexCount	= scast<std::uint32_t>( subset.indexCount );
+				record.reflection	= subset.reflection;
+				record.transparency	= subset.transparency;
+				record.ambient		= ToRecord( subset.ambient	);
+				record.bump			= ToRecord( subset.bump		);
+				record.diffuse		= ToRecord( subset.diffuse	);
+				record.emissive		= ToRecord( subset.emissive	);
+				record.specular		= ToRecord( subset.specular	);
+				subsetRecords.emplace_back( record );
+			}
+			writer.AddCopiedChunk( ChunkKind::Subsets, i, subsetRecords.data(), sizeof( NativeMesh::SubsetRecord ), subsetRecords.size() );
+			writer.AddStrings( ChunkKind::TextureNames, i, textureNames );
+
+			if ( !mesh.lods.empty() )
+			{
+				std::vector<float>		lodErrors{};
+				std::vector<IndexRange>	lodRanges{};
+				for ( const auto &level : mesh.lods )
+				{
+					lodErrors.emplace_back( level.error );
+					lodRanges.insert( lodRanges.end(), level.subsetRanges.begin(), level.subsetRanges.end() );
+				}
+				writer.AddCopiedChunk( ChunkKind::LODErrors, i, lodErrors.data(), sizeof( float ),		lodErrors.size() );
+				writer.AddCopiedChunk( ChunkKind::LODRanges, i, lodRanges.data(), sizeof( IndexRange ),	lodRanges.size() );
+			}
+
+			std::vector<Bounds> subsetBounds{};
+			subsetBounds.reserve( mesh.subsets.size() );
+			for ( const auto &subset : mesh.subsets )
+			{
+				subsetBounds.emplace_back( subset.bounds );
+			}
+			writer.AddCopiedChunk( ChunkKind::MeshBounds,	i, &mesh.bounds,		sizeof( Bounds ), 1 );
+			writer.AddCopiedChunk( ChunkKind::SubsetBounds,	i, subsetBounds.data(),	sizeof( Bounds ), subsetBounds.size() );
+
+			if ( view.IsIndex16() )
+			{
+				writer.AddChunk( ChunkKind::Indices16,	i, view.indices16	);
+			}
+			else
+			{
+				writer.AddChunk( ChunkKind::Indices,	i, view.indices		);
+			}
+			const bool isQuantized = ( i < quantizedMeshes.size() );
+			const auto &quantized  = ( isQuantized ) ? quantizedMeshes[i] : notQuantized;
+			if ( isQuantized )
+			{
+				writer.AddCopiedChunk( ChunkKind::QuantizationReport, i, &quantized.report, sizeof( VertexQuantization::Report ), 1 );
+				reports.emplace_back( quantized.report );
+			}
+			if ( i < optimizationStatistics.size() )
+			{
+				writer.AddCopiedChunk( ChunkKind::OptimizationStatistics, i, &optimizationStatistics[i], sizeof( OptimizationStatistics ), 1 );
+			}
+
+			const auto &report = quantized.report;
+			if ( report.positionEncoding == Encoding::Unorm16 )
+			{
+				writer.AddCopiedChunk( ChunkKind::PositionFrame, i, &quantized.positionFrame, sizeof( VertexQuantization::PositionFrame ), 1 );
+				writer.AddChunk( ChunkKind::PositionsUnorm16, i, ArrayView<VertexQuantization::QuantizedPosition>{ quantized.positions } );
+			}
+			else
+			{
+				writer.AddChunk( ChunkKind::Positions, i, view.positions );
+			}
+
+			if ( report.normalEncoding == Encoding::Octahedral8 )
+			{
+				writer.AddChunk( ChunkKind::NormalsOct8, i, ArrayView<VertexQuantization::OctahedralNormal8>{ quantized.normals8 } );
+			}
+			else if ( report.normalEncoding == Encoding::Octahedral16 )
+			{
+				writer.AddChunk( ChunkKind::NormalsOct16, i, ArrayView<VertexQuantization::OctahedralNormal16>{ quantized.normals16 } );
+			}
+			else
+			{
+				writer.AddChunk( ChunkKind::Normals, i, view.normals );
+			}
+
+			if ( report.texCoordEncoding == Encoding::Half )
+			{
+				writer.AddChunk( ChunkKind::TexCoordsHalf, i, ArrayView<VertexQuantization::HalfTexCoord>{ quantized.texCoords } );
+			}
+			else
+			{
+				writer.AddChunk( ChunkKind::TexCoords, i, view.texCoords );
+			}
+
+			// The influences are already flattened, the entries of vertex[v] are [offsets[v], offsets[v + 1]).
+			const size_t vertexCount = view.positions.size();
+			if ( view.influenceOffsets.size() == vertexCount + 1 )
+			{
+				writer.AddChunk( ChunkKind::InfluenceOffsets, i, view.influenceOffsets );
+			}
+			else
+			{
+				// The mesh has no influence.
+				const std::vector<std::uint32_t> emptyOffsets( vertexCount + 1, 0U );
+				writer.AddCopiedChunk( ChunkKind::InfluenceOffsets, i, emptyOffsets.data(), sizeof( std::uint32_t ), emptyOffsets.size() );
+			}
+			writer.AddChunk( ChunkKind::InfluenceEntries, i, view.influenceEntries );
+
+			if ( !mesh.bindings.empty() )
+			{
+				writer.AddChunk( ChunkKind::BoneBindings, i, ArrayView<BoneBinding>{ mesh.bindings } );
+			}
+		}
+
+		// The skeleton and the clips are shared by the meshes.
+		std::vector<std::string>				boneNames{};
+		std::vector<NativeMesh::BoneRecord>		boneRecords{};
+		for ( const auto &bone : skeleton.bones )
+		{
+			NativeMesh::BoneRecord record{};
+			record.parent = bone.parent;
+			memcpy( record.scale,		&bone.bindPose.scale,		sizeof( record.scale )			);
+			memcpy( record.rotation,	&bone.bindPose.rotation,	sizeof( record.rotation )		);
+			memcpy( record.translation,	&bone.bindPose.translation,	sizeof( record.translation )	);
+
+			boneNames.emplace_back( bone.name );
+			boneRecords.emplace_back( record );
+		}
+		if ( !boneRecords.empty() )
+		{
+			writer.AddStrings( ChunkKind::BoneNames, 0, boneNames );
+			writer.AddCopiedChunk( ChunkKind::Bones, 0, boneRecords.data(), sizeof( NativeMesh::BoneRecord ), boneRecords.size() );
+		}
+
+		// The clips are compressed if the quantization is enabled. The clips that were loaded(or imported) as compressed are written as is, those are not compressed twice.
+		std::vector<AnimationCompression::CompressedClip> newlyCompressedClips{};
+		if ( quantizationOptions.enable && compressedClips.empty() && std::all_of( clips.begin(), clips.end(), AnimationCompression::CanCompress ) )
+		{
+			for ( const auto &clip : clips )
+			{
+				newlyCompressedClips.emplace_back( AnimationCompression::Compress( clip, quantizationOptions.animationTolerance ) );
+			}
+		}
+		const auto &writingCompressedClips = ( newlyCompressedClips.empty() ) ? compressedClips : newlyCompressedClips;
+
+		std::vector<std::string>				clipNames{};
+		std::vector<NativeMesh::ClipRecord>		clipRecords{};
+		std::vector<NativeMesh::TrackRecord>	trackRecords{};
+		std::vector<Donya::Vector3>				scaleKeys{};
+		std::vector<Donya::Vector4>				rotationKeys{};
+		std::vector<Donya::Vector3>				translationKeys{};
+		if ( writingCompressedClips.empty() )
+		{
+			for ( const auto &clip : clips )
+			{
+				NativeMesh::ClipRecord record{};
+				record.samplingRate	= clip.samplingRate;
+				record.duration		= clip.duration;
+				record.trackBegin	= scast<std::uint32_t>( trackRecords.size() );
+				record.trackCount	= scast<std::uint32_t>( clip.tracks.size() );
+				for ( const auto &track : clip.tracks )
+				{
+					NativeMesh::TrackRecord trackRecord{};
+					trackRecord.scaleBegin			= scast<std::uint32_t>( scaleKeys.size() );
+					trackRecord.scaleCount			= scast<std::uint32_t>( track.scales.size() );
+					trackRecord.rotationBegin		= scast<std::uint32_t>( rotationKeys.size() );
+					trackRecord.rotationCount		= scast<std::uint32_t>( track.rotations.size() );
+					trackRecord.translationBegin	= scast<std::uint32_t>( translationKeys.size() );
+					trackRecord.translationCount	= scast<std::uint32_t>( track.translations.size() );
+					scaleKeys.insert		( scaleKeys.end(),			track.scales.begin(),		track.scales.end()			);
+					rotationKeys.insert		( rotationKeys.end(),		track.rotations.begin(),	track.rotations.end()		);
+					translationKeys.insert	( translationKeys.end(),	track.translations.begin(),	track.translations.end()	);
+					trackRecords.emplace_back( trackRecord );
+				}
+
+				clipNames.emplace_back( clip.name );
+				clipRecords.emplace_back( record );
+			}
+		}
+		if ( !clipRecords.empty() )
+		{
+			writer.AddStrings( ChunkKind::ClipNames, 0, clipNames );
+			writer.AddChunk( ChunkKind::Clips,				0, ArrayView<NativeMesh::ClipRecord>{ clipRecords }		);
+			writer.AddChunk( ChunkKind::Tracks,				0, ArrayView<NativeMesh::TrackRecord>{ trackRecords }	);
+			writer.AddChunk( ChunkKind::ScaleKeys,			0, ArrayView<Donya::Vector3>{ scaleKeys }				);
+			writer.AddChunk( ChunkKind::RotationKeys,		0, ArrayView<Donya::Vector4>{ rotationKeys }			);
+			writer.AddChunk( ChunkKind::TranslationKeys,	0, ArrayView<Donya::Vector3>{ translationKeys }			);
+		}
+
+		const size_t compressedClipCount = writingCompressedClips.size();
+		for ( size_t c = 0; c < compressedClipCount; ++c )
+		{
+			const auto &clip = writingCompressedClips[c];
+
+			NativeMesh::CompressedClipRecord record{};
+			record.samplingRate		= clip.samplingRate;
+			record.duration			= clip.duration;
+			record.frameCount		= clip.frameCount;
+			record.sourceKeyCount	= clip.report.sourceKeyCount;
+			record.rotationError	= clip.report.rotationError;
+			record.translationError	= clip.report.translationError;
+			record.scaleError		= clip.report.scaleError;
+			writer.AddCopiedChunk( ChunkKind::CompressedClip, c, &record, sizeof( NativeMesh::CompressedClipRecord ), 1 );
+
+			writer.AddChunk( ChunkKind::CompressedTracks,		c, ArrayView<AnimationCompression::CompressedTrack>{ clip.tracks }			);
+			writer.AddChunk( ChunkKind::ScaleFrames,			c, ArrayView<std::uint16_t>{ clip.scaleFrames }							);
+			writer.AddChunk( ChunkKind::ScaleKeysUnorm16,		c, ArrayView<VertexQuantization::QuantizedPosition>{ clip.scales }			);
+			writer.AddChunk( ChunkKind::RotationFrames,			c, ArrayView<std::uint16_t>{ clip.rotationFrames }						);
+			writer.AddChunk( ChunkKind::RotationKeysSmallest3,	c, ArrayView<AnimationCompression::QuantizedRotation>{ clip.rotations }	);
+			writer.AddChunk( ChunkKind::TranslationFrames,		c, ArrayView<std::uint16_t>{ clip.translationFrames }					);
+			writer.AddChunk( ChunkKind::TranslationKeysUnorm16,	c, ArrayView<VertexQuantization::QuantizedPosition>{ clip.translations }	);
+			writer.AddChunk( ChunkKind::TrackEncodings,			c, ArrayView<AnimationCompression::TrackEncoding>{ clip.encodings }		);
+			writer.AddChunk( ChunkKind::ScaleKeysFloat32,		c, ArrayView<Donya::Vector3>{ clip.rawScales }							);
+			writer.AddChunk( ChunkKind::RotationKeysFloat32,	c, ArrayView<Donya::Vector4>{ clip.rawRotations }						);
+			writer.AddChunk( ChunkKind::TranslationKeysFloat32,	c, ArrayView<Donya::Vector3>{ clip.rawTranslations }					);
+
+			clipNames.emplace_back( clip.name );
+		}
+		if ( compressedClipCount )
+		{
+			writer.AddStrings( ChunkKind::ClipNames, 0, clipNames );
+		}
+
+		if ( !writer.Save( filePath, outputErrorString ) ) { return false; }
+		// else
+
+		if ( pOutputReports ) { *pOutputReports = std::move( reports ); }
+		return true;
+	}
+
+	bool Loader::LoadByNative( const std::string &filePath, std::string *outputErrorString )
+	{
+		using NativeMesh::ChunkKind;
+
+		auto Fail = [&outputErrorString]( const char *message )
+		{
+			if ( outputErrorString != nullptr )
+			{
+				*outputErrorString = message;
+			}
+			return false;
+		};
+
+		auto pReader = std::make_shared<NativeMesh::Reader>();
+		if ( !pReader->Open( filePath, outputErrorString ) ) { return false; }
+		// else
+
+		const std::vector<std::string> fileInfo = pReader->ReadStrings( ChunkKind::FileInfo, 0 );
+		if ( fileInfo.size() < 3 ) { return Fail( "Failed : The native mesh file does not have the file information." ); }
+		// else
+
+		absFilePath		= fileInfo[0];
+		fileName		= fileInfo[1];
+		fileDirectory	= fileInfo[2];
+
+		const size_t meshCount = pReader->GetMeshCount();
+		meshes.clear();
+		meshes.resize( meshCount );
+		nativeViews.resize( meshCount );
+		for ( size_t i = 0; i < meshCount; ++i )
+		{
+			auto &mesh = meshes[i];
+			auto &view = nativeViews[i];
+
+			// The large arrays are not copied, these are paged-in when accessed.
+
+			view.indices	= pReader->View<std::uint32_t>	( ChunkKind::Indices,	i );
+			view.indices16	= pReader->View<std::uint16_t>	( ChunkKind::Indices16,	i );
+			view.positions	= pReader->View<Donya::Vector3>	( ChunkKind::Positions,	i );
+			view.normals	= pReader->View<Donya::Vector3>	( ChunkKind::Normals,	i );
+			view.texCoords	= pReader->View<Donya::Vector2>	( ChunkKind::TexCoords,	i );
+
+			// The quantized attributes can not be viewed as float, so those are decoded into the mesh.
+			{
+				namespace Quantization = VertexQuantization;
+
+				const auto positionFrames		= pReader->View<Quantization::PositionFrame>		( ChunkKind::PositionFrame,		i );
+				const auto quantizedPositions	= pReader->View<Quantization::QuantizedPosition>	( ChunkKind::PositionsUnorm16,	i );
+				const auto normals8				= pReader->View<Quantization::OctahedralNormal8>	( ChunkKind::NormalsOct8,		i );
+				const auto normals16			= pReader->View<Quantization::OctahedralNormal16>	( ChunkKind::NormalsOct16,		i );
+				const auto halfTexCoords		= pReader->View<Quantization::HalfTexCoord>			( ChunkKind::TexCoordsHalf,		i );
+				if ( !quantizedPositions.empty() )
+				{
+					if ( positionFrames.size() != 1 ) { return Fail( "Failed : The native mesh file is broken(position frame)." ); }
+					// else
+					mesh.positions = Quantization::DecodePositions( quantizedPositions, positionFrames[0] );
+				}
+				if ( !normals8.empty()		) { mesh.normals	= Quantization::DecodeNormals( normals8 );		}
+				if ( !normals16.empty()		) { mesh.normals	= Quantization::DecodeNormals( normals16 );		}
+				if ( !halfTexCoords.empty()	) { mesh.texCoords	= Quantization::DecodeTexCoords( halfTexCoords );	}
+
+				const auto reports = pReader->View<Quantization::Report>( ChunkKind::QuantizationReport, i );
+				if ( reports.size() == 1 )
+				{
+					quantizationReports.resize( meshCount );
+					quantizationReports[i] = reports[0];
+				}
+			}
+
+			const auto statistics = pReader->View<OptimizationStatistics>( ChunkKind::OptimizationStatistics, i );
+			if ( statistics.size() == 1 )
+			{
+				optimizationStatistics.resize( meshCount );
+				optimizationStatistics[i] = statistics[0];
+			}
+			const MeshView overlaid = OverlayOwnedAttributes( view, mesh );
+
+			const size_t vertexCount = overlaid.positions.size();
+			if ( overlaid.normals.size() != vertexCount || ( !overlaid.texCoords.empty() && overlaid.texCoords.size() != vertexCount ) )
+			{
+				return Fail( "Failed : The native mesh file is broken(vertex count mismatch)." );
+			}
+			// else
+
+			// The small or variable-length data are materialized.
+
+			const auto transforms = pReader->View<NativeMesh::TransformRecord>( ChunkKind::Transform, i );
+			if ( transforms.size() != 1 ) { return Fail( "Failed : The native mesh file is broken(transform)." ); }
+			// else
+			mesh.coordinateConversion	= transforms[0].coordinateConversion;
+			mesh.globalTransform		= transforms[0].globalTransform;
+
+			const auto subsetRecords	= pReader->View<NativeMesh::SubsetRecord>( ChunkKind::Subsets, i );
+			const auto textureNames		= pReader->ReadStrings( ChunkKind::TextureNames, i );
+			auto FromRecord = [&textureNames]( Material *pOutput, const NativeMesh::MaterialRecord &record )
+			{
+				if ( textureNames.size() < record.textureBegin || textureNames.size() - record.textureBegin < record.textureCount ) { return false; }
+				// else
+
+				pOutput->color = Donya::Vector4{ record.color[0], record.color[1], record.color[2], record.color[3] };
+				pOutput->textureNames.assign
+				(
+					textureNames.begin() + record.textureBegin,
+					textureNames.begin() + record.textureBegin + record.textureCount
+				);
+				return true;
+			};
+
+			mesh.subsets.resize( subsetRecords.size() );
+			for ( size_t j = 0; j < subsetRecords.size(); ++j )
+			{
+				const auto	&record = subsetRecords[j];
+				auto		&subset = mesh.subsets[j];
+				if ( view.GetIndexCount() < record.indexStart || view.GetIndexCount() - record.indexStart < record.indexCount )
+				{
+					return Fail( "Failed : The native mesh file is broken(subset range)." );
+				}
+				// else
+
+				subset.indexStart	= record.indexStart;
+				subset.indexCount	= record.indexCount;
+				subset.reflection	= record.reflection;
+				subset.transparency	= record.transparency;
+
+				bool succeeded = true;
+				succeeded &= FromRecord( &subset.ambient,	record.ambient	);
+				succeeded &= FromRecord( &subset.bump,		record.bump		);
+				succeeded &= FromRecord( &subset.diffuse,	record.diffuse	);
+				succeeded &= FromRecord( &subset.emissive,	record.emissive	);
+				succeeded &= FromRecord( &subset.specular,	record.specular	);
+				if ( !succeeded ) { return Fail( "Failed : The native mesh file is broken(texture range)." ); }
+			}
+
+			const auto lodErrors = pReader->View<float>		( ChunkKind::LODErrors, i );
+			const auto lodRanges = pReader->View<IndexRange>	( ChunkKind::LODRanges, i );
+			if ( lodRanges.size() != lodErrors.size() * mesh.subsets.size() )
+			{
+				return Fail( "Failed : The native mesh file is broken(LOD ranges)." );
+			}
+			// else
+			mesh.lods.resize( lodErrors.size() );
+			for ( size_t l = 0; l < lodErrors.size(); ++l )
+			{
+				auto &level = mesh.lods[l];
+				level.error = lodErrors[l];
+				level.subsetRanges.resize( mesh.subsets.size() );
+				for ( size_t j = 0; j < mesh.subsets.size(); ++j )
+				{
+					const auto &range = lodRanges[l * mesh.subsets.size() + j];
+					if ( view.GetIndexCount() < range.indexStart || view.GetIndexCount() - range.indexStart < range.indexCount )
+					{
+						return Fail( "Failed : The native mesh file is broken(LOD ranges)." );
+					}
+					// else
+					level.subsetRanges[j] = range;
+				}
+			}
+
+			const auto meshBounds	= pReader->View<Bounds>( ChunkKind::MeshBounds,		i );
+			const auto subsetBounds	= pReader->View<Bounds>( ChunkKind::SubsetBounds,	i );
+			if ( meshBounds.size() == 1 && subsetBounds.size() == mesh.subsets.size() )
+			{
+				mesh.bounds = meshBounds[0];
+				for ( size_t j = 0; j < mesh.subsets.size(); ++j )
+				{
+					mesh.subsets[j].bounds = subsetBounds[j];
+				}
+			}
+			else
+			{
+				// The file that saved before the bounds was introduced.
+				CalcBounds( &mesh, overlaid );
+			}
+
+			const auto influenceOffsets = pReader->View<std::uint32_t>( ChunkKind::InfluenceOffsets, i );
+			const auto influenceEntries = pReader->View<BoneInfluence>( ChunkKind::InfluenceEntries, i );
+			if ( influenceOffsets.size() != vertexCount + 1 || influenceEntries.size() < influenceOffsets[vertexCount] )
+			{
+				return Fail( "Failed : The native mesh file is broken(influences)." );
+			}
+			// else
+
+			for ( size_t v = 0; v < vertexCount; ++v )
+			{
+				if ( influenceOffsets[v + 1] < influenceOffsets[v] ) { return Fail( "Failed : The native mesh file is broken(influences)." ); }
+			}
+
+			view.influenceOffsets = influenceOffsets;
+			view.influenceEntries = influenceEntries;
+
+			const auto bindings = pReader->View<BoneBinding>( ChunkKind::BoneBindings, i );
+			mesh.bindings = bindings.ToVector();
+		}
+
+		const auto boneNames	= pReader->ReadStrings( ChunkKind::BoneNames, 0 );
+		const auto boneRecords	= pReader->View<NativeMesh::BoneRecord>( ChunkKind::Bones, 0 );
+		if ( boneNames.size() != boneRecords.size() ) { return Fail( "Failed : The native mesh file is broken(bones)." ); }
+		// else
+
+		skeleton.bones.resize( boneRecords.size() );
+		for ( size_t b = 0; b < boneRecords.size(); ++b )
+		{
+			const auto	&record	= boneRecords[b];
+			auto		&bone	= skeleton.bones[b];
+			bone.name	= boneNames[b];
+			bone.parent	= record.parent;
+			memcpy( &bone.bindPose.scale,		record.scale,		sizeof( record.scale )			);
+			memcpy( &bone.bindPose.rotation,	record.rotation,	sizeof( record.rotation )		);
+			memcpy( &bone.bindPose.translation,	record.translation,	sizeof( record.translation )	);
+		}
+		if ( !skeleton.IsValid() ) { return Fail( "Failed : The native mesh file is broken(bone hierarchy)." ); }
+		// else
+
+		const auto clipNames		= pReader->ReadStrings( ChunkKind::ClipNames, 0 );
+		const auto clipRecords		= pReader->View<NativeMesh::ClipRecord>	( ChunkKind::Clips,				0 );
+		const auto trackRecords		= pReader->View<NativeMesh::TrackRecord>	( ChunkKind::Tracks,			0 );
+		const auto scaleKeys		= pReader->View<Donya::Vector3>			( ChunkKind::ScaleKeys,			0 );
+		const auto rotationKeys		= pReader->View<Donya::Vector4>			( ChunkKind::RotationKeys,		0 );
+		const auto translationKeys	= pReader->View<Donya::Vector3>			( ChunkKind::TranslationKeys,	0 );
+		// The names are shared with the compressed clips, those have own chunks per clip.
+		const bool hasCompressedClips = !pReader->View<NativeMesh::CompressedClipRecord>( ChunkKind::CompressedClip, 0 ).empty();
+		if ( !hasCompressedClips && clipNames.size() != clipRecords.size() ) { return Fail( "Failed : The native mesh file is broken(clips)." ); }
+		// else
+
+		// Returns false if the range is broken.
+		auto CopyKeys = []( const auto &keys, std::uint32_t begin, std::uint32_t count, auto *pOutput )
+		{
+			if ( keys.size() < begin || keys.size() - begin < count ) { return false; }
+			// else
+			pOutput->assign( keys.begin() + begin, keys.begin() + begin + count );
+			return true;
+		};
+
+		clips.resize( clipRecords.size() );
+		for ( size_t c = 0; c < clipRecords.size(); ++c )
+		{
+			const auto	&record	= clipRecords[c];
+			auto		&clip	= clips[c];
+			if ( record.trackCount != skeleton.bones.size() || trackRecords.size() < record.trackBegin || trackRecords.size() - record.trackBegin < record.trackCount )
+			{
+				return Fail( "Failed : The native mesh file is broken(tracks)." );
+			}
+			// else
+
+			clip.name			= clipNames[c];
+			clip.samplingRate	= record.samplingRate;
+			clip.duration		= record.duration;
+			clip.tracks.resize( record.trackCount );
+			for ( std::uint32_t t = 0; t < record.trackCount; ++t )
+			{
+				const auto	&trackRecord	= trackRecords[record.trackBegin + t];
+				auto		&track			= clip.tracks[t];
+
+				bool succeeded = true;
+				succeeded &= CopyKeys( scaleKeys,		trackRecord.scaleBegin,			trackRecord.scaleCount,			&track.scales		);
+				succeeded &= CopyKeys( rotationKeys,	trackRecord.rotationBegin,		trackRecord.rotationCount,		&track.rotations	);
+				succeeded &= CopyKeys( translationKeys,	trackRecord.translationBegin,	trackRecord.translationCount,	&track.translations	);
+				if ( !succeeded ) { return Fail( "Failed : The native mesh file is broken(keys)." ); }
+			}
+		}
+
+		const size_t compressedClipCount = ( hasCompressedClips ) ? clipNames.size() : 0;
+		compressedClips.resize( compressedClipCount );
+		for ( size_t c = 0; c < compressedClipCount; ++c )
+		{
+			const auto records = pReader->View<NativeMesh::CompressedClipRecord>( ChunkKind::CompressedClip, c );
+			if ( records.size() != 1 ) { return Fail( "Failed : The native mesh file is broken(compressed clips)." ); }
+			// else
+
+			const auto	&record	= records[0];
+			auto		&clip	= compressedClips[c];
+			clip.name			= clipNames[c];
+			clip.samplingRate	= record.samplingRate;
+			clip.duration		= record.duration;
+			clip.frameCount		= record.frameCount;
+
+			clip.tracks				= pReader->View<AnimationCompression::CompressedTrack>		( ChunkKind::CompressedTracks,			c ).ToVector();
+			clip.scaleFrames		= pReader->View<std::uint16_t>								( ChunkKind::ScaleFrames,				c ).ToVector();
+			clip.scales				= pReader->View<VertexQuantization::QuantizedPosition>		( ChunkKind::ScaleKeysUnorm16,			c ).ToVector();
+			clip.rotationFrames		= pReader->View<std::uint16_t>								( ChunkKind::RotationFrames,			c ).ToVector();
+			clip.rotations			= pReader->View<AnimationCompression::QuantizedRotation>	( ChunkKind::RotationKeysSmallest3,		c ).ToVector();
+			clip.translationFrames	= pReader->View<std::uint16_t>								( ChunkKind::TranslationFrames,			c ).ToVector();
+			clip.translations		= pReader->View<VertexQuantization::QuantizedPosition>		( ChunkKind::TranslationKeysUnorm16,	c ).ToVector();
+			clip.encodings			= pReader->View<AnimationCompression::TrackEncoding>		( ChunkKind::TrackEncodings,			c ).ToVector();
+			clip.rawScales			= pReader->View<Donya::Vector3>								( ChunkKind::ScaleKeysFloat32,			c ).ToVector();
+			clip.rawRotations		= pReader->View<Donya::Vector4>								( ChunkKind::RotationKeysFloat32,		c ).ToVector();
+			clip.rawTranslations	= pReader->View<Donya::Vector3>								( ChunkKind::TranslationKeysFloat32,	c ).ToVector();
+			// The files before version 8 have only the quantized channels.
+			if ( clip.encodings.empty() )
+			{
+				clip.encodings.resize( clip.tracks.size() );
+			}
+			if ( clip.tracks.size() != skeleton.bones.size() || !clip.IsValid() )
+			{
+				return Fail( "Failed : The native mesh file is broken(compressed clips)." );
+			}
+			// else
+
+			clip.report.sourceKeyCount		= record.sourceKeyCount;
+			clip.report.keptKeyCount		= scast<std::uint32_t>
+			(
+				clip.scales.size()		+ clip.rotations.size()		+ clip.translations.size() +
+				clip.rawScales.size()	+ clip.rawRotations.size()	+ clip.rawTranslations.size()
+			);
+			clip.report.rotationError		= record.rotationError;
+			clip.report.translationError	= record.translationError;
+			clip.report.scaleError			= record.scaleError;
+		}
+		// The GetClips() is the same whether the data came from FBX or from the native file.
+		if ( clips.empty() )
+		{
+			for ( const auto &clip : compressedClips )
+			{
+				clips.emplace_back( AnimationCompression::Decompress( clip ) );
+			}
+		}
+
+		pNativeFile = pReader;
+		return true;
+	}
+
+	std::vector<VertexQuantization::QuantizedAttributes> Loader::QuantizeMeshes() const
+	{
+		std::vector<VertexQuantization::QuantizedAttributes> quantizedMeshes{};
+		if ( !quantizationOptions.enable ) { return quantizedMeshes; }
+		// else
+
+		quantizedMeshes.resize( meshes.size() );
+		for ( size_t i = 0; i < meshes.size(); ++i )
+		{
+			const MeshView view = GetMeshView( i );
+			quantizedMeshes[i] = VertexQuantization::Quantize( view.positions, view.normals, view.texCoords, quantizationOptions.tolerance );
+		}
+		return quantizedMeshes;
+	}
+	void Loader::ApplyVertexQuantization( const std::vector<VertexQuantization::QuantizedAttributes> &quantizedMeshes )
+	{
+		namespace Quantization = VertexQuantization;
+
+		quantizationReports.clear();
+		for ( size_t i = 0; i < quantizedMeshes.size() && i < meshes.size(); ++i )
+		{
+			const auto	&quantized	= quantizedMeshes[i];
+			auto		&mesh		= meshes[i];
+
+			// Decoded as same as the LoadByNative(), so the result is same as the load of saved file.
+			if ( !quantized.positions.empty()	) { mesh.positions	= Quantization::DecodePositions( ArrayView<Quantization::QuantizedPosition>{ quantized.positions }, quantized.positionFrame );	}
+			if ( !quantized.normals8.empty()	) { mesh.normals	= Quantization::DecodeNormals( ArrayView<Quantization::OctahedralNormal8>{ quantized.normals8 } );			}
+			if ( !quantized.normals16.empty()	) { mesh.normals	= Quantization::DecodeNormals( ArrayView<Quantization::OctahedralNormal16>{ quantized.normals16 } );		}
+			if ( !quantized.texCoords.empty()	) { mesh.texCoords	= Quantization::DecodeTexCoords( ArrayView<Quantization::HalfTexCoord>{ quantized.texCoords } );			}
+
+			quantizationReports.emplace_back( quantized.report );
+		}
+	}
+
+	void Loader::ApplyClipCompression()
+	{
+		if ( !quantizationOptions.enable || !std::all_of( clips.begin(), clips.end(), AnimationCompression::CanCompress ) ) { return; }
+		// else
+
+		compressedClips.clear();
+		for ( auto &clip : clips )
+		{
+			compressedClips.emplace_back( AnimationCompression::Compress( clip, quantizationOptions.animationTolerance ) );
+			clip = AnimationCompression::Decompress( compressedClips.back() );
 		}
 	}
 
-	void FetchBoneInfluences( const fbxsdk::FbxMesh *pMesh, std::vector<Loader::BoneInfluencesPerControlPoint> &influences )
+	void Loader::Materialize()
 	{
-		const int ctrlPointCount = pMesh->GetControlPointsCount();
-		influences.resize( ctrlPointCount );
+		if ( !pNativeFile ) { return; }
+		// else
 
-		auto FetchInfluenceFromCluster =
-		[]( std::vector<Loader::BoneInfluencesPerControlPoint> &influences, const FBX::FbxCluster *pCluster, int clustersIndex )
+		const size_t meshCount = meshes.size();
+		for ( size_t i = 0; i < meshCount; ++i )
 		{
-			const int		ctrlPointIndicesSize	= pCluster->GetControlPointIndicesCount();
-			const int		*ctrlPointIndices		= pCluster->GetControlPointIndices();
-			const double	*ctrlPointWeights		= pCluster->GetControlPointWeights();
+			auto		&mesh = meshes[i];
+			const auto	view  = GetMeshView( i );
+
+			mesh.indices	= view.indices.ToVector();
+			mesh.indices16	= view.indices16.ToVector();
+			mesh.normals	= view.normals.ToVector();
+			mesh.positions	= view.positions.ToVector();
+			mesh.texCoords	= view.texCoords.ToVector();
+			mesh.influenceOffsets	= view.influenceOffsets.ToVector();
+			mesh.influenceEntries	= view.influenceEntries.ToVector();
+		}
 
-			if ( !ctrlPointIndicesSize || !ctrlPointIndices || !ctrlPointWeights ) { return; }
-			// else
+		nativeViews.clear();
+		pNativeFile.reset();
+	}
 
-			for ( int i = 0; i < ctrlPointIndicesSize; ++i )
-			{
-				auto	&data	= influences[ctrlPointIndices[i]].cluster;
-				float	weight	= scast<float>( ctrlPointWeights[i] );
-				data.emplace_back( clustersIndex, weight );
-			}
-		};
-		auto FetchClusterFromSkin =
-		[&FetchInfluenceFromCluster]( std::vector<Loader::BoneInfluencesPerControlPoint> &influences, const FBX::FbxSkin *pSkin )
-		{
-			const int clusterCount = pSkin->GetClusterCount();
-			for ( int i = 0; i < clusterCount; ++i )
-			{
-				const FBX::FbxCluster *pCluster = pSkin->GetCluster( i );
-				FetchInfluenceFromCluster( influences, pCluster, i );
-			}
-		};
+	Loader Loader::Clone() const
+	{
+		Loader clone{};
+		clone.absFilePath	= absFilePath;
+		clone.fileName		= fileName;
+		clone.fileDirectory	= fileDirectory;
+		clone.meshes		= meshes;
+		clone.skeleton		= skeleton;
+		clone.clips			= clips;
+		clone.importOptions	= importOptions;
+		clone.quantizationOptions = quantizationOptions;
+		clone.quantizationReports = quantizationReports;
+		clone.compressedClips = compressedClips;
+		clone.optimizationStatistics = optimizationStatistics;
+		clone.pNativeFile	= pNativeFile;
+		clone.nativeViews	= nativeViews;
+		return clone;
+	}
 
-		const int deformersCount = pMesh->GetDeformerCount( FBX::FbxDeformer::eSkin );
-		for ( int i = 0; i < deformersCount; ++i )
+	Loader::MeshView Loader::OverlayOwnedAttributes( MeshView view, const Mesh &mesh )
+	{
+		if ( !mesh.positions.empty()	) { view.positions	= mesh.positions;	}
+		if ( !mesh.normals.empty()		) { view.normals	= mesh.normals;		}
+		if ( !mesh.texCoords.empty()	) { view.texCoords	= mesh.texCoords;	}
+		return view;
+	}
+
+	const Loader::Bounds &Loader::GetMeshBounds( size_t meshIndex ) const
+	{
+		_ASSERT_EXPR( meshIndex < meshes.size(), L"Error : Passed mesh index is out of range!" );
+		return meshes[meshIndex].bounds;
+	}
+	const Loader::Bounds &Loader::GetSubsetBounds( size_t meshIndex, size_t subsetIndex ) const
+	{
+		_ASSERT_EXPR( meshIndex < meshes.size(), L"Error : Passed mesh index is out of range!" );
+		_ASSERT_EXPR( subsetIndex < meshes[meshIndex].subsets.size(), L"Error : Passed subset index is out of range!" );
+		return meshes[meshIndex].subsets[subsetIndex].bounds;
+	}
+	Loader::Bounds Loader::GetModelBounds() const
+	{
+		Bounds model = Bounds::MakeEmpty();
+		for ( const auto &it : meshes )
 		{
-			FBX::FbxSkin *pSkin = scast<FBX::FbxSkin *>( pMesh->GetDeformer( i, FBX::FbxDeformer::eSkin ) );
-			
-			FetchClusterFromSkin( influences, pSkin );
+			model = Bounds::Merge( model, it.bounds );
 		}
+		return model;
 	}
 
-#endif // USE_FBX_SDK
-
-	bool Loader::Load( const std::string &filePath, std::string *outputErrorString )
+	Loader::MeshView Loader::GetMeshView( size_t meshIndex ) const
 	{
-	#if USE_FBX_SDK
+		_ASSERT_EXPR( meshIndex < meshes.size(), L"Error : Passed mesh index is out of range!" );
 
-		auto ShouldUseFBXSDK = []( const std::string &filePath )
-		{
-			constexpr std::array<const char *, 4> EXTENSIONS
-			{
-				".obj", ".OBJ",
-				".fbx", ".FBX"
-			};
+		if ( pNativeFile ) { return OverlayOwnedAttributes( nativeViews[meshIndex], meshes[meshIndex] ); }
+		// else
 
-			for ( size_t i = 0; i < EXTENSIONS.size(); ++i )
-			{
-				if ( filePath.find( EXTENSIONS[i] ) != std::string::npos )
-				{
-					return true;
-				}
-			}
+		const auto &mesh = meshes[meshIndex];
 
-			return false;
-		};
+		MeshView view{};
+		view.indices	= mesh.indices;
+		view.indices16	= mesh.indices16;
 
-		if ( ShouldUseFBXSDK( filePath ) )
+		view.normals	= mesh.normals;
+		view.positions	= mesh.positions;
+		view.texCoords	= mesh.texCoords;
+		view.influenceOffsets	= mesh.influenceOffsets;
+		view.influenceEntries	= mesh.influenceEntries;
+		return view;
+	}
+
+#if USE_FBX_SDK
+
+#define USE_TRIANGULATE ( false )
+#define USE_PARALLEL_FETCH ( true )
+
+	bool Loader::LoadThroughImportCache( const std::string &filePath, std::string *outputErrorString )
+	{
+		ImportCache::Fingerprint fingerprint{};
+		if ( !ImportCache::MakeFingerprint( filePath, &fingerprint ) )
 		{
+			// Can not fingerprint(e.g. the file is empty), so I can not use the cache.
 			return LoadByFBXSDK( filePath, outputErrorString );
 		}
 		// else
 
-	#endif // USE_FBX_SDK
+		const std::string entryPath = ImportCache::MakeEntryPath( fingerprint, importOptions.MakeKey(), quantizationOptions.MakeKey() );
 
-		auto ShouldLoadByCereal = []( const std::string &filePath )->const char *
+		if ( IsExistFile( entryPath ) )
 		{
-			constexpr std::array<const char *, 1> EXTENSIONS
-			{
-				".bin"
-			};
+			if ( LoadByNative( entryPath, nullptr ) ) { return true; }
+			// else
 
-			for ( size_t i = 0; i < EXTENSIONS.size(); ++i )
+			// The entry is broken, discard the partially loaded data. The entry will be overwritten.
+			meshes.clear();
+			skeleton = Animation::Skeleton{};
+			clips.clear();
+			compressedClips.clear();
+			pNativeFile.reset();
+			nativeViews.clear();
+			quantizationReports.clear();
+			optimizationStatistics.clear();
+		}
+
+		if ( !LoadByFBXSDK( filePath, outputErrorString ) ) { return false; }
+		// else
+
+		// The next Load() will hit the entry, so this result must be the same as that.
+		// The quantized attributes are kept for the saving, because the quantization of decoded attributes may not give the same ones.
+		const std::vector<VertexQuantization::QuantizedAttributes> quantizedMeshes = QuantizeMeshes();
+		ApplyVertexQuantization( quantizedMeshes );
+		ApplyClipCompression();
+
+		// Failing to write the entry is not a failure of the load.
+		if ( ImportCache::PrepareCacheDirectory() )
+		{
+			// Write to the temporary file then rename it,
+			// so the other sessions(or threads) never see a partially written entry.
+			const std::string temporaryPath = MakeTemporaryFilePath( entryPath );
+			if ( SaveByNative( temporaryPath, nullptr, nullptr, quantizedMeshes ) )
 			{
-				if ( filePath.find( EXTENSIONS[i] ) != std::string::npos )
+				std::string replaceError{};
+				if ( !ReplaceFileAtomically( temporaryPath, entryPath, &replaceError ) )
 				{
-					return EXTENSIONS[i];
+					OutputDebugStringA( ( "[Import Cache] " + replaceError + "\n" ).c_str() );
 				}
 			}
-
-			return "NOT FOUND";
-		};
-
-		auto resultExt = ShouldLoadByCereal( filePath );
-		if ( !strcmp( ".bin", resultExt ) )
-		{
-			return LoadByCereal( filePath, outputErrorString );
+			else
+			{
+				DeleteFileA( temporaryPath.c_str() );
+			}
 		}
 
-		return false;
+		return true;
 	}
 
-	void Loader::SaveByCereal( const std::string &filePath ) const
-	{
-		Serializer::Extension bin  = Serializer::Extension::BINARY;
-
-		std::lock_guard<std::mutex> lock( cerealMutex );
-		
-		Serializer seria;
-		seria.Save( bin, filePath.c_str(),  SERIAL_ID, *this );
-	}
-	
-	bool Loader::LoadByCereal( const std::string &filePath, std::string *outputErrorString )
+	/// <summary>
+	/// The storage of FbxManager(with FbxIOSettings) that are not used now.<para></para>
+	/// The creation of FbxManager is heavy, so I reuse those.<para></para>
+	/// One manager is used by only one import at the same time,
+	/// so the lock is needed only while acquire or release.
+	/// </summary>
+	class FBXContextPool
 	{
-		Serializer::Extension ext = Serializer::Extension::BINARY;
+	private:
+		std::mutex						poolMutex;
+		std::vector<FBX::FbxManager *>	vacantManagers;
+	public:
+		FBXContextPool() : poolMutex(), vacantManagers() {}
+		~FBXContextPool()
+		{
+			for ( auto &pManager : vacantManagers )
+			{
+				pManager->Destroy();
+			}
+			vacantManagers.clear();
+		}
+		FBXContextPool( const FBXContextPool & ) = delete;
+		FBXContextPool &operator = ( const FBXContextPool & ) = delete;
+	public:
+		static FBXContextPool &GetInstance()
+		{
+			static FBXContextPool instance{};
+			return instance;
+		}
+	public:
+		FBX::FbxManager *Acquire()
+		{
+			{
+				std::lock_guard<std::mutex> lock( poolMutex );
 
-		std::lock_guard<std::mutex> lock( cerealMutex );
-		
-		Serializer seria;
-		seria.Load( ext, filePath.c_str(), SERIAL_ID, *this );
+				if ( !vacantManagers.empty() )
+				{
+					FBX::FbxManager *pManager = vacantManagers.back();
+					vacantManagers.pop_back();
+					return pManager;
+				}
+			}
+			// else
 
-		return true;
-	}
+			FBX::FbxManager		*pManager		= FBX::FbxManager::Create();
+			FBX::FbxIOSettings	*pIOSettings	= FBX::FbxIOSettings::Create( pManager, IOSROOT );
+			pManager->SetIOSettings( pIOSettings );
 
-#if USE_FBX_SDK
+			return pManager;
+		}
+		void Release( FBX::FbxManager *pManager )
+		{
+			if ( !pManager ) { return; }
+			// else
 
-#define USE_TRIANGULATE ( false )
+			std::lock_guard<std::mutex> lock( poolMutex );
+			vacantManagers.push_back( pManager );
+		}
+	public:
+		/// <summary>
+		/// Acquire at constructor, Release at destructor.
+		/// </summary>
+		class ScopedContext
+		{
+		private:
+			FBX::FbxManager *pManager;
+		public:
+			ScopedContext() : pManager( FBXContextPool::GetInstance().Acquire() ) {}
+			~ScopedContext()
+			{
+				FBXContextPool::GetInstance().Release( pManager );
+			}
+			ScopedContext( const ScopedContext & ) = delete;
+			ScopedContext &operator = ( const ScopedContext & ) = delete;
+		public:
+			FBX::FbxManager *GetManager() const { return pManager; }
+		};
+	};
 
 	bool Loader::LoadByFBXSDK( const std::string &filePath, std::string *outputErrorString )
 	{
@@ -229,20 +1956,19 @@ namespace Donya
 
 		MakeAbsoluteFilePath( filePath );
 
-		std::unique_ptr<std::lock_guard<std::mutex>> pLock{}; // Use scoped-lock without code-bracket.
-		pLock = std::make_unique<std::lock_guard<std::mutex>>( fbxMutex );
+		// The context is not shared with other threads while this function,
+		// so the independent files can be imported truly in parallel.
+		FBXContextPool::ScopedContext context{};
+		FBX::FbxManager *pManager = context.GetManager();
 
-		FBX::FbxManager		*pManager		= FBX::FbxManager::Create();
-		FBX::FbxIOSettings	*pIOSettings	= FBX::FbxIOSettings::Create( pManager, IOSROOT );
-		pManager->SetIOSettings( pIOSettings );
+		FBX::FbxScene *pScene = FBX::FbxScene::Create( pManager, "" );
 
 		auto Uninitialize =
 		[&]
 		{
-			pManager->Destroy();
+			// The manager is reused by next import, so I should destroy the objects of this import.
+			pScene->Destroy();
 		};
-
-		FBX::FbxScene *pScene = FBX::FbxScene::Create( pManager, "" );
 		#pragma region Import
 		{
 			FBX::FbxImporter *pImporter		= FBX::FbxImporter::Create( pManager, "" );
@@ -255,6 +1981,7 @@ namespace Donya
 					*outputErrorString += pImporter->GetStatus().GetErrorString();
 				}
 
+				pImporter->Destroy();
 				Uninitialize();
 				return false;
 			}
@@ -268,6 +1995,7 @@ namespace Donya
 					*outputErrorString += pImporter->GetStatus().GetErrorString();
 				}
 
+				pImporter->Destroy();
 				Uninitialize();
 				return false;
 			}
@@ -276,8 +2004,6 @@ namespace Donya
 		}
 		#pragma endregion
 
-		pLock.reset( nullptr );
-
 	#ifdef USE_TRIANGULATE
 		{
 			FBX::FbxGeometryConverter geometryConverter( pManager );
@@ -289,23 +2015,129 @@ namespace Donya
 		std::vector<FBX::FbxNode *> fetchedMeshes{};
 		Traverse( pScene->GetRootNode(), &fetchedMeshes );
 
-		std::vector<BoneInfluencesPerControlPoint> influencesPerCtrlPoints{};
-
 		size_t meshCount = fetchedMeshes.size();
 		meshes.resize( meshCount );
+
+		// The skeleton is made before the meshes, because the bindings of meshes refer to it.
+		std::vector<FBX::FbxNode *> boneNodes{};
+		std::unordered_map<const FBX::FbxNode *, int> boneIndices{};
+		{
+			BindMatrixMap bindMatrices{};
+			FetchBindMatrices( fetchedMeshes, &bindMatrices );
+
+			skeleton = Animation::Skeleton{};
+			FetchSkeleton( pScene, bindMatrices, &skeleton, &boneNodes );
+			for ( size_t i = 0; i < boneNodes.size(); ++i )
+			{
+				boneIndices.emplace( boneNodes[i], scast<int>( i ) );
+			}
+		}
+
+		// FBX SDK is not thread-safe: the evaluation uses the evaluator and the cache of the scene,
+		// and the skins, the clusters and the properties are reached through the connections of the scene objects.
+		// So everything that touches those is fetched by this thread only.
+		std::vector<int>						materialCounts( meshCount, 0 );
+		std::vector<std::vector<std::uint32_t>>	influenceOffsets( meshCount );
+		std::vector<std::vector<BoneInfluence>>	influenceEntries( meshCount );
 		for ( size_t i = 0; i < meshCount; ++i )
 		{
 			FBX::FbxMesh *pMesh = fetchedMeshes[i]->GetMesh();
 
-			influencesPerCtrlPoints.clear();
-			FetchBoneInfluences( pMesh, influencesPerCtrlPoints );
-
-			FetchVertices( i, pMesh, influencesPerCtrlPoints );
-			FetchMaterial( i, pMesh );
+			materialCounts[i] = pMesh->GetNode()->GetMaterialCount();
 			FetchGlobalTransform( i, pMesh );
+			FetchBoneInfluences( pMesh, influenceOffsets[i], influenceEntries[i] );
+			FetchBoneBindings( pMesh, boneIndices, &meshes[i].bindings );
+		}
+
+		// Each mesh is fetched into only its own meshes[i], so the result is not depend on the order of threads.
+		// It reads only the raw arrays of the mesh(the control points, the polygons and the layer elements).
+		auto FetchMesh = [&]( size_t i )
+		{
+			LimitBoneInfluences( influenceOffsets[i], influenceEntries[i], SkinnedMesh::MAX_BONE_INFLUENCES );
+			FetchVertices( i, fetchedMeshes[i]->GetMesh(), materialCounts[i], influenceOffsets[i], influenceEntries[i] );
+			CompactBoneBindings( &meshes[i] );
+		};
+
+	#if USE_PARALLEL_FETCH
+		Donya::ParallelFor( meshCount, FetchMesh );
+	#else
+		for ( size_t i = 0; i < meshCount; ++i )
+		{
+			FetchMesh( i );
+		}
+	#endif // USE_PARALLEL_FETCH
+
+		// The materials are fetched after the vertices because those are stored into the subsets, that are made by the FetchVertices().
+		for ( size_t i = 0; i < meshCount; ++i )
+		{
+			FetchMaterial( i, fetchedMeshes[i]->GetMesh() );
 		}
 
+		// The evaluation of FBX SDK changes the current stack of the scene, so the clips are fetched by this thread only.
+		FetchAnimationClips( pScene, boneNodes, skeleton, importOptions.animationSamplingRate, &clips );
+
 		Uninitialize();
+
+		if ( importOptions.splitLargeMesh )
+		{
+			std::vector<Mesh> splitMeshes{};
+			for ( auto &it : meshes )
+			{
+				if ( it.positions.size() <= Mesh::MAX_VERTEX_COUNT_OF_INDEX16 )
+				{
+					splitMeshes.emplace_back( std::move( it ) );
+					continue;
+				}
+				// else
+
+				std::vector<Mesh> parts = SplitByVertexCount( it, Mesh::MAX_VERTEX_COUNT_OF_INDEX16 );
+				for ( auto &part : parts )
+				{
+					splitMeshes.emplace_back( std::move( part ) );
+				}
+			}
+			meshes = std::move( splitMeshes );
+		}
+
+		if ( importOptions.optimizeVertexCache )
+		{
+			optimizationStatistics.resize( meshes.size() );
+			Donya::ParallelFor
+			(
+				meshes.size(),
+				[&]( size_t i )
+				{
+					OptimizeForVertexCache( &meshes[i], &optimizationStatistics[i] );
+				}
+			);
+		}
+
+		if ( !importOptions.lodErrors.empty() )
+		{
+			Donya::ParallelFor
+			(
+				meshes.size(),
+				[&]( size_t i )
+				{
+					GenerateLODs( &meshes[i], importOptions.lodErrors, importOptions.optimizeVertexCache );
+				}
+			);
+		}
+
+		for ( auto &it : meshes )
+		{
+			it.CompactIndices();
+		}
+
+		Donya::ParallelFor
+		(
+			meshes.size(),
+			[&]( size_t i )
+			{
+				CalcBounds( &meshes[i], GetMeshView( i ) );
+			}
+		);
+
 		return true;
 	}
 
@@ -332,10 +2164,79 @@ namespace Donya
 		absFilePath = GetUTF8FullPath( filePath, FILE_PATH_LENGTH );
 	}
 
-	void Loader::FetchVertices( size_t meshIndex, const FBX::FbxMesh *pMesh, const std::vector<BoneInfluencesPerControlPoint> &fetchedInfluences )
+	/// <summary>
+	/// The attributes of one polygon-corner. The corners that have same attributes are welded into one vertex.
+	/// </summary>
+	struct CornerAttribute
+	{
+		Donya::Vector3	position{};
+		Donya::Vector3	normal{};
+		Donya::Vector2	texCoord{};
+		int				ctrlPointIndex{};	// Represents the bone influences.
+	};
+	/// <summary>
+	/// Hashing by the bit-pattern of position, normal and texCoord.<para></para>
+	/// The influences are not hashed, because those are almost decided by position.
+	/// </summary>
+	struct CornerAttributeHasher
+	{
+		size_t operator()( const CornerAttribute &key ) const
+		{
+			constexpr size_t FLOAT_COUNT = 8;
+			const std::array<float, FLOAT_COUNT> elements
+			{
+				key.position.x,	key.position.y,	key.position.z,
+				key.normal.x,	key.normal.y,	key.normal.z,
+				key.texCoord.x,	key.texCoord.y
+			};
+
+			// FNV-1a.
+			size_t hash = scast<size_t>( 2166136261U );
+			for ( size_t i = 0; i < FLOAT_COUNT; ++i )
+			{
+				std::uint32_t bits{};
+				memcpy( &bits, &elements[i], sizeof( std::uint32_t ) );
+
+				hash ^= scast<size_t>( bits );
+				hash *= scast<size_t>( 16777619U );
+			}
+			return hash;
+		}
+	};
+	struct CornerAttributeEqual
+	{
+		const std::vector<std::uint32_t>			*pInfluenceOffsets{};
+		const std::vector<Loader::BoneInfluence>	*pInfluenceEntries{};
+	public:
+		bool operator()( const CornerAttribute &L, const CornerAttribute &R ) const
+		{
+			// Compare by bit-pattern, because the welding must not change any attribute.
+			if ( memcmp( &L.position,	&R.position,	sizeof( Donya::Vector3 ) ) ) { return false; }
+			if ( memcmp( &L.normal,		&R.normal,		sizeof( Donya::Vector3 ) ) ) { return false; }
+			if ( memcmp( &L.texCoord,	&R.texCoord,	sizeof( Donya::Vector2 ) ) ) { return false; }
+			if ( L.ctrlPointIndex == R.ctrlPointIndex ) { return true; }
+			// else
+
+			const auto &offsets = *pInfluenceOffsets;
+			const auto &entries = *pInfluenceEntries;
+			const std::uint32_t beginL = offsets[L.ctrlPointIndex];
+			const std::uint32_t beginR = offsets[R.ctrlPointIndex];
+			const std::uint32_t influenceCount = offsets[L.ctrlPointIndex + 1] - beginL;
+			if ( influenceCount != offsets[R.ctrlPointIndex + 1] - beginR ) { return false; }
+			// else
+
+			for ( std::uint32_t i = 0; i < influenceCount; ++i )
+			{
+				if ( entries[beginL + i].index  != entries[beginR + i].index  ) { return false; }
+				if ( entries[beginL + i].weight != entries[beginR + i].weight ) { return false; }
+			}
+			return true;
+		}
+	};
+
+	void Loader::FetchVertices( size_t meshIndex, const FBX::FbxMesh *pMesh, int mtlCount, const std::vector<std::uint32_t> &ctrlPointInfluenceOffsets, const std::vector<BoneInfluence> &ctrlPointInfluenceEntries )
 	{
 		const FBX::FbxVector4 *pControlPointsArray = pMesh->GetControlPoints();
-		const int mtlCount = pMesh->GetNode()->GetMaterialCount();
 		const int polygonCount = pMesh->GetPolygonCount();
 
 		auto &mesh = meshes[meshIndex];
@@ -363,9 +2264,28 @@ namespace Donya
 			}
 		}
 
-		size_t vertexCount = 0;
+		FBX::FbxStringList uvName;
+		pMesh->GetUVSetNames( uvName );
+		const bool hasUV = ( 0 < uvName.GetCount() );
+
+		// Welds the corners that have same attributes, so the "indices" will be a real shared index-buffer.
+		using WeldMap = std::unordered_map<CornerAttribute, size_t, CornerAttributeHasher, CornerAttributeEqual>;
+		const size_t cornerCount = scast<size_t>( polygonCount ) * 3;
+		WeldMap welded
+		{
+			cornerCount,
+			CornerAttributeHasher{},
+			CornerAttributeEqual{ &ctrlPointInfluenceOffsets, &ctrlPointInfluenceEntries }
+		};
 
-		mesh.indices.resize( polygonCount * 3 );
+		mesh.normals.reserve( cornerCount );
+		mesh.positions.reserve( cornerCount );
+		mesh.influenceOffsets.reserve( cornerCount + 1 );
+		mesh.influenceOffsets.assign( 1, 0U );
+		mesh.influenceEntries.reserve( ctrlPointInfluenceEntries.size() );
+		if ( hasUV ) { mesh.texCoords.reserve( cornerCount ); }
+
+		mesh.indices.resize( cornerCount );
 		for ( int polyIndex = 0; polyIndex < polygonCount; ++polyIndex )
 		{
 			// The material for current face.
@@ -380,44 +2300,59 @@ namespace Donya
 			int indexOffset = subset.indexStart + subset.indexCount;
 
 			FBX::FbxVector4	fbxNormal;
-			Donya::Vector3	normal;
-			Donya::Vector3	position;
+			FBX::FbxVector2	fbxUV;
+			bool			isUnmapped{};
+			CornerAttribute	corner{};
 
 			size_t size = pMesh->GetPolygonSize( polyIndex );
 			for ( size_t v = 0; v < size; ++v )
 			{
+				// The "+ 0.0f" converts the negative-zero to positive-zero, for the bit-pattern comparison.
 				pMesh->GetPolygonVertexNormal( polyIndex, v, fbxNormal );
-				normal.x = scast<float>( fbxNormal[0] );
-				normal.y = scast<float>( fbxNormal[1] );
-				normal.z = scast<float>( fbxNormal[2] );
+				corner.normal.x = scast<float>( fbxNormal[0] ) + 0.0f;
+				corner.normal.y = scast<float>( fbxNormal[1] ) + 0.0f;
+				corner.normal.z = scast<float>( fbxNormal[2] ) + 0.0f;
 
-				const int ctrlPointIndex = pMesh->GetPolygonVertex( polyIndex, v );
-				position.x = scast<float>( pControlPointsArray[ctrlPointIndex][0] );
-				position.y = scast<float>( pControlPointsArray[ctrlPointIndex][1] );
-				position.z = scast<float>( pControlPointsArray[ctrlPointIndex][2] );
+				corner.ctrlPointIndex = pMesh->GetPolygonVertex( polyIndex, v );
+				corner.position.x = scast<float>( pControlPointsArray[corner.ctrlPointIndex][0] ) + 0.0f;
+				corner.position.y = scast<float>( pControlPointsArray[corner.ctrlPointIndex][1] ) + 0.0f;
+				corner.position.z = scast<float>( pControlPointsArray[corner.ctrlPointIndex][2] ) + 0.0f;
 
-				mesh.normals.push_back( normal );
-				mesh.positions.push_back( position );
+				if ( hasUV )
+				{
+					pMesh->GetPolygonVertexUV( polyIndex, v, uvName.GetStringAt( 0 ), fbxUV, isUnmapped );
+					corner.texCoord.x = scast<float>( fbxUV.mData[0] ) + 0.0f;
+					corner.texCoord.y = 1.0f - scast<float>( fbxUV.mData[1] ) + 0.0f;
+				}
 
-				mesh.indices[indexOffset + v] = vertexCount;
-				vertexCount++;
+				auto result = welded.insert( std::make_pair( corner, mesh.positions.size() ) );
+				if ( result.second )
+				{
+					// This is a new vertex.
+
+					mesh.normals.push_back( corner.normal );
+					mesh.positions.push_back( corner.position );
+					if ( hasUV ) { mesh.texCoords.push_back( corner.texCoord ); }
+
+					mesh.influenceEntries.insert
+					(
+						mesh.influenceEntries.end(),
+						ctrlPointInfluenceEntries.begin() + ctrlPointInfluenceOffsets[corner.ctrlPointIndex],
+						ctrlPointInfluenceEntries.begin() + ctrlPointInfluenceOffsets[corner.ctrlPointIndex + 1]
+					);
+					mesh.influenceOffsets.push_back( scast<std::uint32_t>( mesh.influenceEntries.size() ) );
+				}
 
-				mesh.influences.push_back( fetchedInfluences[ctrlPointIndex] );
+				mesh.indices[indexOffset + v] = scast<std::uint32_t>( result.first->second );
 			}
 			subset.indexCount += size;
 		}
 
-		FBX::FbxStringList uvName;
-		pMesh->GetUVSetNames( uvName );
-
-		FBX::FbxArray<FBX::FbxVector2> uvs{};
-		pMesh->GetPolygonVertexUVs( uvName.GetStringAt( 0 ), uvs );
-		for ( int i = 0; i < uvs.GetCount(); ++i )
-		{
-			float x = scast<float>( uvs[i].mData[0] );
-			float y = 1.0f - scast<float>( uvs[i].mData[1] );
-			mesh.texCoords.push_back( Donya::Vector2{ x, y } );
-		}
+		mesh.normals.shrink_to_fit();
+		mesh.positions.shrink_to_fit();
+		mesh.texCoords.shrink_to_fit();
+		mesh.influenceOffsets.shrink_to_fit();
+		mesh.influenceEntries.shrink_to_fit();
 	}
 
 	void Loader::FetchMaterial( size_t meshIndex, const FBX::FbxMesh *pMesh )
@@ -595,16 +2530,6 @@ namespace Donya
 		}
 	}
 
-	void ConvertFloat4x4( DirectX::XMFLOAT4X4 *pOutput, const FBX::FbxAMatrix &affineMatrix )
-	{
-		for ( int r = 0; r < 4; ++r )
-		{
-			for ( int c = 0; c < 4; ++c )
-			{
-				pOutput->m[r][c] = scast<float>( affineMatrix[r][c] );
-			}
-		}
-	}
 	void Loader::FetchGlobalTransform( size_t meshIndex, const fbxsdk::FbxMesh *pMesh )
 	{
 		FBX::FbxAMatrix globalTransform = pMesh->GetNode()->EvaluateGlobalTransform( 0 );
@@ -618,21 +2543,103 @@ namespace Donya
 	{
 		ImVec2 childFrameSize( 0.0f, 0.0f );
 
+		std::string skeletonCaption = "Skeleton[Bones:" + std::to_string( skeleton.bones.size() ) + "]";
+		if ( ImGui::TreeNode( skeletonCaption.c_str() ) )
+		{
+			ImGui::BeginChild( ImGui::GetID( scast<void *>( NULL ) ), childFrameSize );
+			const size_t boneCount = skeleton.bones.size();
+			for ( size_t i = 0; i < boneCount; ++i )
+			{
+				// Indent by the depth.
+				size_t depth = 0;
+				for ( int parent = skeleton.bones[i].parent; 0 <= parent; parent = skeleton.bones[parent].parent )
+				{
+					++depth;
+				}
+				ImGui::Text( "%*s[No:%d][%s]", scast<int>( depth * 2 ), "", i, skeleton.bones[i].name.c_str() );
+			}
+			ImGui::EndChild();
+
+			ImGui::TreePop();
+		}
+
+		std::string clipsCaption = "Animations[Count:" + std::to_string( clips.size() ) + "]";
+		if ( ImGui::TreeNode( clipsCaption.c_str() ) )
+		{
+			for ( const auto &clip : clips )
+			{
+				size_t keyCount = 0;
+				for ( const auto &track : clip.tracks )
+				{
+					keyCount += track.scales.size() + track.rotations.size() + track.translations.size();
+				}
+				ImGui::Text( "[%s][Duration:%5.2f(s)][Rate:%4.1f][Keys:%d]", clip.name.c_str(), clip.duration, clip.samplingRate, scast<int>( keyCount ) );
+			}
+
+			ImGui::TreePop();
+		}
+
+		std::string compressedClipsCaption = "CompressedAnimations[Count:" + std::to_string( compressedClips.size() ) + "]";
+		if ( ImGui::TreeNode( compressedClipsCaption.c_str() ) )
+		{
+			for ( const auto &clip : compressedClips )
+			{
+				const auto &report = clip.report;
+				ImGui::Text( "[%s][Duration:%5.2f(s)][Rate:%4.1f][Keys:%d/%d][Bytes:%d]", clip.name.c_str(), clip.duration, clip.samplingRate, scast<int>( report.keptKeyCount ), scast<int>( report.sourceKeyCount ), scast<int>( clip.GetByteSize() ) );
+				ImGui::Text( "  MaxError:[Rotation:%g(Degree)][Translation:%g][Scale:%g]", report.rotationError, report.translationError, report.scaleError );
+				ImGui::Text( "  Float32Keys:[Rotation:%d][Translation:%d][Scale:%d]", scast<int>( clip.rawRotations.size() ), scast<int>( clip.rawTranslations.size() ), scast<int>( clip.rawScales.size() ) );
+			}
+
+			ImGui::TreePop();
+		}
+
 		size_t meshCount = meshes.size();
 		for ( size_t i = 0; i < meshCount; ++i )
 		{
 			const auto &mesh = meshes[i];
+			const auto view = GetMeshView( i );
 			std::string meshCaption = "Mesh[" + std::to_string( i ) + "]";
 			if ( ImGui::TreeNode( meshCaption.c_str() ) )
 			{
-				size_t verticesCount = mesh.indices.size();
-				std::string verticesCaption = "Vertices[Count:" + std::to_string( verticesCount ) + "]";
+				size_t verticesCount = view.positions.size();
+				size_t indicesCount  = view.GetIndexCount();
+				std::string verticesCaption = "Vertices[Count:" + std::to_string( verticesCount ) + "][Indices:" + std::to_string( indicesCount ) + "]";
+
+				if ( i < optimizationStatistics.size() )
+				{
+					const auto &stats = optimizationStatistics[i];
+					ImGui::Text( "ACMR:[%5.3f -> %5.3f]", stats.before.acmr, stats.after.acmr );
+					ImGui::Text( "ATVR:[%5.3f -> %5.3f]", stats.before.atvr, stats.after.atvr );
+				}
+				if ( i < quantizationReports.size() )
+				{
+					const auto &report = quantizationReports[i];
+					ImGui::Text( "Position:[%s][MaxError:%g]",			VertexQuantization::GetEncodingName( report.positionEncoding ),	report.positionError	);
+					ImGui::Text( "Normal:[%s][MaxError:%g(Degree)]",	VertexQuantization::GetEncodingName( report.normalEncoding ),	report.normalError		);
+					ImGui::Text( "TexCoord:[%s][MaxError:%g]",			VertexQuantization::GetEncodingName( report.texCoordEncoding ),	report.texCoordError	);
+				}
+				if ( !mesh.bounds.IsEmpty() )
+				{
+					const auto &bounds = mesh.bounds;
+					ImGui::Text( "Bounds:[Min:%6.3f, %6.3f, %6.3f][Max:%6.3f, %6.3f, %6.3f]", bounds.min.x, bounds.min.y, bounds.min.z, bounds.max.x, bounds.max.y, bounds.max.z );
+					ImGui::Text( "Sphere:[Center:%6.3f, %6.3f, %6.3f][Radius:%6.3f]", bounds.center.x, bounds.center.y, bounds.center.z, bounds.radius );
+				}
+				for ( size_t l = 0; l < mesh.lods.size(); ++l )
+				{
+					const auto &level = mesh.lods[l];
+					size_t levelIndexCount = 0;
+					for ( const auto &range : level.subsetRanges )
+					{
+						levelIndexCount += range.indexCount;
+					}
+					ImGui::Text( "LOD[%d]:[Triangles:%d][MaxError:%g]", scast<int>( l + 1 ), scast<int>( levelIndexCount / 3 ), level.error );
+				}
 
 				if ( ImGui::TreeNode( verticesCaption.c_str() ) )
 				{
 					if ( ImGui::TreeNode( "Positions" ) )
 					{
-						auto &ref = mesh.positions;
+						const auto &ref = view.positions;
 
 						ImGui::BeginChild( ImGui::GetID( scast<void *>( NULL ) ), childFrameSize );
 						size_t end = ref.size();
@@ -647,7 +2654,7 @@ namespace Donya
 
 					if ( ImGui::TreeNode( "Normals" ) )
 					{
-						auto &ref = mesh.normals;
+						const auto &ref = view.normals;
 
 						ImGui::BeginChild( ImGui::GetID( scast<void *>( NULL ) ), childFrameSize );
 						size_t end = ref.size();
@@ -663,10 +2670,10 @@ namespace Donya
 					if ( ImGui::TreeNode( "Indices" ) )
 					{
 						ImGui::BeginChild( ImGui::GetID( scast<void *>( NULL ) ), childFrameSize );
-						size_t end = mesh.indices.size();
+						size_t end = view.GetIndexCount();
 						for ( size_t i = 0; i < end; ++i )
 						{
-							ImGui::Text( "[No:%d][%d]", i, mesh.indices[i] );
+							ImGui::Text( "[No:%d][%d]", scast<int>( i ), scast<int>( view.GetIndex( i ) ) );
 						}
 						ImGui::EndChild();
 
@@ -675,7 +2682,7 @@ namespace Donya
 
 					if ( ImGui::TreeNode( "TexCoords" ) )
 					{
-						auto &ref = mesh.texCoords;
+						const auto &ref = view.texCoords;
 
 						ImGui::BeginChild( ImGui::GetID( scast<void *>( NULL ) ), childFrameSize );
 						size_t end = ref.size();
@@ -781,23 +2788,25 @@ namespace Donya
 
 				if ( ImGui::TreeNode( "Bone" ) )
 				{
+					ImGui::Text( "Bindings:[%d]", scast<int>( mesh.bindings.size() ) );
+
 					if ( ImGui::TreeNode( "Influences" ) )
 					{
 						ImGui::BeginChild( ImGui::GetID( scast<void *>( NULL ) ), childFrameSize );
-						size_t boneInfluencesCount = mesh.influences.size();
+						const auto &offsets = view.influenceOffsets;
+						const auto &entries = view.influenceEntries;
+						size_t boneInfluencesCount = ( offsets.empty() ) ? 0 : offsets.size() - 1;
 						for ( size_t v = 0; v < boneInfluencesCount; ++v )
 						{
 							ImGui::Text( "Vertex No[%d]", v );
 
-							auto &data = mesh.influences[v].cluster;
-							size_t containCount = data.size();
-							for ( size_t c = 0; c < containCount; ++c )
+							for ( std::uint32_t c = offsets[v]; c < offsets[v + 1]; ++c )
 							{
 								ImGui::Text
 								(
 									"\t[Index:%d][Weight[%6.4f]",
-									data[c].index,
-									data[c].weight
+									entries[c].index,
+									entries[c].weight
 								);
 							}
 						}
@@ -1,7 +1,7 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
-#include <mutex>
 #include <string>
 #include <vector>
 
@@ -11,6 +11,11 @@
 #include <cereal/types/vector.hpp>
 #include <cereal/types/string.hpp>
 
+#include "Animation.h"
+#include "AnimationCompression.h"
+#include "ArrayView.h"
+#include "MeshOptimizer.h"
+#include "VertexQuantization.h"
 #include "Serializer.h"
 #include "SkinnedMesh.h"
 #include "UseImGui.h"
@@ -29,7 +34,13 @@ namespace fbxsdk
 namespace DirectX
 {
 	template<class Archive>
-	void serialize( Archive &archive, XMFLOAT4X4 &f4x4 )
+	void SerializeFloat4x4( Archive &archive, XMFLOAT4X4 &f4x4, std::true_type /* isBinaryArchive */ )
+	{
+		// Same bytes as the element-wise version.
+		archive( cereal::binary_data( &f4x4.m[0][0], sizeof( XMFLOAT4X4 ) ) );
+	}
+	template<class Archive>
+	void SerializeFloat4x4( Archive &archive, XMFLOAT4X4 &f4x4, std::false_type /* isBinaryArchive */ )
 	{
 		archive
 		(
@@ -54,22 +65,34 @@ namespace DirectX
 			cereal::make_nvp( "_44", f4x4._44 )
 		);
 	}
+
+	template<class Archive>
+	void serialize( Archive &archive, XMFLOAT4X4 &f4x4 )
+	{
+		SerializeFloat4x4( archive, f4x4, IsBinaryArchive<Archive>{} );
+	}
 }
 
+template<> struct IsBulkSerializable<Donya::Vector2> : std::true_type {};
+template<> struct IsBulkSerializable<Donya::Vector3> : std::true_type {};
+static_assert( sizeof( Donya::Vector2 ) == sizeof( float ) * 2, "The bulk serialization and the native mesh format expect the Vector2 is a plain array of float." );
+static_assert( sizeof( Donya::Vector3 ) == sizeof( float ) * 3, "The bulk serialization and the native mesh format expect the Vector3 is a plain array of float." );
+
 namespace Donya
 {
+	namespace NativeMesh
+	{
+		class Reader;
+	}
+
 	/// <summary>
-	/// It can copy.
+	/// It can only move, because the loaded data is huge. Please use Clone() if you need a copy.<para></para>
+	/// The different instances can load or save at the same time on some threads.
 	/// </summary>
 	class Loader
 	{
 	private:
 		static constexpr const char *SERIAL_ID = "Loader";
-		static std::mutex cerealMutex;
-
-	#if USE_FBX_SDK
-		static std::mutex fbxMutex;
-	#endif // USE_FBX_SDK
 	public:
 	#pragma region Structs
 
@@ -80,18 +103,6 @@ namespace Donya
 		public:
 			Material() : color( 0, 0, 0, 0 ), textureNames()
 			{}
-			Material( const Material &ref )
-			{
-				*this = ref;
-			}
-			Material &operator = ( const Material &ref )
-			{
-				color = ref.color;
-				textureNames = ref.textureNames;
-				return *this;
-			}
-			~Material()
-			{}
 		private:
 			friend class cereal::access;
 			template<class Archive>
@@ -109,6 +120,44 @@ namespace Donya
 			}
 		};
 
+		/// <summary>
+		/// The axis-aligned box and the sphere that enclose the positions.
+		/// </summary>
+		struct Bounds
+		{
+			Donya::Vector3	min{};
+			Donya::Vector3	max{};
+			Donya::Vector3	center{};	// The center of sphere, that is the center of box.
+			float			radius{};	// Zero if the bounds is empty or a point.
+		public:
+			bool IsEmpty() const { return ( max.x < min.x || max.y < min.y || max.z < min.z ); }
+			/// <summary>
+			/// Returns the bounds that contains nothing. Merging into it returns the other.
+			/// </summary>
+			static Bounds MakeEmpty();
+			/// <summary>
+			/// Returns the bounds that contains both. The sphere is centered at the merged box and encloses both spheres, so it is conservative.
+			/// </summary>
+			static Bounds Merge( const Bounds &lhs, const Bounds &rhs );
+		private:
+			friend class cereal::access;
+			template<class Archive>
+			void serialize( Archive &archive, std::uint32_t version )
+			{
+				archive
+				(
+					CEREAL_NVP( min ),
+					CEREAL_NVP( max ),
+					CEREAL_NVP( center ),
+					CEREAL_NVP( radius )
+				);
+				if ( 1 <= version )
+				{
+					// archive();
+				}
+			}
+		};
+
 		struct Subset
 		{
 			size_t indexCount;
@@ -120,10 +169,9 @@ namespace Donya
 			Material diffuse;
 			Material emissive;
 			Material specular;
+			Bounds   bounds;	// The bounds of the vertices that are referenced by the subset(full resolution).
 		public:
-			Subset() : indexCount( NULL ), indexStart( NULL ), reflection( 0 ), transparency( 0 ), ambient(), bump(), diffuse(), emissive()
-			{}
-			~Subset()
+			Subset() : indexCount( NULL ), indexStart( NULL ), reflection( 0 ), transparency( 0 ), ambient(), bump(), diffuse(), emissive(), bounds( Bounds::MakeEmpty() )
 			{}
 		private:
 			friend class cereal::access;
@@ -139,6 +187,10 @@ namespace Donya
 					CEREAL_NVP( specular )
 				);
 				if ( 1 <= version )
+				{
+					archive( CEREAL_NVP( bounds ) );
+				}
+				if ( 2 <= version )
 				{
 					// archive();
 				}
@@ -168,13 +220,84 @@ namespace Donya
 				}
 			}
 		};
+
+		/// <summary>
+		/// The bone that the influence index(that is the cluster of FBX) of a mesh refers to.
+		/// </summary>
+		struct BoneBinding
+		{
+			std::int32_t		boneIndex{ -1 };		// The index of Skeleton::bones. -1 if the bone was not found.
+			DirectX::XMFLOAT4X4	inverseBindMatrix{};	// Transforms the vertex of mesh into the space of bone at the binding.
+		private:
+			friend class cereal::access;
+			template<class Archive>
+			void serialize( Archive &archive, std::uint32_t version )
+			{
+				archive
+				(
+					CEREAL_NVP( boneIndex ),
+					CEREAL_NVP( inverseBindMatrix )
+				);
+				if ( 1 <= version )
+				{
+					// archive();
+				}
+			}
+		};
 		
+		struct IndexRange
+		{
+			std::uint32_t indexStart{};
+			std::uint32_t indexCount{};
+		private:
+			friend class cereal::access;
+			template<class Archive>
+			void serialize( Archive &archive, std::uint32_t version )
+			{
+				archive
+				(
+					CEREAL_NVP( indexStart ),
+					CEREAL_NVP( indexCount )
+				);
+				if ( 1 <= version )
+				{
+					// archive();
+				}
+			}
+		};
+
+		/// <summary>
+		/// A simplified level of a mesh. It uses the same vertices as the full resolution.
+		/// </summary>
+		struct LODLevel
+		{
+			float					error{};		// The max geometric error from the full resolution(the distance of removed vertices to the simplified surface), in the unit of positions.
+			std::vector<IndexRange>	subsetRanges{};	// Per subset, the range of Mesh::indices(or indices16).
+		private:
+			friend class cereal::access;
+			template<class Archive>
+			void serialize( Archive &archive, std::uint32_t version )
+			{
+				archive
+				(
+					CEREAL_NVP( error ),
+					CEREAL_NVP( subsetRanges )
+				);
+				if ( 1 <= version )
+				{
+					// archive();
+				}
+			}
+		};
+
+		/// <summary>
+		/// The old storage of influences of a vertex. It is used only for loading the old serialized data.
+		/// </summary>
 		struct BoneInfluencesPerControlPoint
 		{
 			std::vector<BoneInfluence> cluster{};
 		public:
 			BoneInfluencesPerControlPoint() : cluster() {}
-			BoneInfluencesPerControlPoint( const BoneInfluencesPerControlPoint &ref ) : cluster( ref.cluster ) {}
 		private:
 			friend class cereal::access;
 			template<class Archive>
@@ -193,14 +316,28 @@ namespace Donya
 
 		struct Mesh
 		{
+			/// <summary>
+			/// The mesh that has vertices less than or equal to this uses 16-bit indices.
+			/// </summary>
+			static constexpr size_t MAX_VERTEX_COUNT_OF_INDEX16 = 65536;
+		public:
 			DirectX::XMFLOAT4X4			coordinateConversion;
 			DirectX::XMFLOAT4X4			globalTransform;
 			std::vector<Subset>			subsets;
-			std::vector<size_t>			indices;
+			// Only one of the indices and the indices16 is used, the other is empty.
+			std::vector<std::uint32_t>	indices;
+			std::vector<std::uint16_t>	indices16;
 			std::vector<Donya::Vector3>	normals;
 			std::vector<Donya::Vector3>	positions;
 			std::vector<Donya::Vector2>	texCoords;
-			std::vector<BoneInfluencesPerControlPoint>	influences;
+			// The influences of vertex[v] are influenceEntries[influenceOffsets[v] ~ influenceOffsets[v + 1]).
+			// The offsets has vertex-count + 1 elements.
+			std::vector<std::uint32_t>	influenceOffsets;
+			std::vector<BoneInfluence>	influenceEntries;
+			// The simplified levels, the coarser is at the back. The indices of those are stored after the indices of full resolution(the subsets).
+			std::vector<LODLevel>		lods;
+			Bounds						bounds;	// In the space of mesh with the globalTransform applied, as the subsets.
+			std::vector<BoneBinding>	bindings;	// Per influence index.
 		public:
 			Mesh() : coordinateConversion
 			(
@@ -220,9 +357,31 @@ namespace Donya
 					0, 0, 0, 1
 				}
 			),
-			subsets(), indices(), normals(), positions(), texCoords()
+			subsets(), indices(), indices16(), normals(), positions(), texCoords(),
+			influenceOffsets(), influenceEntries(), lods(), bounds( Bounds::MakeEmpty() ), bindings()
 			{}
 			Mesh( const Mesh & ) = default;
+			Mesh( Mesh && ) = default;
+			Mesh &operator = ( const Mesh & ) = default;
+			Mesh &operator = ( Mesh && ) = default;
+		public:
+			/// <summary>
+			/// Moves the 32-bit indices into the 16-bit indices, if the vertex count is small enough.
+			/// </summary>
+			void CompactIndices()
+			{
+				if ( indices.empty() || MAX_VERTEX_COUNT_OF_INDEX16 < positions.size() ) { return; }
+				// else
+
+				indices16.resize( indices.size() );
+				for ( size_t i = 0; i < indices.size(); ++i )
+				{
+					indices16[i] = static_cast<std::uint16_t>( indices[i] );
+				}
+
+				indices.clear();
+				indices.shrink_to_fit();
+			}
 		private:
 			friend class cereal::access;
 			template<class Archive>
@@ -232,18 +391,148 @@ namespace Donya
 				(
 					CEREAL_NVP( coordinateConversion ),
 					CEREAL_NVP( globalTransform ),
-					CEREAL_NVP( subsets ),
-					CEREAL_NVP( indices ), CEREAL_NVP( normals ),
-					CEREAL_NVP( positions ), CEREAL_NVP( texCoords ),
-					CEREAL_NVP( influences )
+					CEREAL_NVP( subsets )
 				);
-				if ( 1 <= version )
+
+				if ( version < 1 )
+				{
+					// The indices were saved as size_t until version 1.
+					std::vector<size_t> oldIndices( indices.begin(), indices.end() );
+					archive( cereal::make_nvp( "indices", oldIndices ) );
+
+					indices.resize( oldIndices.size() );
+					for ( size_t i = 0; i < oldIndices.size(); ++i )
+					{
+						indices[i] = static_cast<std::uint32_t>( oldIndices[i] );
+					}
+				}
+				else
+				{
+					// The vector of arithmetic is already serialized as one block by cereal.
+					archive( CEREAL_NVP( indices ) );
+				}
+
+				// The bulk serialization writes the same bytes as the per-element one, so it does not need a new version.
+				archive
+				(
+					CEREAL_BULK_NVP( normals ),
+					CEREAL_BULK_NVP( positions ), CEREAL_BULK_NVP( texCoords )
+				);
+
+				if ( version < 2 )
+				{
+					// The influences were saved per vertex until version 2.
+					std::vector<BoneInfluencesPerControlPoint> influences{};
+					archive( CEREAL_NVP( influences ) );
+
+					influenceOffsets.assign( 1, 0U );
+					influenceEntries.clear();
+					for ( const auto &it : influences )
+					{
+						influenceEntries.insert( influenceEntries.end(), it.cluster.begin(), it.cluster.end() );
+						influenceOffsets.emplace_back( static_cast<std::uint32_t>( influenceEntries.size() ) );
+					}
+				}
+				else
+				{
+					archive
+					(
+						CEREAL_BULK_NVP( influenceOffsets ),
+						CEREAL_BULK_NVP( influenceEntries )
+					);
+				}
+
+				if ( version < 3 )
+				{
+					// The indices were always 32-bit until version 3.
+					CompactIndices();
+				}
+				else
+				{
+					archive( CEREAL_NVP( indices16 ) );
+				}
+
+				if ( 4 <= version )
+				{
+					archive( CEREAL_NVP( lods ) );
+				}
+				if ( 5 <= version )
+				{
+					archive( CEREAL_NVP( bounds ) );
+				}
+				if ( 6 <= version )
+				{
+					archive( CEREAL_BULK_NVP( bindings ) );
+				}
+				if ( 7 <= version )
 				{
 					// archive();
 				}
 			}
 		};
 
+		/// <summary>
+		/// The read-only views of vertex attributes of a mesh.<para></para>
+		/// These point into the Loader's vectors or the mapped native file,
+		/// so these are valid while the Loader is alive and not re-loaded.
+		/// </summary>
+		struct MeshView
+		{
+			// Only one of the indices and the indices16 is not empty.
+			ArrayView<std::uint32_t>	indices;
+			ArrayView<std::uint16_t>	indices16;
+			ArrayView<Donya::Vector3>	normals;
+			ArrayView<Donya::Vector3>	positions;
+			ArrayView<Donya::Vector2>	texCoords;
+			ArrayView<std::uint32_t>	influenceOffsets;
+			ArrayView<BoneInfluence>	influenceEntries;
+		public:
+			bool			IsIndex16()					const { return !indices16.empty(); }
+			size_t			GetIndexCount()				const { return ( IsIndex16() ) ? indices16.size() : indices.size(); }
+			std::uint32_t	GetIndex( size_t i )		const { return ( IsIndex16() ) ? indices16[i] : indices[i]; }
+		};
+
+		/// <summary>
+		/// The options of the import by FBX SDK.<para></para>
+		/// These change the import result, so these are a part of the key of import cache.
+		/// </summary>
+		struct ImportOptions
+		{
+			bool splitLargeMesh			= false;	// Split the mesh that has vertices over Mesh::MAX_VERTEX_COUNT_OF_INDEX16, so all the meshes can use 16-bit indices.
+			bool optimizeVertexCache	= true;		// Reorder the triangles of each subset for the post-transform vertex cache, then reorder the vertices by first use.
+			// The target errors of the LOD levels, relative to the largest extent of mesh. Each level is simplified by the quadric edge collapse.
+			// The level that does not reduce the triangles enough is skipped. Empty disables the LOD generation.
+			std::vector<float> lodErrors{ 0.0025f, 0.01f, 0.04f };
+			float animationSamplingRate = 30.0f;	// Keys per second of the imported animation clips.
+		public:
+			std::uint32_t MakeKey() const;
+		};
+
+		/// <summary>
+		/// The options of the vertex attribute quantization and the animation compression at SaveByNative().<para></para>
+		/// The import cache is also saved by it, so these are a part of the key of import cache.
+		/// </summary>
+		struct QuantizationOptions
+		{
+			bool								enable = true;
+			VertexQuantization::Tolerance		tolerance{};
+			AnimationCompression::Tolerance		animationTolerance{};
+		public:
+			/// <summary>
+			/// Returns zero if disabled.
+			/// </summary>
+			std::uint32_t MakeKey() const;
+		};
+
+		/// <summary>
+		/// The vertex cache efficiency of a mesh, before and after the import optimization.
+		/// </summary>
+		struct OptimizationStatistics
+		{
+			MeshOptimizer::VertexCacheStatistics before;
+			MeshOptimizer::VertexCacheStatistics after;
+		};
+
 		// region Structs
 	#pragma endregion
 	private:
@@ -251,9 +540,33 @@ namespace Donya
 		std::string			fileName;		// only file-name, the directory is not contain.
 		std::string			fileDirectory;	// '/' terminated.
 		std::vector<Mesh>	meshes;
+		Animation::Skeleton	skeleton;
+		std::vector<Animation::Clip>	clips;	// Per FbxAnimStack.
+		ImportOptions		importOptions;	// Not serialized.
+		QuantizationOptions	quantizationOptions;	// Not serialized.
+
+		// Per mesh. It is valid only when saved or loaded as the quantized native file(or imported through the import cache), not serialized.
+		std::vector<VertexQuantization::Report>		quantizationReports;
+
+		// It is valid only when loaded by the native file that has the compressed clips(or imported through the import cache), not serialized.
+		// The "clips" are decompressed from these at that time.
+		std::vector<AnimationCompression::CompressedClip>	compressedClips;
+
+		// Per mesh. It is valid only when imported by FBX SDK with the vertex cache optimization, or loaded by the native file that was saved from that. Not serialized.
+		std::vector<OptimizationStatistics>			optimizationStatistics;
+
+		// These are valid only when loaded by native file, and not serialized.
+		// The vertex attributes of "meshes" are empty at that time, the "nativeViews" point into the mapped file instead.
+		// But the quantized attributes are decoded into "meshes", those are preferred over the "nativeViews".
+		std::shared_ptr<const NativeMesh::Reader>	pNativeFile;
+		std::vector<MeshView>						nativeViews;
 	public:
 		Loader();
 		~Loader();
+		Loader( const Loader & ) = delete;
+		Loader( Loader && ) = default;
+		Loader &operator = ( const Loader & ) = delete;
+		Loader &operator = ( Loader && ) = default;
 		private:
 			friend class cereal::access;
 			template<class Archive>
@@ -267,6 +580,14 @@ namespace Donya
 					CEREAL_NVP( meshes )
 				);
 				if ( 1 <= version )
+				{
+					archive
+					(
+						CEREAL_NVP( skeleton ),
+						CEREAL_NVP( clips )
+					);
+				}
+				if ( 2 <= version )
 				{
 					// archive();
 				}
@@ -277,8 +598,10 @@ namespace Donya
 	#if USE_FBX_SDK
 		/// .fbx, .FBX,<para></para>
 		/// .obj, .OBJ,<para></para>
+		/// (These are cached to the ImportCache directory, the second load of same file will be fast.)<para></para>
 	#endif // USE_FBX_SDK
 		/// .bin, .json(Expect, only file of saved by this Loader class).<para></para>
+		/// .nmesh(Expect, only file of saved by SaveByNative()).<para></para>
 		/// The "outputErrorString" can set nullptr.
 		/// </summary>
 		bool Load( const std::string &filePath, std::string *outputErrorString );
@@ -287,19 +610,114 @@ namespace Donya
 		/// We expect the "filePath" contain extension also.
 		/// </summary>
 		void SaveByCereal( const std::string &filePath ) const;
+		/// <summary>
+		/// Save as the native binary format, that is loaded by memory-mapping.<para></para>
+		/// The vertex attributes are quantized by the QuantizationOptions.<para></para>
+		/// The animation clips are also compressed by it, unless some clip is too long to compress.<para></para>
+		/// We expect the "filePath" contain extension(.nmesh) also.<para></para>
+		/// The "outputErrorString" and the "pOutputReports"(per mesh) can set nullptr.
+		/// </summary>
+		bool SaveByNative( const std::string &filePath, std::string *outputErrorString, std::vector<VertexQuantization::Report> *pOutputReports = nullptr ) const;
+
+		/// <summary>
+		/// Copy the vertex attributes from the mapped native file into own vectors, then release the file.<para></para>
+		/// It does nothing if not loaded by native file.
+		/// </summary>
+		void Materialize();
+		/// <summary>
+		/// Make a deep copy explicitly. The clone shares the mapped native file, if loaded by native file.
+		/// </summary>
+		Loader Clone() const;
+
 	public:
 		std::string GetAbsoluteFilePath()		const { return absFilePath;	}
 		std::string GetOnlyFileName()			const { return fileName;	}
+		/// <summary>
+		/// The vertex attributes(indices, normals, positions, texCoords, influences) are empty if loaded by native file(except the decoded quantized ones).<para></para>
+		/// Please use GetMeshView() for access to those.
+		/// </summary>
 		const std::vector<Mesh> *GetMeshes()	const { return &meshes;		}
+		MeshView GetMeshView( size_t meshIndex ) const;
+		/// <summary>
+		/// The bounds are in the space of mesh with the globalTransform applied.
+		/// </summary>
+		const Bounds &GetMeshBounds( size_t meshIndex ) const;
+		const Bounds &GetSubsetBounds( size_t meshIndex, size_t subsetIndex ) const;
+		/// <summary>
+		/// Returns the union of the bounds of all meshes.
+		/// </summary>
+		Bounds GetModelBounds() const;
+		/// <summary>
+		/// The skeleton is shared by all meshes, the Mesh::bindings map the influence indices to it.
+		/// </summary>
+		const Animation::Skeleton &GetSkeleton()		const { return skeleton;	}
+		const std::vector<Animation::Clip> &GetClips()	const { return clips;		}
+		/// <summary>
+		/// It is not empty only when loaded by the native file that was saved with the compression(or imported through the import cache).<para></para>
+		/// The GetClips() has the decompressed ones of these at that time.
+		/// </summary>
+		const std::vector<AnimationCompression::CompressedClip> &GetCompressedClips() const { return compressedClips; }
+	public:
+		/// <summary>
+		/// The options are used at next Load() of .fbx or .obj.
+		/// </summary>
+		void SetImportOptions( const ImportOptions &options ) { importOptions = options; }
+		ImportOptions GetImportOptions()		const { return importOptions; }
+		/// <summary>
+		/// It is empty if the last Load() did not import by FBX SDK(e.g. hit the import cache), or the optimization is disabled.
+		/// </summary>
+		const std::vector<OptimizationStatistics> &GetOptimizationStatistics() const { return optimizationStatistics; }
+		/// <summary>
+		/// The options are used at next SaveByNative(), and the import cache of next Load().
+		/// </summary>
+		void SetQuantizationOptions( const QuantizationOptions &options ) { quantizationOptions = options; }
+		QuantizationOptions GetQuantizationOptions()	const { return quantizationOptions; }
+		/// <summary>
+		/// It is empty if the last loaded(or imported and cached) data is not quantized.
+		/// </summary>
+		const std::vector<VertexQuantization::Report> &GetQuantizationReports() const { return quantizationReports; }
+
+		bool IsMappedNativeFile()				const { return ( pNativeFile != nullptr ); }
 	private:
 		bool LoadByCereal( const std::string &filePath, std::string *outputErrorString );
+		bool LoadByNative( const std::string &filePath, std::string *outputErrorString );
+		/// <summary>
+		/// Replace the attributes of the view by the owned(decoded) attributes of the mesh, if those exist.
+		/// </summary>
+		static MeshView OverlayOwnedAttributes( MeshView view, const Mesh &mesh );
+		/// <summary>
+		/// The "quantizedMeshes" is written instead of quantizing the attributes of meshes. It is per mesh, or empty if not quantized.
+		/// </summary>
+		bool SaveByNative( const std::string &filePath, std::string *outputErrorString, std::vector<VertexQuantization::Report> *pOutputReports, const std::vector<VertexQuantization::QuantizedAttributes> &quantizedMeshes ) const;
+		/// <summary>
+		/// Quantizes the attributes of each mesh by the QuantizationOptions. Returns empty if the quantization is disabled.
+		/// </summary>
+		std::vector<VertexQuantization::QuantizedAttributes> QuantizeMeshes() const;
+		/// <summary>
+		/// Replaces the attributes of meshes by the decoded "quantizedMeshes", and the "quantizationReports" by those reports.
+		/// </summary>
+		void ApplyVertexQuantization( const std::vector<VertexQuantization::QuantizedAttributes> &quantizedMeshes );
+		/// <summary>
+		/// Compresses the clips by the QuantizationOptions into the "compressedClips", then replaces the clips by the decompressed ones.<para></para>
+		/// It does nothing if the quantization is disabled or some clip is too long to compress, as same as SaveByNative().
+		/// </summary>
+		void ApplyClipCompression();
 		
 	#if USE_FBX_SDK
+		/// <summary>
+		/// Load the processed native file from the import cache if the source file is not changed.<para></para>
+		/// Else import by FBX SDK, then write a new cache entry.
+		/// </summary>
+		bool LoadThroughImportCache( const std::string &filePath, std::string *outputErrorString );
 		bool LoadByFBXSDK( const std::string &filePath, std::string *outputErrorString );
 
 		void MakeAbsoluteFilePath( const std::string &filePath );
 
-		void FetchVertices( size_t meshIndex, const fbxsdk::FbxMesh *pMesh, const std::vector<BoneInfluencesPerControlPoint> &fetchedInfluencesPerControlPoints );
+		/// <summary>
+		/// The "mtlCount" is the material count of the node of mesh, it is fetched by the caller because the node is not the data of mesh.<para></para>
+		/// The influences of control point[c] are influenceEntries[influenceOffsets[c] ~ influenceOffsets[c + 1]).
+		/// </summary>
+		void FetchVertices( size_t meshIndex, const fbxsdk::FbxMesh *pMesh, int mtlCount, const std::vector<std::uint32_t> &ctrlPointInfluenceOffsets, const std::vector<BoneInfluence> &ctrlPointInfluenceEntries );
 		void FetchMaterial( size_t meshIndex, const fbxsdk::FbxMesh *pMesh );
 		void AnalyseProperty( size_t meshIndex, int mtlIndex, fbxsdk::FbxSurfaceMaterial *pMaterial );
 		void FetchGlobalTransform( size_t meshIndex, const fbxsdk::FbxMesh *pMesh );
@@ -318,9 +736,21 @@ namespace Donya
 
 }
 
-CEREAL_CLASS_VERSION( Donya::Loader, 0 )
+template<> struct IsBulkSerializable<Donya::Loader::BoneInfluence> : std::true_type {};
+template<> struct IsBulkSerializable<Donya::Loader::BoneBinding> : std::true_type {};
+static_assert( sizeof( Donya::Loader::BoneInfluence ) == sizeof( int ) + sizeof( float ), "The bulk serialization and the native mesh format expect the BoneInfluence has no padding." );
+static_assert( sizeof( Donya::Loader::IndexRange ) == sizeof( std::uint32_t ) * 2, "The native mesh format expects the IndexRange has no padding." );
+static_assert( sizeof( Donya::Loader::Bounds ) == sizeof( float ) * 10, "The native mesh format expects the Bounds has no padding." );
+static_assert( sizeof( Donya::Loader::BoneBinding ) == sizeof( std::int32_t ) + sizeof( float ) * 16, "The bulk serialization and the native mesh format expect the BoneBinding has no padding." );
+
+CEREAL_CLASS_VERSION( Donya::Loader, 1 )
 CEREAL_CLASS_VERSION( Donya::Loader::Material, 0 )
-CEREAL_CLASS_VERSION( Donya::Loader::Subset, 0 )
+CEREAL_CLASS_VERSION( Donya::Loader::Bounds, 0 )
+CEREAL_CLASS_VERSION( Donya::Loader::Subset, 1 )
 CEREAL_CLASS_VERSION( Donya::Loader::BoneInfluence, 0 )
+CEREAL_CLASS_VERSION( Donya::Loader::BoneBinding, 0 )
+CEREAL_CLASS_VERSION( Donya::Loader::IndexRange, 0 )
+CEREAL_CLASS_VERSION( Donya::Loader::LODLevel, 0 )
 CEREAL_CLASS_VERSION( Donya::Loader::BoneInfluencesPerControlPoint, 0 )
-CEREAL_CLASS_VERSION( Donya::Loader::Mesh, 0 )
+CEREAL_CLASS_VERSION( Donya::Loader::Mesh, 6 )
+
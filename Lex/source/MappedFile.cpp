@@ -0,0 +1,131 @@
+#include "MappedFile.h"
+
+#include <Windows.h>
+
+#include "Common.h"
+
+namespace Donya
+{
+	MappedFile::MappedFile() :
+		hFile( INVALID_HANDLE_VALUE ), hMapping( nullptr ),
+		pView( nullptr ), size( 0 )
+	{
+
+	}
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+	bool MappedFile::Open( const std::string &filePath )
+	{
+		Close();
+
+		hFile = CreateFileA
+		(
+			filePath.c_str(),
+			GENERIC_READ,
+			FILE_SHARE_READ | FILE_SHARE_DELETE,	// Allow the ReplaceFileAtomically() to the opening file.
+			nullptr,
+			OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+			nullptr
+		);
+		if ( hFile == INVALID_HANDLE_VALUE ) { return false; }
+		// else
+
+		LARGE_INTEGER fileSize{};
+		if ( !GetFileSizeEx( hFile, &fileSize ) || fileSize.QuadPart <= 0 )
+		{
+			// The empty file can not be mapped.
+			Close();
+			return false;
+		}
+		// else
+
+		hMapping = CreateFileMappingA( hFile, nullptr, PAGE_READONLY, 0, 0, nullptr );
+		if ( !hMapping )
+		{
+			Close();
+			return false;
+		}
+		// else
+
+		pView = MapViewOfFile( hMapping, FILE_MAP_READ, 0, 0, 0 );
+		if ( !pView )
+		{
+			Close();
+			return false;
+		}
+		// else
+
+		size = scast<size_t>( fileSize.QuadPart );
+		return true;
+	}
+	bool MappedFile::Open( const std::wstring &filePath )
+	{
+		Close();
+
+		hFile = CreateFileW
+		(
+			filePath.c_str(),
+			GENERIC_READ,
+			FILE_SHARE_READ | FILE_SHARE_DELETE,	// Allow the ReplaceFileAtomically() to the opening file.
+			nullptr,
+			OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+			nullptr
+		);
+		if ( hFile == INVALID_HANDLE_VALUE ) { return false; }
+		// else
+
+		LARGE_INTEGER fileSize{};
+		if ( !GetFileSizeEx( hFile, &fileSize ) || fileSize.QuadPart <= 0 )
+		{
+			// The empty file can not be mapped.
+			Close();
+			return false;
+		}
+		// else
+
+		hMapping = CreateFileMappingW( hFile, nullptr, PAGE_READONLY, 0, 0, nullptr );
+		if ( !hMapping )
+		{
+			Close();
+			return false;
+		}
+		// else
+
+		pView = MapViewOfFile( hMapping, FILE_MAP_READ, 0, 0, 0 );
+		if ( !pView )
+		{
+			Close();
+			return false;
+		}
+		// else
+
+		size = scast<size_t>( fileSize.QuadPart );
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if ( pView )
+		{
+			UnmapViewOfFile( pView );
+			pView = nullptr;
+		}
+		if ( hMapping )
+		{
+			CloseHandle( hMapping );
+			hMapping = nullptr;
+		}
+		if ( hFile != INVALID_HANDLE_VALUE )
+		{
+			CloseHandle( hFile );
+			hFile = INVALID_HANDLE_VALUE;
+		}
+
+		size = 0;
+	}
+}
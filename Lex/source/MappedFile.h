@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+
+namespace Donya
+{
+	/// <summary>
+	/// The read-only memory-mapped file.<para></para>
+	/// The contents are paged-in by OS when accessed, so the opening does not read the whole file.<para></para>
+	/// It can not copy.
+	/// </summary>
+	class MappedFile
+	{
+	private:
+		void		*hFile;		// HANDLE.
+		void		*hMapping;	// HANDLE.
+		const void	*pView;
+		size_t		size;
+	public:
+		MappedFile();
+		~MappedFile();
+		MappedFile( const MappedFile & ) = delete;
+		MappedFile &operator = ( const MappedFile & ) = delete;
+	public:
+		/// <summary>
+		/// Returns false if failed to open or the file is empty.<para></para>
+		/// The previous opened file will be closed.
+		/// </summary>
+		bool Open( const std::string	&filePath );
+		/// <summary>
+		/// Returns false if failed to open or the file is empty.<para></para>
+		/// The previous opened file will be closed.
+		/// </summary>
+		bool Open( const std::wstring	&filePath );
+		void Close();
+	public:
+		bool IsOpen() const { return ( pView != nullptr ); }
+		const unsigned char	*GetData() const { return static_cast<const unsigned char *>( pView ); }
+		size_t				GetSize() const { return size; }
+	};
+}
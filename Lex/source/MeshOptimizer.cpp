@@ -0,0 +1,296 @@
+#include "MeshOptimizer.h"
+
+#include <array>
+#include <cmath>
+
+#include "Common.h"
+
+namespace Donya
+{
+	namespace MeshOptimizer
+	{
+		VertexCacheStatistics AnalyzeVertexCache( const std::uint32_t *pIndices, size_t indexCount, size_t vertexCount, size_t cacheSize )
+		{
+			VertexCacheStatistics statistics{};
+
+			const size_t triangleCount = indexCount / 3;
+			if ( !triangleCount || !vertexCount ) { return statistics; }
+			// else
+
+			// The vertex is in the cache if it was inserted within the last "cacheSize" insertions.
+			std::vector<size_t> insertedTimes( vertexCount, 0 );
+			size_t missCount = 0;
+			for ( size_t i = 0; i < triangleCount * 3; ++i )
+			{
+				const std::uint32_t vertex = pIndices[i];
+				if ( vertexCount <= vertex ) { continue; }
+				// else
+
+				if ( insertedTimes[vertex] && missCount - insertedTimes[vertex] < cacheSize ) { continue; }
+				// else
+
+				++missCount;
+				insertedTimes[vertex] = missCount;
+			}
+
+			size_t usedVertexCount = 0;
+			for ( const auto &it : insertedTimes )
+			{
+				if ( it ) { ++usedVertexCount; }
+			}
+
+			statistics.acmr = scast<float>( missCount ) / scast<float>( triangleCount );
+			statistics.atvr = ( usedVertexCount ) ? scast<float>( missCount ) / scast<float>( usedVertexCount ) : 0.0f;
+			return statistics;
+		}
+
+	#pragma region VertexCache
+
+		// The parameters of the original article("Linear-Speed Vertex Cache Optimisation", Tom Forsyth).
+		constexpr size_t	FORSYTH_CACHE_SIZE		= 32;
+		constexpr float		CACHE_DECAY_POWER		= 1.5f;
+		constexpr float		LAST_TRIANGLE_SCORE		= 0.75f;
+		constexpr float		VALENCE_BOOST_SCALE		= 2.0f;
+		constexpr float		VALENCE_BOOST_POWER		= 0.5f;
+
+		constexpr std::uint32_t VALENCE_TABLE_SIZE	= 64;
+
+		float CalcCacheScore( int cachePosition )
+		{
+			if ( cachePosition < 0 ) { return 0.0f; }
+			// else
+
+			// The vertices of the last triangle get a fixed score, so the strips do not go back and forth.
+			if ( cachePosition < 3 ) { return LAST_TRIANGLE_SCORE; }
+			// else
+
+			const float scaler = 1.0f / scast<float>( FORSYTH_CACHE_SIZE - 3 );
+			return powf( 1.0f - scast<float>( cachePosition - 3 ) * scaler, CACHE_DECAY_POWER );
+		}
+		float CalcValenceScore( std::uint32_t remainingValence )
+		{
+			// The vertex that has few remaining triangles is preferred, for avoiding the lonely triangles.
+			return VALENCE_BOOST_SCALE * powf( scast<float>( remainingValence ), -VALENCE_BOOST_POWER );
+		}
+
+		float CalcVertexScore( int cachePosition, std::uint32_t remainingValence )
+		{
+			if ( !remainingValence ) { return -1.0f; } // No triangle needs this vertex anymore.
+			// else
+
+			// The powf() is heavy, so the common cases are looked up.
+			static const std::array<float, FORSYTH_CACHE_SIZE> cacheScores = []()
+			{
+				std::array<float, FORSYTH_CACHE_SIZE> table{};
+				for ( size_t i = 0; i < FORSYTH_CACHE_SIZE; ++i )
+				{
+					table[i] = CalcCacheScore( scast<int>( i ) );
+				}
+				return table;
+			}();
+			static const std::array<float, VALENCE_TABLE_SIZE> valenceScores = []()
+			{
+				std::array<float, VALENCE_TABLE_SIZE> table{};
+				for ( std::uint32_t i = 1; i < VALENCE_TABLE_SIZE; ++i )
+				{
+					table[i] = CalcValenceScore( i );
+				}
+				return table;
+			}();
+
+			const float cacheScore		= ( 0 <= cachePosition ) ? cacheScores[cachePosition] : 0.0f;
+			const float valenceScore	= ( remainingValence < VALENCE_TABLE_SIZE ) ? valenceScores[remainingValence] : CalcValenceScore( remainingValence );
+			return cacheScore + valenceScore;
+		}
+
+		void OptimizeVertexCache( std::uint32_t *pIndices, size_t indexCount, size_t vertexCount )
+		{
+			const size_t triangleCount = indexCount / 3;
+			if ( triangleCount < 2 || !vertexCount ) { return; }
+			// else
+
+			for ( size_t i = 0; i < triangleCount * 3; ++i )
+			{
+				if ( vertexCount <= pIndices[i] ) { return; } // Broken indices, keep those.
+			}
+
+			// The triangles that use each vertex, the triangles of vertex[v] are adjacency[adjacencyOffsets[v] ~ adjacencyOffsets[v + 1]).
+			std::vector<std::uint32_t> adjacencyOffsets( vertexCount + 1, 0U );
+			for ( size_t i = 0; i < triangleCount * 3; ++i )
+			{
+				++adjacencyOffsets[pIndices[i] + 1];
+			}
+			for ( size_t v = 0; v < vertexCount; ++v )
+			{
+				adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+			}
+			std::vector<std::uint32_t> adjacency( triangleCount * 3 );
+			{
+				std::vector<std::uint32_t> writePositions( adjacencyOffsets.begin(), adjacencyOffsets.end() - 1 );
+				for ( size_t i = 0; i < triangleCount * 3; ++i )
+				{
+					adjacency[writePositions[pIndices[i]]++] = scast<std::uint32_t>( i / 3 );
+				}
+			}
+
+			std::vector<std::uint32_t>	remainingValences( vertexCount );
+			std::vector<int>			cachePositions( vertexCount, -1 );
+			std::vector<float>			vertexScores( vertexCount );
+			for ( size_t v = 0; v < vertexCount; ++v )
+			{
+				remainingValences[v]	= adjacencyOffsets[v + 1] - adjacencyOffsets[v];
+				vertexScores[v]			= CalcVertexScore( -1, remainingValences[v] );
+			}
+
+			auto CalcTriangleScore = [&]( size_t triangle )
+			{
+				const std::uint32_t *pTriangle = &pIndices[triangle * 3];
+				return vertexScores[pTriangle[0]] + vertexScores[pTriangle[1]] + vertexScores[pTriangle[2]];
+			};
+
+			std::vector<float>	triangleScores( triangleCount );
+			std::vector<char>	isEmitted( triangleCount, 0 );
+			size_t bestTriangle = 0;
+			for ( size_t t = 0; t < triangleCount; ++t )
+			{
+				triangleScores[t] = CalcTriangleScore( t );
+				if ( triangleScores[bestTriangle] < triangleScores[t] ) { bestTriangle = t; }
+			}
+
+			std::vector<std::uint32_t> output{};
+			output.reserve( triangleCount * 3 );
+
+			// The cache is LRU. It can overflow by the 3 vertices of emitted triangle temporarily.
+			std::vector<std::uint32_t> cache{};
+			std::vector<std::uint32_t> nextCache{};
+			cache.reserve( FORSYTH_CACHE_SIZE + 3 );
+			nextCache.reserve( FORSYTH_CACHE_SIZE + 3 );
+
+			size_t fallbackCursor = 0; // The triangles before this are already emitted.
+			while ( output.size() < triangleCount * 3 )
+			{
+				isEmitted[bestTriangle] = 1;
+
+				const std::array<std::uint32_t, 3> triangle
+				{
+					pIndices[bestTriangle * 3 + 0],
+					pIndices[bestTriangle * 3 + 1],
+					pIndices[bestTriangle * 3 + 2]
+				};
+
+				nextCache.clear();
+				for ( const auto &vertex : triangle )
+				{
+					output.emplace_back( vertex );
+
+					// Remove the emitted triangle from the adjacency by swapping with the last remaining one.
+					// The remaining triangles are adjacency[adjacencyOffsets[v] ~ adjacencyOffsets[v] + remainingValences[v]).
+					std::uint32_t *pFirst	= &adjacency[adjacencyOffsets[vertex]];
+					std::uint32_t *pLast	= pFirst + remainingValences[vertex] - 1;
+					for ( std::uint32_t *p = pFirst; p <= pLast; ++p )
+					{
+						if ( *p == bestTriangle )
+						{
+							*p = *pLast;
+							break;
+						}
+					}
+					--remainingValences[vertex];
+
+					if ( cachePositions[vertex] != -2 )
+					{
+						nextCache.emplace_back( vertex );
+						cachePositions[vertex] = -2; // Mark as added to the next cache.
+					}
+				}
+				for ( const auto &vertex : cache )
+				{
+					if ( cachePositions[vertex] != -2 )
+					{
+						nextCache.emplace_back( vertex );
+					}
+				}
+
+				// Update the scores of the vertices that are in(or just evicted from) the cache.
+				for ( size_t i = 0; i < nextCache.size(); ++i )
+				{
+					const std::uint32_t vertex = nextCache[i];
+					cachePositions[vertex]	= ( i < FORSYTH_CACHE_SIZE ) ? scast<int>( i ) : -1;
+					vertexScores[vertex]	= CalcVertexScore( cachePositions[vertex], remainingValences[vertex] );
+				}
+
+				// The next triangle is the best one that uses the cached vertices.
+				bool  isFound	= false;
+				float bestScore	= -1.0f;
+				for ( const auto &vertex : nextCache )
+				{
+					const std::uint32_t end = adjacencyOffsets[vertex] + remainingValences[vertex];
+					for ( std::uint32_t a = adjacencyOffsets[vertex]; a < end; ++a )
+					{
+						const std::uint32_t t = adjacency[a];
+						triangleScores[t] = CalcTriangleScore( t );
+						if ( bestScore < triangleScores[t] )
+						{
+							bestScore		= triangleScores[t];
+							bestTriangle	= t;
+							isFound			= true;
+						}
+					}
+				}
+
+				if ( nextCache.size() > FORSYTH_CACHE_SIZE )
+				{
+					nextCache.resize( FORSYTH_CACHE_SIZE );
+				}
+				cache.swap( nextCache );
+
+				if ( !isFound )
+				{
+					// The cache does not touch any remaining triangle, so restart from the first remaining one.
+					// Searching the best of all is O(n) per restart, it is too slow for the mesh that has many pieces.
+					while ( fallbackCursor < triangleCount && isEmitted[fallbackCursor] )
+					{
+						++fallbackCursor;
+					}
+					if ( triangleCount <= fallbackCursor ) { break; }
+					// else
+					bestTriangle = fallbackCursor;
+				}
+			}
+
+			for ( size_t i = 0; i < output.size(); ++i )
+			{
+				pIndices[i] = output[i];
+			}
+		}
+
+	// region VertexCache
+	#pragma endregion
+
+		size_t OptimizeVertexFetch( std::uint32_t *pIndices, size_t indexCount, size_t vertexCount, std::vector<std::uint32_t> *pRemap )
+		{
+			if ( !pRemap ) { return vertexCount; }
+			// else
+
+			pRemap->assign( vertexCount, UNUSED_VERTEX );
+
+			std::uint32_t nextVertex = 0;
+			for ( size_t i = 0; i < indexCount; ++i )
+			{
+				const std::uint32_t vertex = pIndices[i];
+				if ( vertexCount <= vertex ) { continue; }
+				// else
+
+				std::uint32_t &remapped = ( *pRemap )[vertex];
+				if ( remapped == UNUSED_VERTEX )
+				{
+					remapped = nextVertex++;
+				}
+
+				pIndices[i] = remapped;
+			}
+
+			return nextVertex;
+		}
+	}
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Donya
+{
+	/// <summary>
+	/// The optimizations of triangle list for the GPU. These work on 32-bit indices.
+	/// </summary>
+	namespace MeshOptimizer
+	{
+		constexpr std::uint32_t UNUSED_VERTEX = ~0U;
+
+		struct VertexCacheStatistics
+		{
+			float acmr{};	// Average Cache Miss Ratio, the transformed vertices per triangle. 0.5 is ideal, 3.0 is the worst.
+			float atvr{};	// Average Transformed Vertex Ratio, the transformed vertices per used vertex. 1.0 is ideal.
+		};
+
+		/// <summary>
+		/// Simulates a FIFO post-transform vertex cache that has "cacheSize" entries.
+		/// </summary>
+		VertexCacheStatistics AnalyzeVertexCache( const std::uint32_t *pIndices, size_t indexCount, size_t vertexCount, size_t cacheSize = 16 );
+
+		/// <summary>
+		/// Reorders the triangles for the locality of post-transform vertex cache, by Tom Forsyth's algorithm.<para></para>
+		/// The vertices are not changed. The last incomplete triangle(if indexCount is not a multiple of 3) stays in place.
+		/// </summary>
+		void OptimizeVertexCache( std::uint32_t *pIndices, size_t indexCount, size_t vertexCount );
+
+		/// <summary>
+		/// Decides the new order of vertices by first use in the indices, and rewrites the indices by it.<para></para>
+		/// The "pRemap" receives the new index of each old vertex, the unused vertex is UNUSED_VERTEX.<para></para>
+		/// Returns the new vertex count.
+		/// </summary>
+		size_t OptimizeVertexFetch( std::uint32_t *pIndices, size_t indexCount, size_t vertexCount, std::vector<std::uint32_t> *pRemap );
+
+		/// <summary>
+		/// Makes the vertex array that is reordered by the remap of OptimizeVertexFetch().
+		/// </summary>
+		template<typename Vertex>
+		std::vector<Vertex> RemapVertices( const std::vector<Vertex> &source, const std::vector<std::uint32_t> &remap, size_t newVertexCount )
+		{
+			std::vector<Vertex> remapped( newVertexCount );
+			const size_t end = ( source.size() < remap.size() ) ? source.size() : remap.size();
+			for ( size_t i = 0; i < end; ++i )
+			{
+				if ( remap[i] == UNUSED_VERTEX ) { continue; }
+				// else
+				remapped[remap[i]] = source[i];
+			}
+			return remapped;
+		}
+	}
+}
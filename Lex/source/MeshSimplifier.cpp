@@ -0,0 +1,309 @@
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <unordered_set>
+
+#include "Common.h"
+
+namespace Donya
+{
+	namespace MeshSimplifier
+	{
+		/// <summary>
+		/// The sum of weighted squared distances to planes. It is computed by double, because the terms cancel each other.
+		/// </summary>
+		struct Quadric
+		{
+			double a2{}, b2{}, c2{}, d2{};
+			double ab{}, ac{}, ad{};
+			double bc{}, bd{}, cd{};
+			double weight{};
+		public:
+			void AddPlane( double a, double b, double c, double d, double planeWeight )
+			{
+				a2 += planeWeight * a * a;	b2 += planeWeight * b * b;	c2 += planeWeight * c * c;	d2 += planeWeight * d * d;
+				ab += planeWeight * a * b;	ac += planeWeight * a * c;	ad += planeWeight * a * d;
+				bc += planeWeight * b * c;	bd += planeWeight * b * d;	cd += planeWeight * c * d;
+				weight += planeWeight;
+			}
+			void Add( const Quadric &other )
+			{
+				a2 += other.a2;	b2 += other.b2;	c2 += other.c2;	d2 += other.d2;
+				ab += other.ab;	ac += other.ac;	ad += other.ad;
+				bc += other.bc;	bd += other.bd;	cd += other.cd;
+				weight += other.weight;
+			}
+			/// <summary>
+			/// Returns the root mean square distance from the point to the planes.
+			/// </summary>
+			float CalcError( const Donya::Vector3 &point ) const
+			{
+				if ( weight <= 0.0 ) { return 0.0f; }
+				// else
+
+				const double x = point.x, y = point.y, z = point.z;
+				const double sum =
+					a2 * x * x + b2 * y * y + c2 * z * z + d2
+					+ 2.0 * ( ab * x * y + ac * x * z + ad * x + bc * y * z + bd * y + cd * z );
+				return scast<float>( sqrt( std::max( 0.0, sum ) / weight ) );
+			}
+		};
+
+		struct Collapse
+		{
+			std::uint32_t	from;
+			std::uint32_t	to;
+			float			error;
+		};
+
+		void CalcNormal( const Donya::Vector3 &p0, const Donya::Vector3 &p1, const Donya::Vector3 &p2, double *pOutput )
+		{
+			const double e1[3]{ p1.x - p0.x, p1.y - p0.y, p1.z - p0.z };
+			const double e2[3]{ p2.x - p0.x, p2.y - p0.y, p2.z - p0.z };
+			pOutput[0] = e1[1] * e2[2] - e1[2] * e2[1];
+			pOutput[1] = e1[2] * e2[0] - e1[0] * e2[2];
+			pOutput[2] = e1[0] * e2[1] - e1[1] * e2[0];
+		}
+
+		std::vector<std::uint32_t> Simplify( const std::uint32_t *pIndices, size_t indexCount, const Donya::Vector3 *pPositions, size_t vertexCount, const std::uint8_t *pLocks, size_t targetIndexCount, float targetError, float *pResultError )
+		{
+			if ( pResultError ) { *pResultError = 0.0f; }
+
+			std::vector<std::uint32_t> indices( pIndices, pIndices + ( indexCount / 3 ) * 3 );
+			for ( const auto &it : indices )
+			{
+				if ( vertexCount <= it ) { return indices; } // Broken indices, keep those.
+			}
+
+			// The quadric of each vertex is the sum of the planes of triangles around it, weighted by the area.
+			std::vector<Quadric> quadrics( vertexCount );
+			for ( size_t i = 0; i < indices.size(); i += 3 )
+			{
+				const std::uint32_t *pTriangle = &indices[i];
+
+				double normal[3]{};
+				CalcNormal( pPositions[pTriangle[0]], pPositions[pTriangle[1]], pPositions[pTriangle[2]], normal );
+				const double length = sqrt( normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2] );
+				if ( length <= 0.0 ) { continue; }
+				// else
+
+				const double a = normal[0] / length;
+				const double b = normal[1] / length;
+				const double c = normal[2] / length;
+				const Donya::Vector3 &p0 = pPositions[pTriangle[0]];
+				const double d = -( a * p0.x + b * p0.y + c * p0.z );
+				const double area = length * 0.5;
+				for ( size_t k = 0; k < 3; ++k )
+				{
+					quadrics[pTriangle[k]].AddPlane( a, b, c, d, area );
+				}
+			}
+
+			// The vertices on the border are locked. The border edge is used by only one triangle.
+			std::vector<std::uint8_t> locks( vertexCount, 0 );
+			if ( pLocks )
+			{
+				locks.assign( pLocks, pLocks + vertexCount );
+			}
+			{
+				auto MakeEdgeKey = []( std::uint32_t a, std::uint32_t b )
+				{
+					return ( a < b )
+					? ( scast<std::uint64_t>( a ) << 32 ) | b
+					: ( scast<std::uint64_t>( b ) << 32 ) | a;
+				};
+
+				std::unordered_set<std::uint64_t> oddEdges{};
+				oddEdges.reserve( indices.size() );
+				for ( size_t i = 0; i < indices.size(); i += 3 )
+				{
+					for ( size_t k = 0; k < 3; ++k )
+					{
+						const std::uint64_t key = MakeEdgeKey( indices[i + k], indices[i + ( k + 1 ) % 3] );
+						// The edge that is used twice is cancelled. The non-manifold edge(used three times or more) may remain, it is also locked.
+						if ( !oddEdges.erase( key ) ) { oddEdges.insert( key ); }
+					}
+				}
+				for ( const auto &key : oddEdges )
+				{
+					locks[scast<std::uint32_t>( key >> 32 )]			= 1;
+					locks[scast<std::uint32_t>( key & 0xFFFFFFFFULL )]	= 1;
+				}
+			}
+
+			std::vector<std::uint32_t>	adjacencyOffsets( vertexCount + 1 );
+			std::vector<std::uint32_t>	adjacency{};
+			std::vector<Collapse>		collapses{};
+			std::vector<Collapse>		bestCollapses( vertexCount );
+			std::vector<std::uint32_t>	remap( vertexCount );
+			std::vector<std::uint8_t>	isTouched( vertexCount );
+
+			// The max distance from the removed vertices that were collapsed into each vertex, to the surface around it.
+			// The quadric gives the RMS distance only, so it is used to order the collapses, and this is used as the error.
+			std::vector<float>			vertexErrors( vertexCount, 0.0f );
+
+			float resultError = 0.0f;
+
+			// Collapse the cheapest edges that are independent of each other per pass, then rebuild the triangles.
+			while ( targetIndexCount < indices.size() )
+			{
+				// The triangles around each vertex.
+				std::fill( adjacencyOffsets.begin(), adjacencyOffsets.end(), 0U );
+				for ( const auto &it : indices )
+				{
+					++adjacencyOffsets[it + 1];
+				}
+				for ( size_t v = 0; v < vertexCount; ++v )
+				{
+					adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+				}
+				adjacency.resize( indices.size() );
+				{
+					std::vector<std::uint32_t> writePositions( adjacencyOffsets.begin(), adjacencyOffsets.end() - 1 );
+					for ( size_t i = 0; i < indices.size(); ++i )
+					{
+						adjacency[writePositions[indices[i]]++] = scast<std::uint32_t>( i / 3 );
+					}
+				}
+
+				// Only the cheapest collapse of each vertex is a candidate.
+				std::fill( bestCollapses.begin(), bestCollapses.end(), Collapse{ 0U, 0U, HUGE_VALF } );
+				auto Consider = [&]( std::uint32_t from, std::uint32_t to )
+				{
+					if ( locks[from] ) { return; }
+					// else
+					const float error = quadrics[from].CalcError( pPositions[to] );
+					if ( error < bestCollapses[from].error ) { bestCollapses[from] = Collapse{ from, to, error }; }
+				};
+				for ( size_t i = 0; i < indices.size(); i += 3 )
+				{
+					for ( size_t k = 0; k < 3; ++k )
+					{
+						const std::uint32_t a = indices[i + k];
+						const std::uint32_t b = indices[i + ( k + 1 ) % 3];
+						Consider( a, b );
+						Consider( b, a );
+					}
+				}
+				collapses.clear();
+				for ( const auto &it : bestCollapses )
+				{
+					if ( it.error <= targetError ) { collapses.emplace_back( it ); }
+				}
+				std::sort
+				(
+					collapses.begin(), collapses.end(),
+					[]( const Collapse &lhs, const Collapse &rhs ) { return lhs.error < rhs.error; }
+				);
+
+				for ( size_t v = 0; v < vertexCount; ++v )
+				{
+					remap[v] = scast<std::uint32_t>( v );
+				}
+				std::fill( isTouched.begin(), isTouched.end(), scast<std::uint8_t>( 0 ) );
+
+				// A collapse removes two triangles on the manifold.
+				size_t estimatedIndexCount	= indices.size();
+				size_t collapsedCount		= 0;
+				for ( const auto &collapse : collapses )
+				{
+					if ( targetError < collapse.error ) { break; } // These are sorted.
+					if ( estimatedIndexCount <= targetIndexCount ) { break; }
+					// else
+
+					const std::uint32_t from	= collapse.from;
+					const std::uint32_t to		= collapse.to;
+					if ( isTouched[from] || isTouched[to] ) { continue; }
+					// else
+
+					// The collapse must not flip the triangles around.
+					// The error of it is the max distance from the "from" to the planes of the moved triangles.
+					bool	isFlipped		= false;
+					double	maxDistance		= 0.0;
+					for ( std::uint32_t a = adjacencyOffsets[from]; a < adjacencyOffsets[from + 1]; ++a )
+					{
+						const std::uint32_t *pTriangle = &indices[adjacency[a] * 3];
+						if ( pTriangle[0] == to || pTriangle[1] == to || pTriangle[2] == to ) { continue; } // It will be removed.
+						// else
+
+						std::array<Donya::Vector3, 3> moved{ pPositions[pTriangle[0]], pPositions[pTriangle[1]], pPositions[pTriangle[2]] };
+						for ( size_t k = 0; k < 3; ++k )
+						{
+							if ( pTriangle[k] == from ) { moved[k] = pPositions[to]; }
+						}
+
+						double before[3]{};
+						double after[3]{};
+						CalcNormal( pPositions[pTriangle[0]], pPositions[pTriangle[1]], pPositions[pTriangle[2]], before );
+						CalcNormal( moved[0], moved[1], moved[2], after );
+						if ( before[0] * after[0] + before[1] * after[1] + before[2] * after[2] <= 0.0 )
+						{
+							isFlipped = true;
+							break;
+						}
+
+						const double length = sqrt( after[0] * after[0] + after[1] * after[1] + after[2] * after[2] );
+						if ( length <= 0.0 ) { continue; }
+						// else
+
+						const Donya::Vector3 &p = pPositions[from];
+						const double distance = fabs
+						(
+							after[0] * ( p.x - moved[0].x ) +
+							after[1] * ( p.y - moved[0].y ) +
+							after[2] * ( p.z - moved[0].z )
+						) / length;
+						maxDistance = std::max( maxDistance, distance );
+					}
+					if ( isFlipped ) { continue; }
+					// else
+
+					const float collapseError = vertexErrors[from] + scast<float>( maxDistance );
+					if ( targetError < collapseError ) { continue; }
+					// else
+
+					// The triangles around the "from" will be changed, so those are not touched again in this pass.
+					for ( std::uint32_t a = adjacencyOffsets[from]; a < adjacencyOffsets[from + 1]; ++a )
+					{
+						const std::uint32_t *pTriangle = &indices[adjacency[a] * 3];
+						isTouched[pTriangle[0]] = 1;
+						isTouched[pTriangle[1]] = 1;
+						isTouched[pTriangle[2]] = 1;
+					}
+
+					remap[from] = to;
+					quadrics[to].Add( quadrics[from] );
+					vertexErrors[to] = std::max( vertexErrors[to], collapseError );
+					resultError = std::max( resultError, collapseError );
+
+					estimatedIndexCount = ( 6 < estimatedIndexCount ) ? estimatedIndexCount - 6 : 0;
+					++collapsedCount;
+				}
+
+				if ( !collapsedCount ) { break; }
+				// else
+
+				// Remove the degenerated triangles.
+				size_t writeIndex = 0;
+				for ( size_t i = 0; i < indices.size(); i += 3 )
+				{
+					const std::uint32_t a = remap[indices[i + 0]];
+					const std::uint32_t b = remap[indices[i + 1]];
+					const std::uint32_t c = remap[indices[i + 2]];
+					if ( a == b || b == c || c == a ) { continue; }
+					// else
+
+					indices[writeIndex++] = a;
+					indices[writeIndex++] = b;
+					indices[writeIndex++] = c;
+				}
+				indices.resize( writeIndex );
+			}
+
+			if ( pResultError ) { *pResultError = resultError; }
+			return indices;
+		}
+	}
+}
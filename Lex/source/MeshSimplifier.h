@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Vector.h"
+
+namespace Donya
+{
+	/// <summary>
+	/// The simplification of triangle list by the quadric error metric(Garland and Heckbert).<para></para>
+	/// It collapses a vertex into a neighbor vertex(half-edge collapse), so the vertices are not changed.
+	/// The simplified indices refer to the same vertex buffer as the source.
+	/// </summary>
+	namespace MeshSimplifier
+	{
+		/// <summary>
+		/// Simplifies until the index count is less than or equal to "targetIndexCount", or the next collapse exceeds the "targetError".<para></para>
+		/// The "targetError" and the "pResultError" are the distance in the unit of positions.
+		/// The error is the max distance from a removed vertex to the planes of the triangles that replaced it, accumulated through the collapses into the same vertex.<para></para>
+		/// The vertex that pLocks[v] is not zero, and the vertex on the border(an edge that is used by only one triangle) are never removed,
+		/// so the border of the mesh(e.g. the boundary of materials) is kept intact.<para></para>
+		/// The "pLocks" and the "pResultError" can set nullptr.
+		/// </summary>
+		std::vector<std::uint32_t> Simplify
+		(
+			const std::uint32_t *pIndices, size_t indexCount,
+			const Donya::Vector3 *pPositions, size_t vertexCount,
+			const std::uint8_t *pLocks,
+			size_t targetIndexCount, float targetError,
+			float *pResultError
+		);
+	}
+}
@@ -0,0 +1,291 @@
+#include "NativeMesh.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include "Common.h"
+
+namespace Donya
+{
+	namespace NativeMesh
+	{
+		size_t AlignUp( size_t value, size_t alignment )
+		{
+			return ( value + alignment - 1 ) / alignment * alignment;
+		}
+
+		bool IsLessEntry( const ChunkEntry &L, std::uint32_t kind, std::uint32_t meshIndex )
+		{
+			if ( L.meshIndex != meshIndex ) { return L.meshIndex < meshIndex; }
+			// else
+			return L.kind < kind;
+		}
+
+	#pragma region Writer
+
+		void Writer::AddChunk( ChunkKind kind, size_t meshIndex, const void *pData, size_t elementSize, size_t elementCount )
+		{
+			PendingChunk chunk{};
+			chunk.entry.kind			= scast<std::uint32_t>( kind );
+			chunk.entry.meshIndex		= scast<std::uint32_t>( meshIndex );
+			chunk.entry.offset			= 0; // Will be decided at Save().
+			chunk.entry.byteSize		= scast<std::uint64_t>( elementSize ) * elementCount;
+			chunk.entry.elementCount	= elementCount;
+			chunk.pData					= pData;
+
+			chunks.emplace_back( chunk );
+		}
+		void Writer::AddCopiedChunk( ChunkKind kind, size_t meshIndex, const void *pData, size_t elementSize, size_t elementCount )
+		{
+			const size_t byteSize = elementSize * elementCount;
+
+			ownedBlobs.emplace_back( byteSize );
+			if ( byteSize )
+			{
+				memcpy( ownedBlobs.back().data(), pData, byteSize );
+			}
+
+			AddChunk( kind, meshIndex, ownedBlobs.back().data(), elementSize, elementCount );
+		}
+		void Writer::AddStrings( ChunkKind kind, size_t meshIndex, const std::vector<std::string> &strings )
+		{
+			size_t byteSize = 0;
+			for ( const auto &it : strings )
+			{
+				byteSize += sizeof( std::uint32_t ) + it.size();
+			}
+
+			ownedBlobs.emplace_back( byteSize );
+			char *pWrite = ownedBlobs.back().data();
+			for ( const auto &it : strings )
+			{
+				const std::uint32_t length = scast<std::uint32_t>( it.size() );
+				memcpy( pWrite, &length, sizeof( std::uint32_t ) );
+				pWrite += sizeof( std::uint32_t );
+
+				memcpy( pWrite, it.data(), it.size() );
+				pWrite += it.size();
+			}
+
+			PendingChunk chunk{};
+			chunk.entry.kind			= scast<std::uint32_t>( kind );
+			chunk.entry.meshIndex		= scast<std::uint32_t>( meshIndex );
+			chunk.entry.offset			= 0; // Will be decided at Save().
+			chunk.entry.byteSize		= byteSize;
+			chunk.entry.elementCount	= strings.size();
+			chunk.pData					= ownedBlobs.back().data();
+
+			chunks.emplace_back( chunk );
+		}
+
+		bool Writer::Save( const std::string &filePath, std::string *outputErrorString ) const
+		{
+			// The table is sorted, so the Reader can find a chunk by binary-search.
+			std::vector<PendingChunk> sorted = chunks;
+			std::stable_sort
+			(
+				sorted.begin(), sorted.end(),
+				[]( const PendingChunk &L, const PendingChunk &R )
+				{
+					return IsLessEntry( L.entry, R.entry.kind, R.entry.meshIndex );
+				}
+			);
+
+			// Decide the offsets.
+			size_t offset = AlignUp( sizeof( Header ), ALIGNMENT );
+			for ( auto &it : sorted )
+			{
+				it.entry.offset = offset;
+				offset = AlignUp( offset + scast<size_t>( it.entry.byteSize ), ALIGNMENT );
+			}
+
+			Header header{};
+			header.magic			= MAGIC;
+			header.version			= VERSION;
+			header.meshCount		= meshCount;
+			header.chunkCount		= scast<std::uint32_t>( sorted.size() );
+			header.chunkTableOffset	= offset;
+			header.fileSize			= offset + sizeof( ChunkEntry ) * sorted.size();
+
+			FILE *fp = nullptr;
+			fopen_s( &fp, filePath.c_str(), "wb" );
+			if ( !fp )
+			{
+				if ( outputErrorString != nullptr )
+				{
+					*outputErrorString = "Failed : Open the file for writing : " + filePath;
+				}
+				return false;
+			}
+			// else
+
+			const char padding[ALIGNMENT]{};
+			auto WritePadding = [&]( size_t currentPos )
+			{
+				const size_t paddingSize = AlignUp( currentPos, ALIGNMENT ) - currentPos;
+				if ( paddingSize )
+				{
+					fwrite( padding, 1, paddingSize, fp );
+				}
+			};
+
+			bool succeeded = true;
+
+			succeeded &= ( fwrite( &header, sizeof( Header ), 1, fp ) == 1 );
+			WritePadding( sizeof( Header ) );
+
+			for ( const auto &it : sorted )
+			{
+				const size_t byteSize = scast<size_t>( it.entry.byteSize );
+				if ( byteSize )
+				{
+					succeeded &= ( fwrite( it.pData, 1, byteSize, fp ) == byteSize );
+				}
+				WritePadding( scast<size_t>( it.entry.offset ) + byteSize );
+			}
+
+			for ( const auto &it : sorted )
+			{
+				succeeded &= ( fwrite( &it.entry, sizeof( ChunkEntry ), 1, fp ) == 1 );
+			}
+
+			succeeded &= ( fclose( fp ) == 0 );
+
+			if ( !succeeded && outputErrorString != nullptr )
+			{
+				*outputErrorString = "Failed : Write the file : " + filePath;
+			}
+
+			return succeeded;
+		}
+
+	// region Writer
+	#pragma endregion
+
+	#pragma region Reader
+
+		bool Reader::Open( const std::string &filePath, std::string *outputErrorString )
+		{
+			pHeader = nullptr;
+			pChunks = nullptr;
+
+			auto Fail = [&]( const char *message )
+			{
+				if ( outputErrorString != nullptr )
+				{
+					*outputErrorString = message;
+				}
+
+				pHeader = nullptr;
+				pChunks = nullptr;
+				file.Close();
+				return false;
+			};
+
+			if ( !file.Open( filePath ) ) { return Fail( "Failed : Open the native mesh file." ); }
+			// else
+
+			const unsigned char	*pData		= file.GetData();
+			const size_t		fileSize	= file.GetSize();
+			if ( fileSize < sizeof( Header ) ) { return Fail( "Failed : The native mesh file is too small." ); }
+			// else
+
+			const Header *pFileHeader = reinterpret_cast<const Header *>( pData );
+			if ( pFileHeader->magic		!= MAGIC	) { return Fail( "Failed : It is not a native mesh file." ); }
+			if ( pFileHeader->version < OLDEST_READABLE_VERSION || VERSION < pFileHeader->version )
+			{
+				return Fail( "Failed : The version of native mesh file is not supported." );
+			}
+
+			if ( pFileHeader->fileSize	!= fileSize	) { return Fail( "Failed : The native mesh file is broken(size mismatch)." ); }
+			// else
+
+			const std::uint64_t tableSize = sizeof( ChunkEntry ) * scast<std::uint64_t>( pFileHeader->chunkCount );
+			if ( fileSize < pFileHeader->chunkTableOffset || fileSize - pFileHeader->chunkTableOffset < tableSize )
+			{
+				return Fail( "Failed : The native mesh file is broken(chunk table)." );
+			}
+			if ( pFileHeader->chunkTableOffset % ALIGNMENT )
+			{
+				return Fail( "Failed : The native mesh file is broken(chunk table alignment)." );
+			}
+			// else
+
+			const ChunkEntry *pTable = reinterpret_cast<const ChunkEntry *>( pData + pFileHeader->chunkTableOffset );
+			for ( std::uint32_t i = 0; i < pFileHeader->chunkCount; ++i )
+			{
+				const ChunkEntry &entry = pTable[i];
+				if ( entry.offset % ALIGNMENT || fileSize < entry.offset || fileSize - entry.offset < entry.byteSize )
+				{
+					return Fail( "Failed : The native mesh file is broken(chunk range)." );
+				}
+				if ( i && IsLessEntry( entry, pTable[i - 1].kind, pTable[i - 1].meshIndex ) )
+				{
+					return Fail( "Failed : The native mesh file is broken(chunk order)." );
+				}
+			}
+
+			pHeader = pFileHeader;
+			pChunks = pTable;
+			return true;
+		}
+
+		const ChunkEntry *Reader::FindChunk( ChunkKind kind, size_t meshIndex ) const
+		{
+			if ( !pHeader ) { return nullptr; }
+			// else
+
+			const std::uint32_t searchKind	= scast<std::uint32_t>( kind );
+			const std::uint32_t searchMesh	= scast<std::uint32_t>( meshIndex );
+			const ChunkEntry	*pEnd		= pChunks + pHeader->chunkCount;
+
+			const ChunkEntry *pFound = std::lower_bound
+			(
+				pChunks, pEnd, searchKind,
+				[&searchMesh]( const ChunkEntry &entry, std::uint32_t kind )
+				{
+					return IsLessEntry( entry, kind, searchMesh );
+				}
+			);
+
+			if ( pFound == pEnd ) { return nullptr; }
+			if ( pFound->kind != searchKind || pFound->meshIndex != searchMesh ) { return nullptr; }
+			// else
+			return pFound;
+		}
+
+		std::vector<std::string> Reader::ReadStrings( ChunkKind kind, size_t meshIndex ) const
+		{
+			const ChunkEntry *pEntry = FindChunk( kind, meshIndex );
+			if ( !pEntry ) { return std::vector<std::string>{}; }
+			// else
+
+			const unsigned char *pRead	= file.GetData() + pEntry->offset;
+			const unsigned char *pEnd	= pRead + pEntry->byteSize;
+
+			std::vector<std::string> strings{};
+			strings.reserve( scast<size_t>( pEntry->elementCount ) );
+			for ( std::uint64_t i = 0; i < pEntry->elementCount; ++i )
+			{
+				if ( scast<size_t>( pEnd - pRead ) < sizeof( std::uint32_t ) ) { return std::vector<std::string>{}; }
+				// else
+
+				std::uint32_t length{};
+				memcpy( &length, pRead, sizeof( std::uint32_t ) );
+				pRead += sizeof( std::uint32_t );
+
+				if ( scast<size_t>( pEnd - pRead ) < length ) { return std::vector<std::string>{}; }
+				// else
+
+				strings.emplace_back( reinterpret_cast<const char *>( pRead ), length );
+				pRead += length;
+			}
+
+			return strings;
+		}
+
+	// region Reader
+	#pragma endregion
+	}
+}
@@ -0,0 +1,251 @@
+#pragma once
+
+#include <cstdint>
+#include <DirectXMath.h>
+#include <string>
+#include <vector>
+
+#include "ArrayView.h"
+#include "MappedFile.h"
+
+namespace Donya
+{
+	/// <summary>
+	/// The native binary container of mesh data. It is designed to be used by memory-mapping.<para></para>
+	/// Layout:<para></para>
+	/// [Header][Chunk blobs(each is aligned by ALIGNMENT)][Chunk table(sorted by meshIndex, kind)]<para></para>
+	/// The blobs are raw arrays of the element, so those can be viewed without any copy.
+	/// </summary>
+	namespace NativeMesh
+	{
+		constexpr std::uint32_t MAGIC					= 0x4D58454C;	// "LEXM" in little-endian.
+		constexpr std::uint32_t VERSION					= 9;
+		constexpr std::uint32_t OLDEST_READABLE_VERSION	= 1;			// The newer versions only add the chunk kinds.
+		constexpr size_t		ALIGNMENT				= 16;
+
+		/// <summary>
+		/// Do not change the values of existing kinds, these are saved in the file.
+		/// </summary>
+		enum class ChunkKind : std::uint32_t
+		{
+			FileInfo			= 0,	// Strings: absFilePath, fileName, fileDirectory. The meshIndex is zero.
+			Transform			= 1,	// TransformRecord.
+			Subsets				= 2,	// SubsetRecord.
+			TextureNames		= 3,	// Strings, referenced from SubsetRecord::MaterialRecord.
+			Indices				= 4,	// std::uint32_t. Only one of Indices and Indices16 exists per mesh.
+			Positions			= 5,	// Donya::Vector3.
+			Normals				= 6,	// Donya::Vector3.
+			TexCoords			= 7,	// Donya::Vector2.
+			InfluenceOffsets	= 8,	// std::uint32_t, vertex-count + 1.
+			InfluenceEntries	= 9,	// Loader::BoneInfluence.
+			Indices16			= 10,	// std::uint16_t. Since version 2.
+			// The quantized attributes are stored instead of Positions, Normals, TexCoords. Since version 3.
+			PositionFrame		= 11,	// VertexQuantization::PositionFrame. Exists with PositionsUnorm16.
+			PositionsUnorm16	= 12,	// VertexQuantization::QuantizedPosition.
+			NormalsOct8			= 13,	// VertexQuantization::OctahedralNormal8.
+			NormalsOct16		= 14,	// VertexQuantization::OctahedralNormal16.
+			TexCoordsHalf		= 15,	// VertexQuantization::HalfTexCoord.
+			QuantizationReport	= 16,	// VertexQuantization::Report. Exists if the quantization was enabled at save.
+			// The simplified levels. The indices of those are stored after the subsets in Indices(or Indices16). Since version 4.
+			LODErrors			= 17,	// float, per level.
+			LODRanges			= 18,	// Loader::IndexRange, level-count * subset-count.
+			MeshBounds			= 19,	// Loader::Bounds. Since version 5.
+			SubsetBounds		= 20,	// Loader::Bounds, per subset.
+			// The skeleton and the animation clips. Those are shared by the meshes, so the meshIndex is zero except BoneBindings. Since version 6.
+			BoneBindings		= 21,	// Loader::BoneBinding, per influence index.
+			BoneNames			= 22,	// Strings, per bone.
+			Bones				= 23,	// BoneRecord.
+			ClipNames			= 24,	// Strings, per clip.
+			Clips				= 25,	// ClipRecord.
+			Tracks				= 26,	// TrackRecord, bone-count per clip.
+			ScaleKeys			= 27,	// Donya::Vector3, referenced from TrackRecord.
+			RotationKeys		= 28,	// Donya::Vector4, referenced from TrackRecord.
+			TranslationKeys		= 29,	// Donya::Vector3, referenced from TrackRecord.
+			// The compressed clips are stored instead of Clips, Tracks and the keys, the ClipNames is shared. Since version 7.
+			// The meshIndex of these is the index of clip.
+			CompressedClip			= 30,	// CompressedClipRecord, one per clip.
+			CompressedTracks		= 31,	// AnimationCompression::CompressedTrack, bone-count.
+			ScaleFrames				= 32,	// std::uint16_t, parallel to ScaleKeysUnorm16.
+			ScaleKeysUnorm16		= 33,	// VertexQuantization::QuantizedPosition.
+			RotationFrames			= 34,	// std::uint16_t, parallel to RotationKeysSmallest3.
+			RotationKeysSmallest3	= 35,	// AnimationCompression::QuantizedRotation.
+			TranslationFrames		= 36,	// std::uint16_t, parallel to TranslationKeysUnorm16.
+			TranslationKeysUnorm16	= 37,	// VertexQuantization::QuantizedPosition.
+			// The channels that are not quantized. Since version 8, the older files have only the quantized channels.
+			TrackEncodings			= 38,	// AnimationCompression::TrackEncoding, bone-count.
+			ScaleKeysFloat32		= 39,	// Donya::Vector3, referenced from the Float32 channels.
+			RotationKeysFloat32		= 40,	// Donya::Vector4.
+			TranslationKeysFloat32	= 41,	// Donya::Vector3.
+			OptimizationStatistics	= 42,	// Loader::OptimizationStatistics. Exists if the vertex cache was optimized at the import. Since version 9.
+		};
+
+	#pragma region Records
+
+		struct Header
+		{
+			std::uint32_t magic;
+			std::uint32_t version;
+			std::uint32_t meshCount;
+			std::uint32_t chunkCount;
+			std::uint64_t chunkTableOffset;
+			std::uint64_t fileSize;
+		};
+		struct ChunkEntry
+		{
+			std::uint32_t kind;
+			std::uint32_t meshIndex;
+			std::uint64_t offset;
+			std::uint64_t byteSize;
+			std::uint64_t elementCount;
+		};
+
+		struct TransformRecord
+		{
+			DirectX::XMFLOAT4X4 coordinateConversion;
+			DirectX::XMFLOAT4X4 globalTransform;
+		};
+		struct MaterialRecord
+		{
+			float			color[4];
+			std::uint32_t	textureBegin;	// The index of TextureNames chunk.
+			std::uint32_t	textureCount;
+		};
+		struct SubsetRecord
+		{
+			std::uint32_t	indexStart;
+			std::uint32_t	indexCount;
+			float			reflection;
+			float			transparency;
+			MaterialRecord	ambient;
+			MaterialRecord	bump;
+			MaterialRecord	diffuse;
+			MaterialRecord	emissive;
+			MaterialRecord	specular;
+		};
+
+		struct BoneRecord
+		{
+			std::int32_t	parent;
+			float			scale[3];
+			float			rotation[4];
+			float			translation[3];
+		};
+		struct ClipRecord
+		{
+			float			samplingRate;
+			float			duration;
+			std::uint32_t	trackBegin;		// The index of Tracks chunk.
+			std::uint32_t	trackCount;
+		};
+		struct TrackRecord
+		{
+			std::uint32_t	scaleBegin;
+			std::uint32_t	scaleCount;
+			std::uint32_t	rotationBegin;
+			std::uint32_t	rotationCount;
+			std::uint32_t	translationBegin;
+			std::uint32_t	translationCount;
+		};
+		struct CompressedClipRecord
+		{
+			float			samplingRate;
+			float			duration;
+			std::uint32_t	frameCount;
+			std::uint32_t	sourceKeyCount;
+			float			rotationError;
+			float			translationError;
+			float			scaleError;
+		};
+
+	// region Records
+	#pragma endregion
+
+		/// <summary>
+		/// Collects the chunks, then writes those at Save().<para></para>
+		/// The AddChunk() does not copy the data, so the data must be alive until Save().
+		/// </summary>
+		class Writer
+		{
+		private:
+			struct PendingChunk
+			{
+				ChunkEntry	entry;
+				const void	*pData;
+			};
+		private:
+			std::uint32_t						meshCount;
+			std::vector<PendingChunk>			chunks;
+			std::vector<std::vector<char>>		ownedBlobs;	// The storage of data that made by Writer.
+		public:
+			Writer( size_t meshCount ) : meshCount( static_cast<std::uint32_t>( meshCount ) ), chunks(), ownedBlobs() {}
+		public:
+			void AddChunk( ChunkKind kind, size_t meshIndex, const void *pData, size_t elementSize, size_t elementCount );
+			template<typename T>
+			void AddChunk( ChunkKind kind, size_t meshIndex, const ArrayView<T> &elements )
+			{
+				AddChunk( kind, meshIndex, elements.data(), sizeof( T ), elements.size() );
+			}
+			/// <summary>
+			/// This copies the data, so the source is not need to be alive until Save().
+			/// </summary>
+			void AddCopiedChunk( ChunkKind kind, size_t meshIndex, const void *pData, size_t elementSize, size_t elementCount );
+			/// <summary>
+			/// Each string is stored as [std::uint32_t length][characters].
+			/// </summary>
+			void AddStrings( ChunkKind kind, size_t meshIndex, const std::vector<std::string> &strings );
+		public:
+			/// <summary>
+			/// The "outputErrorString" can set nullptr.
+			/// </summary>
+			bool Save( const std::string &filePath, std::string *outputErrorString ) const;
+		};
+
+		/// <summary>
+		/// Maps the file, and validates the header and the chunk table at Open().<para></para>
+		/// The views are valid while this is alive.
+		/// </summary>
+		class Reader
+		{
+		private:
+			MappedFile			file;
+			const Header		*pHeader;
+			const ChunkEntry	*pChunks;
+		public:
+			Reader() : file(), pHeader( nullptr ), pChunks( nullptr ) {}
+			Reader( const Reader & ) = delete;
+			Reader &operator = ( const Reader & ) = delete;
+		public:
+			/// <summary>
+			/// The "outputErrorString" can set nullptr.
+			/// </summary>
+			bool Open( const std::string &filePath, std::string *outputErrorString );
+		public:
+			size_t GetMeshCount() const { return ( pHeader ) ? pHeader->meshCount : 0; }
+			/// <summary>
+			/// Returns nullptr if not found.
+			/// </summary>
+			const ChunkEntry *FindChunk( ChunkKind kind, size_t meshIndex ) const;
+			/// <summary>
+			/// Returns empty view if not found or the element size is mismatched.
+			/// </summary>
+			template<typename T>
+			ArrayView<T> View( ChunkKind kind, size_t meshIndex ) const
+			{
+				const ChunkEntry *pEntry = FindChunk( kind, meshIndex );
+				if ( !pEntry ) { return ArrayView<T>{}; }
+				if ( pEntry->byteSize != pEntry->elementCount * sizeof( T ) ) { return ArrayView<T>{}; }
+				// else
+
+				return ArrayView<T>
+				{
+					reinterpret_cast<const T *>( file.GetData() + pEntry->offset ),
+					static_cast<size_t>( pEntry->elementCount )
+				};
+			}
+			/// <summary>
+			/// Returns empty vector if not found or broken.
+			/// </summary>
+			std::vector<std::string> ReadStrings( ChunkKind kind, size_t meshIndex ) const;
+		};
+	}
+}
@@ -211,8 +211,8 @@ namespace Donya
 
 		std::array<float, 4> elements{};
 		elements[0] = M._11 - M._22 - M._33 + 1.0f;
-		elements[1] = M._11 + M._22 - M._33 + 1.0f;
-		elements[2] = M._11 - M._22 + M._33 + 1.0f;
+		elements[1] = -M._11 + M._22 - M._33 + 1.0f;
+		elements[2] = -M._11 - M._22 + M._33 + 1.0f;
 		elements[3] = M._11 + M._22 + M._33 + 1.0f;
 
 		size_t biggestIndex = 0;
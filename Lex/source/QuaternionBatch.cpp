@@ -0,0 +1,508 @@
+#include "QuaternionBatch.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <immintrin.h>
+
+#include "CPUFeatures.h"
+
+namespace Donya
+{
+	namespace QuaternionBatch
+	{
+		void QuaternionArray::Resize( size_t count )
+		{
+			x.resize( count );
+			y.resize( count );
+			z.resize( count );
+			w.resize( count );
+		}
+		void QuaternionArray::Assign( const Donya::Quaternion *pSource, size_t count )
+		{
+			Resize( count );
+			for ( size_t i = 0; i < count; ++i )
+			{
+				x[i] = pSource[i].x;
+				y[i] = pSource[i].y;
+				z[i] = pSource[i].z;
+				w[i] = pSource[i].w;
+			}
+		}
+		void QuaternionArray::CopyTo( Donya::Quaternion *pOutput ) const
+		{
+			const size_t count = Size();
+			for ( size_t i = 0; i < count; ++i )
+			{
+				pOutput[i] = Donya::Quaternion{ x[i], y[i], z[i], w[i] };
+			}
+		}
+		Quaternions QuaternionArray::View()
+		{
+			return Quaternions{ x.data(), y.data(), z.data(), w.data() };
+		}
+		ConstQuaternions QuaternionArray::View() const
+		{
+			return ConstQuaternions{ x.data(), y.data(), z.data(), w.data() };
+		}
+
+		void VectorArray::Resize( size_t count )
+		{
+			x.resize( count );
+			y.resize( count );
+			z.resize( count );
+		}
+		void VectorArray::Assign( const Donya::Vector3 *pSource, size_t count )
+		{
+			Resize( count );
+			for ( size_t i = 0; i < count; ++i )
+			{
+				x[i] = pSource[i].x;
+				y[i] = pSource[i].y;
+				z[i] = pSource[i].z;
+			}
+		}
+		void VectorArray::CopyTo( Donya::Vector3 *pOutput ) const
+		{
+			const size_t count = Size();
+			for ( size_t i = 0; i < count; ++i )
+			{
+				pOutput[i] = Donya::Vector3{ x[i], y[i], z[i] };
+			}
+		}
+		Vectors VectorArray::View()
+		{
+			return Vectors{ x.data(), y.data(), z.data() };
+		}
+		ConstVectors VectorArray::View() const
+		{
+			return ConstVectors{ x.data(), y.data(), z.data() };
+		}
+
+	#pragma region Lanes
+
+		/// <summary>
+		/// The kernels are written once by the operations of these, the "Type" has a float per lane.<para></para>
+		/// The "Mask" is the result of comparisons, that is used by the Select().
+		/// </summary>
+		struct ScalarLanes
+		{
+			using Type = float;
+			using Mask = bool;
+			static constexpr size_t WIDTH = 1;
+
+			static Type Load( const float *p )				{ return *p; }
+			static void Store( float *p, Type v )			{ *p = v; }
+			static Type Set( float v )						{ return v; }
+			static Type Add( Type L, Type R )				{ return L + R; }
+			static Type Sub( Type L, Type R )				{ return L - R; }
+			static Type Mul( Type L, Type R )				{ return L * R; }
+			static Type Div( Type L, Type R )				{ return L / R; }
+			/// <summary>
+			/// Returns "A * B + C".
+			/// </summary>
+			static Type MulAdd( Type A, Type B, Type C )	{ return A * B + C; }
+			static Type Sqrt( Type v )						{ return sqrtf( v ); }
+			static Type Max( Type L, Type R )				{ return std::max( L, R ); }
+			static Type Abs( Type v )						{ return fabsf( v ); }
+			/// <summary>
+			/// Returns "-v" if the "sign" is negative.
+			/// </summary>
+			static Type MulSign( Type v, Type sign )		{ return ( sign < 0.0f ) ? -v : v; }
+			static Mask Less( Type L, Type R )				{ return L < R; }
+			static Mask Equal( Type L, Type R )				{ return L == R; }
+			/// <summary>
+			/// Returns "mask ? L : R" per lane.
+			/// </summary>
+			static Type Select( Mask mask, Type L, Type R )	{ return ( mask ) ? L : R; }
+		};
+		struct SSELanes
+		{
+			using Type = __m128;
+			using Mask = __m128;
+			static constexpr size_t WIDTH = 4;
+
+			static Type Load( const float *p )				{ return _mm_loadu_ps( p ); }
+			static void Store( float *p, Type v )			{ _mm_storeu_ps( p, v ); }
+			static Type Set( float v )						{ return _mm_set1_ps( v ); }
+			static Type Add( Type L, Type R )				{ return _mm_add_ps( L, R ); }
+			static Type Sub( Type L, Type R )				{ return _mm_sub_ps( L, R ); }
+			static Type Mul( Type L, Type R )				{ return _mm_mul_ps( L, R ); }
+			static Type Div( Type L, Type R )				{ return _mm_div_ps( L, R ); }
+			static Type MulAdd( Type A, Type B, Type C )	{ return _mm_add_ps( _mm_mul_ps( A, B ), C ); }
+			static Type Sqrt( Type v )						{ return _mm_sqrt_ps( v ); }
+			static Type Max( Type L, Type R )				{ return _mm_max_ps( L, R ); }
+			static Type Abs( Type v )						{ return _mm_andnot_ps( _mm_set1_ps( -0.0f ), v ); }
+			static Type MulSign( Type v, Type sign )		{ return _mm_xor_ps( v, _mm_and_ps( sign, _mm_set1_ps( -0.0f ) ) ); }
+			static Mask Less( Type L, Type R )				{ return _mm_cmplt_ps( L, R ); }
+			static Mask Equal( Type L, Type R )				{ return _mm_cmpeq_ps( L, R ); }
+			static Type Select( Mask mask, Type L, Type R )	{ return _mm_or_ps( _mm_and_ps( mask, L ), _mm_andnot_ps( mask, R ) ); }
+		};
+		/// <summary>
+		/// Needs the FMA also.
+		/// </summary>
+		struct AVX2Lanes
+		{
+			using Type = __m256;
+			using Mask = __m256;
+			static constexpr size_t WIDTH = 8;
+
+			static Type Load( const float *p )				{ return _mm256_loadu_ps( p ); }
+			static void Store( float *p, Type v )			{ _mm256_storeu_ps( p, v ); }
+			static Type Set( float v )						{ return _mm256_set1_ps( v ); }
+			static Type Add( Type L, Type R )				{ return _mm256_add_ps( L, R ); }
+			static Type Sub( Type L, Type R )				{ return _mm256_sub_ps( L, R ); }
+			static Type Mul( Type L, Type R )				{ return _mm256_mul_ps( L, R ); }
+			static Type Div( Type L, Type R )				{ return _mm256_div_ps( L, R ); }
+			static Type MulAdd( Type A, Type B, Type C )	{ return _mm256_fmadd_ps( A, B, C ); }
+			static Type Sqrt( Type v )						{ return _mm256_sqrt_ps( v ); }
+			static Type Max( Type L, Type R )				{ return _mm256_max_ps( L, R ); }
+			static Type Abs( Type v )						{ return _mm256_andnot_ps( _mm256_set1_ps( -0.0f ), v ); }
+			static Type MulSign( Type v, Type sign )		{ return _mm256_xor_ps( v, _mm256_and_ps( sign, _mm256_set1_ps( -0.0f ) ) ); }
+			static Mask Less( Type L, Type R )				{ return _mm256_cmp_ps( L, R, _CMP_LT_OQ ); }
+			static Mask Equal( Type L, Type R )				{ return _mm256_cmp_ps( L, R, _CMP_EQ_OQ ); }
+			static Type Select( Mask mask, Type L, Type R )	{ return _mm256_blendv_ps( R, L, mask ); }
+		};
+
+		/// <summary>
+		/// Calls the "Process( lanes, i )" for the batches of the widest lanes that the CPU supports, then for the rest one by one by the ScalarLanes.
+		/// </summary>
+		template<typename ProcessType>
+		void ForEachBatch( size_t count, ProcessType Process )
+		{
+			const CPUFeatures &features = GetCPUFeatures();
+
+			size_t i = 0;
+			if ( features.avx2 && features.fma )
+			{
+				for ( ; i + AVX2Lanes::WIDTH <= count; i += AVX2Lanes::WIDTH )
+				{
+					Process( AVX2Lanes{}, i );
+				}
+
+				// Avoid the penalty of transition to the legacy SSE code.
+				_mm256_zeroupper();
+			}
+			else if ( features.sse2 )
+			{
+				for ( ; i + SSELanes::WIDTH <= count; i += SSELanes::WIDTH )
+				{
+					Process( SSELanes{}, i );
+				}
+			}
+
+			for ( ; i < count; ++i )
+			{
+				Process( ScalarLanes{}, i );
+			}
+		}
+
+	// region Lanes
+	#pragma endregion
+
+	#pragma region Kernels
+
+		template<typename Type> struct Float3 { Type x, y, z;		};
+		template<typename Type> struct Float4 { Type x, y, z, w;	};
+
+		template<typename Lanes>
+		Float4<typename Lanes::Type> LoadQuaternion( const ConstQuaternions &source, size_t i )
+		{
+			return { Lanes::Load( source.x + i ), Lanes::Load( source.y + i ), Lanes::Load( source.z + i ), Lanes::Load( source.w + i ) };
+		}
+		template<typename Lanes>
+		void StoreQuaternion( const Quaternions &output, size_t i, const Float4<typename Lanes::Type> &q )
+		{
+			Lanes::Store( output.x + i, q.x );
+			Lanes::Store( output.y + i, q.y );
+			Lanes::Store( output.z + i, q.z );
+			Lanes::Store( output.w + i, q.w );
+		}
+		template<typename Lanes>
+		Float3<typename Lanes::Type> LoadVector( const ConstVectors &source, size_t i )
+		{
+			return { Lanes::Load( source.x + i ), Lanes::Load( source.y + i ), Lanes::Load( source.z + i ) };
+		}
+		template<typename Lanes>
+		void StoreVector( const Vectors &output, size_t i, const Float3<typename Lanes::Type> &v )
+		{
+			Lanes::Store( output.x + i, v.x );
+			Lanes::Store( output.y + i, v.y );
+			Lanes::Store( output.z + i, v.z );
+		}
+
+		template<typename Lanes, typename Type = typename Lanes::Type>
+		Type Dot( const Float4<Type> &L, const Float4<Type> &R )
+		{
+			return Lanes::MulAdd( L.x, R.x, Lanes::MulAdd( L.y, R.y, Lanes::MulAdd( L.z, R.z, Lanes::Mul( L.w, R.w ) ) ) );
+		}
+		/// <summary>
+		/// As same as the operator *= of Donya::Quaternion.
+		/// </summary>
+		template<typename Lanes, typename Type = typename Lanes::Type>
+		Float4<Type> MultiplyQuaternion( const Float4<Type> &L, const Float4<Type> &R )
+		{
+			return Float4<Type>
+			{
+				Lanes::Sub( Lanes::MulAdd( L.w, R.x, Lanes::MulAdd( L.x, R.w, Lanes::Mul( L.y, R.z ) ) ), Lanes::Mul( L.z, R.y ) ),
+				Lanes::Sub( Lanes::MulAdd( L.w, R.y, Lanes::MulAdd( L.y, R.w, Lanes::Mul( L.z, R.x ) ) ), Lanes::Mul( L.x, R.z ) ),
+				Lanes::Sub( Lanes::MulAdd( L.w, R.z, Lanes::MulAdd( L.x, R.y, Lanes::Mul( L.z, R.w ) ) ), Lanes::Mul( L.y, R.x ) ),
+				Lanes::Sub( Lanes::Mul( L.w, R.w ), Lanes::MulAdd( L.x, R.x, Lanes::MulAdd( L.y, R.y, Lanes::Mul( L.z, R.z ) ) ) )
+			};
+		}
+		/// <summary>
+		/// As same as Donya::Quaternion::Normalize(), the shorter than FLT_EPSILON is not changed.
+		/// </summary>
+		template<typename Lanes, typename Type = typename Lanes::Type>
+		Float4<Type> NormalizeQuaternion( const Float4<Type> &q )
+		{
+			const Type epsilon	= Lanes::Set( FLT_EPSILON );
+			const Type length	= Lanes::Sqrt( Dot<Lanes>( q, q ) );
+			const Type inverse	= Lanes::Div( Lanes::Set( 1.0f ), Lanes::Max( length, epsilon ) );
+			const auto isShort	= Lanes::Less( length, epsilon );
+			return Float4<Type>
+			{
+				Lanes::Select( isShort, q.x, Lanes::Mul( q.x, inverse ) ),
+				Lanes::Select( isShort, q.y, Lanes::Mul( q.y, inverse ) ),
+				Lanes::Select( isShort, q.z, Lanes::Mul( q.z, inverse ) ),
+				Lanes::Select( isShort, q.w, Lanes::Mul( q.w, inverse ) )
+			};
+		}
+		/// <summary>
+		/// Corrects the time of the nlerp, then its speed becomes near to the constant of the slerp.<para></para>
+		/// see "Approximating slerp" by Arseny Kapoulkine. The coefficients are fitted to the cosine of the half angle between the quaternions.
+		/// </summary>
+		template<typename Lanes, typename Type = typename Lanes::Type>
+		Type CorrectTimeToSlerp( Type time, Type absCosine )
+		{
+			const Type &d = absCosine;
+			const Type A = Lanes::MulAdd( d, Lanes::MulAdd( d, Lanes::MulAdd( d, Lanes::Set( -1.43519f ), Lanes::Set( 3.55645f ) ), Lanes::Set( -3.2452f ) ), Lanes::Set( 1.0904f ) );
+			const Type B = Lanes::MulAdd( d, Lanes::MulAdd( d, Lanes::Set( 0.215638f ), Lanes::Set( -1.06021f ) ), Lanes::Set( 0.848013f ) );
+
+			// time + time * ( time - 0.5 ) * ( time - 1 ) * ( A * ( time - 0.5 )^2 + B )
+			const Type centered	= Lanes::Sub( time, Lanes::Set( 0.5f ) );
+			const Type k		= Lanes::MulAdd( Lanes::Mul( A, centered ), centered, B );
+			const Type cubic	= Lanes::Mul( Lanes::Mul( time, centered ), Lanes::Sub( time, Lanes::Set( 1.0f ) ) );
+			return Lanes::MulAdd( cubic, k, time );
+		}
+		template<typename Lanes, typename Type = typename Lanes::Type>
+		Float4<Type> InterpolateQuaternion( const Float4<Type> &from, const Float4<Type> &to, Type time, bool correctToSlerp )
+		{
+			const Type cosine = Dot<Lanes>( from, to );
+			if ( correctToSlerp )
+			{
+				time = CorrectTimeToSlerp<Lanes>( time, Lanes::Abs( cosine ) );
+			}
+
+			// Take the shorter arc.
+			const Float4<Type> nearTo
+			{
+				Lanes::MulSign( to.x, cosine ),
+				Lanes::MulSign( to.y, cosine ),
+				Lanes::MulSign( to.z, cosine ),
+				Lanes::MulSign( to.w, cosine )
+			};
+			const Float4<Type> blended
+			{
+				Lanes::MulAdd( time, Lanes::Sub( nearTo.x, from.x ), from.x ),
+				Lanes::MulAdd( time, Lanes::Sub( nearTo.y, from.y ), from.y ),
+				Lanes::MulAdd( time, Lanes::Sub( nearTo.z, from.z ), from.z ),
+				Lanes::MulAdd( time, Lanes::Sub( nearTo.w, from.w ), from.w )
+			};
+			return NormalizeQuaternion<Lanes>( blended );
+		}
+		/// <summary>
+		/// Returns "v + 2 * q.xyz x ( q.xyz x v + q.w * v )", it is the same as "q * v * q^-1" of the normalized q.
+		/// </summary>
+		template<typename Lanes, typename Type = typename Lanes::Type>
+		Float3<Type> RotateVector( const Float4<Type> &q, const Float3<Type> &v )
+		{
+			const Float3<Type> t
+			{
+				Lanes::MulAdd( q.w, v.x, Lanes::Sub( Lanes::Mul( q.y, v.z ), Lanes::Mul( q.z, v.y ) ) ),
+				Lanes::MulAdd( q.w, v.y, Lanes::Sub( Lanes::Mul( q.z, v.x ), Lanes::Mul( q.x, v.z ) ) ),
+				Lanes::MulAdd( q.w, v.z, Lanes::Sub( Lanes::Mul( q.x, v.y ), Lanes::Mul( q.y, v.x ) ) )
+			};
+			const Type two = Lanes::Set( 2.0f );
+			return Float3<Type>
+			{
+				Lanes::MulAdd( two, Lanes::Sub( Lanes::Mul( q.y, t.z ), Lanes::Mul( q.z, t.y ) ), v.x ),
+				Lanes::MulAdd( two, Lanes::Sub( Lanes::Mul( q.z, t.x ), Lanes::Mul( q.x, t.z ) ), v.y ),
+				Lanes::MulAdd( two, Lanes::Sub( Lanes::Mul( q.x, t.y ), Lanes::Mul( q.y, t.x ) ), v.z )
+			};
+		}
+
+		template<typename Lanes, typename Type = typename Lanes::Type>
+		Type Pick( typename Lanes::Mask isX, typename Lanes::Mask isY, typename Lanes::Mask isZ, Type x, Type y, Type z, Type w )
+		{
+			return Lanes::Select( isX, x, Lanes::Select( isY, y, Lanes::Select( isZ, z, w ) ) );
+		}
+
+	// region Kernels
+	#pragma endregion
+
+		void Multiply( const ConstQuaternions &L, const ConstQuaternions &R, const Quaternions &output, size_t count )
+		{
+			ForEachBatch
+			(
+				count,
+				[&]( auto lanes, size_t i )
+				{
+					using Lanes = decltype( lanes );
+					StoreQuaternion<Lanes>( output, i, MultiplyQuaternion<Lanes>( LoadQuaternion<Lanes>( L, i ), LoadQuaternion<Lanes>( R, i ) ) );
+				}
+			);
+		}
+		void Normalize( const ConstQuaternions &source, const Quaternions &output, size_t count )
+		{
+			ForEachBatch
+			(
+				count,
+				[&]( auto lanes, size_t i )
+				{
+					using Lanes = decltype( lanes );
+					StoreQuaternion<Lanes>( output, i, NormalizeQuaternion<Lanes>( LoadQuaternion<Lanes>( source, i ) ) );
+				}
+			);
+		}
+
+		/// <summary>
+		/// The "LoadTime( lanes, i )" returns the times of the batch.
+		/// </summary>
+		template<typename TimeLoaderType>
+		void InterpolateAll( const ConstQuaternions &from, const ConstQuaternions &to, const Quaternions &output, size_t count, bool correctToSlerp, TimeLoaderType LoadTime )
+		{
+			ForEachBatch
+			(
+				count,
+				[&]( auto lanes, size_t i )
+				{
+					using Lanes = decltype( lanes );
+					StoreQuaternion<Lanes>
+					(
+						output, i,
+						InterpolateQuaternion<Lanes>( LoadQuaternion<Lanes>( from, i ), LoadQuaternion<Lanes>( to, i ), LoadTime( lanes, i ), correctToSlerp )
+					);
+				}
+			);
+		}
+		void Nlerp( const ConstQuaternions &from, const ConstQuaternions &to, const float *times, const Quaternions &output, size_t count )
+		{
+			InterpolateAll( from, to, output, count, /* correctToSlerp = */ false, [times]( auto lanes, size_t i ) { return decltype( lanes )::Load( times + i ); } );
+		}
+		void Nlerp( const ConstQuaternions &from, const ConstQuaternions &to, float time, const Quaternions &output, size_t count )
+		{
+			InterpolateAll( from, to, output, count, /* correctToSlerp = */ false, [time]( auto lanes, size_t ) { return decltype( lanes )::Set( time ); } );
+		}
+		void Slerp( const ConstQuaternions &from, const ConstQuaternions &to, const float *times, const Quaternions &output, size_t count )
+		{
+			InterpolateAll( from, to, output, count, /* correctToSlerp = */ true, [times]( auto lanes, size_t i ) { return decltype( lanes )::Load( times + i ); } );
+		}
+		void Slerp( const ConstQuaternions &from, const ConstQuaternions &to, float time, const Quaternions &output, size_t count )
+		{
+			InterpolateAll( from, to, output, count, /* correctToSlerp = */ true, [time]( auto lanes, size_t ) { return decltype( lanes )::Set( time ); } );
+		}
+
+		void RotateVectors( const ConstQuaternions &rotations, const ConstVectors &vectors, const Vectors &output, size_t count )
+		{
+			ForEachBatch
+			(
+				count,
+				[&]( auto lanes, size_t i )
+				{
+					using Lanes = decltype( lanes );
+					StoreVector<Lanes>( output, i, RotateVector<Lanes>( LoadQuaternion<Lanes>( rotations, i ), LoadVector<Lanes>( vectors, i ) ) );
+				}
+			);
+		}
+
+		void ToMatrices( const ConstQuaternions &rotations, const Matrices &output, size_t count )
+		{
+			ForEachBatch
+			(
+				count,
+				[&]( auto lanes, size_t i )
+				{
+					using Lanes	= decltype( lanes );
+					using Type	= typename Lanes::Type;
+					const Float4<Type> q = LoadQuaternion<Lanes>( rotations, i );
+
+					const Type x2 = Lanes::Add( q.x, q.x );
+					const Type y2 = Lanes::Add( q.y, q.y );
+					const Type z2 = Lanes::Add( q.z, q.z );
+					const Type xx = Lanes::Mul( q.x, x2 ), xy = Lanes::Mul( q.x, y2 ), xz = Lanes::Mul( q.x, z2 );
+					const Type yy = Lanes::Mul( q.y, y2 ), yz = Lanes::Mul( q.y, z2 ), zz = Lanes::Mul( q.z, z2 );
+					const Type wx = Lanes::Mul( q.w, x2 ), wy = Lanes::Mul( q.w, y2 ), wz = Lanes::Mul( q.w, z2 );
+					const Type one = Lanes::Set( 1.0f );
+
+					Lanes::Store( output.m[0][0] + i, Lanes::Sub( one, Lanes::Add( yy, zz ) ) );
+					Lanes::Store( output.m[0][1] + i, Lanes::Add( xy, wz ) );
+					Lanes::Store( output.m[0][2] + i, Lanes::Sub( xz, wy ) );
+
+					Lanes::Store( output.m[1][0] + i, Lanes::Sub( xy, wz ) );
+					Lanes::Store( output.m[1][1] + i, Lanes::Sub( one, Lanes::Add( xx, zz ) ) );
+					Lanes::Store( output.m[1][2] + i, Lanes::Add( yz, wx ) );
+
+					Lanes::Store( output.m[2][0] + i, Lanes::Add( xz, wy ) );
+					Lanes::Store( output.m[2][1] + i, Lanes::Sub( yz, wx ) );
+					Lanes::Store( output.m[2][2] + i, Lanes::Sub( one, Lanes::Add( xx, yy ) ) );
+				}
+			);
+		}
+		void FromMatrices( const ConstMatrices &matrices, const Quaternions &output, size_t count )
+		{
+			ForEachBatch
+			(
+				count,
+				[&]( auto lanes, size_t i )
+				{
+					using Lanes	= decltype( lanes );
+					using Type	= typename Lanes::Type;
+					const Type _11 = Lanes::Load( matrices.m[0][0] + i ), _12 = Lanes::Load( matrices.m[0][1] + i ), _13 = Lanes::Load( matrices.m[0][2] + i );
+					const Type _21 = Lanes::Load( matrices.m[1][0] + i ), _22 = Lanes::Load( matrices.m[1][1] + i ), _23 = Lanes::Load( matrices.m[1][2] + i );
+					const Type _31 = Lanes::Load( matrices.m[2][0] + i ), _32 = Lanes::Load( matrices.m[2][1] + i ), _33 = Lanes::Load( matrices.m[2][2] + i );
+					const Type one = Lanes::Set( 1.0f );
+
+					// 4 * x^2, 4 * y^2, 4 * z^2, 4 * w^2
+					const Type elementX = Lanes::Add( Lanes::Sub( Lanes::Sub( _11, _22 ), _33 ), one );
+					const Type elementY = Lanes::Add( Lanes::Sub( Lanes::Sub( _22, _11 ), _33 ), one );
+					const Type elementZ = Lanes::Add( Lanes::Sub( Lanes::Sub( _33, _11 ), _22 ), one );
+					const Type elementW = Lanes::Add( Lanes::Add( Lanes::Add( _11, _22 ), _33 ), one );
+					const Type biggest  = Lanes::Max( Lanes::Max( elementX, elementY ), Lanes::Max( elementZ, elementW ) );
+
+					// The former is chosen at a tie, as same as the scalar.
+					const auto isX = Lanes::Equal( elementX, biggest );
+					const auto isY = Lanes::Equal( elementY, biggest );
+					const auto isZ = Lanes::Equal( elementZ, biggest );
+
+					// The biggest component is "0.5 * sqrt( biggest )", the others are the sums or the differences of the pairs of elements multiplied by "0.25 / biggest component".
+					// "biggest * extract" is the biggest component, so every component is "the one of the following * extract".
+					const Type safeBiggest	= Lanes::Max( biggest, Lanes::Set( FLT_MIN ) );
+					const Type extract		= Lanes::Div( Lanes::Set( 0.5f ), Lanes::Sqrt( safeBiggest ) );
+					const Type sumXY		= Lanes::Add( _12, _21 );
+					const Type sumZX		= Lanes::Add( _31, _13 );
+					const Type sumYZ		= Lanes::Add( _23, _32 );
+					const Type diffX		= Lanes::Sub( _23, _32 );
+					const Type diffY		= Lanes::Sub( _31, _13 );
+					const Type diffZ		= Lanes::Sub( _12, _21 );
+					Float4<Type> q
+					{
+						Lanes::Mul( extract, Pick<Lanes>( isX, isY, isZ, safeBiggest,	sumXY,			sumZX,			diffX		) ),
+						Lanes::Mul( extract, Pick<Lanes>( isX, isY, isZ, sumXY,			safeBiggest,	sumYZ,			diffY		) ),
+						Lanes::Mul( extract, Pick<Lanes>( isX, isY, isZ, sumZX,			sumYZ,			safeBiggest,	diffZ		) ),
+						Lanes::Mul( extract, Pick<Lanes>( isX, isY, isZ, diffX,			diffY,			diffZ,			safeBiggest	) )
+					};
+
+					// The wrong matrix makes the identity, as same as the scalar.
+					const auto		isWrong	= Lanes::Less( biggest, Lanes::Set( FLT_MIN ) );
+					const Type		zero	= Lanes::Set( 0.0f );
+					q.x = Lanes::Select( isWrong, zero, q.x );
+					q.y = Lanes::Select( isWrong, zero, q.y );
+					q.z = Lanes::Select( isWrong, zero, q.z );
+					q.w = Lanes::Select( isWrong, one,  q.w );
+					StoreQuaternion<Lanes>( output, i, q );
+				}
+			);
+		}
+	}
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "Quaternion.h"
+#include "Vector.h"
+
+namespace Donya
+{
+	/// <summary>
+	/// The batch versions of the operations of Donya::Quaternion, for the many quaternions such as the joints of animations.<para></para>
+	/// The quaternions and the vectors are the SoA(the separated arrays of components), so 4 or 8 of those are processed per instruction.<para></para>
+	/// The width is chosen at run time by the CPUFeatures, 8 by AVX2 and FMA, 4 by SSE2. The rest of the width is processed by scalar.<para></para>
+	/// The output can be the same arrays as an input, because the i-th output depends only on the i-th inputs.
+	/// </summary>
+	namespace QuaternionBatch
+	{
+		/// <summary>
+		/// The i-th quaternion is ( x[i], y[i], z[i], w[i] ). Each array must have the count elements of the operation.
+		/// </summary>
+		struct Quaternions
+		{
+			float *x = nullptr;
+			float *y = nullptr;
+			float *z = nullptr;
+			float *w = nullptr;
+		};
+		struct ConstQuaternions
+		{
+			const float *x = nullptr;
+			const float *y = nullptr;
+			const float *z = nullptr;
+			const float *w = nullptr;
+		public:
+			ConstQuaternions() = default;
+			ConstQuaternions( const float *x, const float *y, const float *z, const float *w ) : x( x ), y( y ), z( z ), w( w ) {}
+			ConstQuaternions( const Quaternions &source ) : x( source.x ), y( source.y ), z( source.z ), w( source.w ) {}
+		};
+
+		/// <summary>
+		/// The i-th vector is ( x[i], y[i], z[i] ). Each array must have the count elements of the operation.
+		/// </summary>
+		struct Vectors
+		{
+			float *x = nullptr;
+			float *y = nullptr;
+			float *z = nullptr;
+		};
+		struct ConstVectors
+		{
+			const float *x = nullptr;
+			const float *y = nullptr;
+			const float *z = nullptr;
+		public:
+			ConstVectors() = default;
+			ConstVectors( const float *x, const float *y, const float *z ) : x( x ), y( y ), z( z ) {}
+			ConstVectors( const Vectors &source ) : x( source.x ), y( source.y ), z( source.z ) {}
+		};
+
+		/// <summary>
+		/// The rotation part of row-vector style matrices as same as Donya::Quaternion::RequireRotationMatrix().<para></para>
+		/// The m[r][c] is the array of the element at row r, column c, e.g. m[0][1] is of "_12". Each array must have the count elements of the operation.
+		/// </summary>
+		struct Matrices
+		{
+			float *m[3][3]{};
+		};
+		struct ConstMatrices
+		{
+			const float *m[3][3]{};
+		public:
+			ConstMatrices() = default;
+			ConstMatrices( const Matrices &source )
+			{
+				for ( int r = 0; r < 3; ++r )
+				{
+					for ( int c = 0; c < 3; ++c )
+					{
+						m[r][c] = source.m[r][c];
+					}
+				}
+			}
+		};
+
+		/// <summary>
+		/// The storage of the SoA quaternions.
+		/// </summary>
+		struct QuaternionArray
+		{
+			std::vector<float> x{};
+			std::vector<float> y{};
+			std::vector<float> z{};
+			std::vector<float> w{};
+		public:
+			size_t	Size() const { return w.size(); }
+			void	Resize( size_t count );
+			/// <summary>
+			/// Converts from the AoS. It resizes to the count.
+			/// </summary>
+			void	Assign( const Donya::Quaternion *pSource, size_t count );
+			/// <summary>
+			/// Converts into the AoS. The "pOutput" must have the Size() elements.
+			/// </summary>
+			void	CopyTo( Donya::Quaternion *pOutput ) const;
+		public:
+			Quaternions			View();
+			ConstQuaternions	View() const;
+		};
+		/// <summary>
+		/// The storage of the SoA vectors.
+		/// </summary>
+		struct VectorArray
+		{
+			std::vector<float> x{};
+			std::vector<float> y{};
+			std::vector<float> z{};
+		public:
+			size_t	Size() const { return z.size(); }
+			void	Resize( size_t count );
+			/// <summary>
+			/// Converts from the AoS. It resizes to the count.
+			/// </summary>
+			void	Assign( const Donya::Vector3 *pSource, size_t count );
+			/// <summary>
+			/// Converts into the AoS. The "pOutput" must have the Size() elements.
+			/// </summary>
+			void	CopyTo( Donya::Vector3 *pOutput ) const;
+		public:
+			Vectors			View();
+			ConstVectors	View() const;
+		};
+
+		/// <summary>
+		/// output = L * R, as same as the operator * of Donya::Quaternion.
+		/// </summary>
+		void Multiply( const ConstQuaternions &L, const ConstQuaternions &R, const Quaternions &output, size_t count );
+		/// <summary>
+		/// As same as Donya::Quaternion::Normalize(), the quaternion that is shorter than FLT_EPSILON is not changed.
+		/// </summary>
+		void Normalize( const ConstQuaternions &source, const Quaternions &output, size_t count );
+
+		/// <summary>
+		/// The normalized linear interpolation by the times[i](0.0f ~ 1.0f).<para></para>
+		/// The "to" is negated if it is in the opposite hemisphere of the "from", so it takes the shorter arc.
+		/// </summary>
+		void Nlerp( const ConstQuaternions &from, const ConstQuaternions &to, const float *times, const Quaternions &output, size_t count );
+		/// <summary>
+		/// The same time for all the quaternions, e.g. the interpolation between the keys of the fixed rate.
+		/// </summary>
+		void Nlerp( const ConstQuaternions &from, const ConstQuaternions &to, float time, const Quaternions &output, size_t count );
+		/// <summary>
+		/// The Nlerp() that the time is corrected by a polynomial of the angle between the quaternions,<para></para>
+		/// so it approximates the spherical linear interpolation without acos and sin. The error is less than 0.05 degrees.<para></para>
+		/// The inputs should be normalized. Unlike Donya::Quaternion::Slerp(), it takes the shorter arc.
+		/// </summary>
+		void Slerp( const ConstQuaternions &from, const ConstQuaternions &to, const float *times, const Quaternions &output, size_t count );
+		void Slerp( const ConstQuaternions &from, const ConstQuaternions &to, float time, const Quaternions &output, size_t count );
+
+		/// <summary>
+		/// output[i] = rotations[i] * vectors[i] * rotations[i]^-1, as same as Donya::Quaternion::RotateVector(). The rotations should be normalized.
+		/// </summary>
+		void RotateVectors( const ConstQuaternions &rotations, const ConstVectors &vectors, const Vectors &output, size_t count );
+
+		/// <summary>
+		/// As same as Donya::Quaternion::RequireRotationMatrix(). The rotations should be normalized.
+		/// </summary>
+		void ToMatrices( const ConstQuaternions &rotations, const Matrices &output, size_t count );
+		/// <summary>
+		/// As same as Donya::Quaternion::Make( XMFLOAT4X4 ). The largest component is chosen per quaternion by the selections instead of the branches.
+		/// </summary>
+		void FromMatrices( const ConstMatrices &matrices, const Quaternions &output, size_t count );
+	}
+}
@@ -1,10 +1,16 @@
 #include "Resource.h"
 
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <D3D11.h>
 #include <DirectXMath.h>
 #include <fstream>
+#include <future>
 #include <unordered_map>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <tchar.h>
 #include <DDSTextureLoader.h>
@@ -12,6 +18,7 @@
 
 #include "Common.h"
 #include "Donya.h"
+#include "MappedFile.h"
 #include "Useful.h"
 
 using namespace DirectX;
@@ -36,6 +43,104 @@ namespace Donya
 {
 	namespace Resource
 	{
+	#pragma region LoadOnceCache
+
+		/// <summary>
+		/// The cache that loads each key only once, even if some threads require the same key at the same time.<para></para>
+		/// The mutex is locked only while finding or inserting, so the loading of a key does not block the requirements of the other keys.
+		/// </summary>
+		template<typename Key, typename Contents>
+		class LoadOnceCache
+		{
+		private:
+			struct Loading
+			{
+				std::promise<void>			promise;
+				std::shared_future<void>	future;
+			};
+		private:
+			std::mutex							mutex;
+			std::unordered_map<Key, Contents>	contents;
+			std::unordered_map<Key, Loading>	loadings;	// The placeholders of the keys that are being loaded.
+		public:
+			/// <summary>
+			/// If the "key" is cached, calls the "OnFound( const Contents & )" and returns true.<para></para>
+			/// If other thread is loading the "key", waits for it before the finding.<para></para>
+			/// Otherwise returns false, then the caller should load it.
+			/// If the "reserve" is true, the other threads that require the "key" wait until the caller calls FinishLoading().
+			/// </summary>
+			template<typename Callback>
+			bool Find( const Key &key, bool reserve, Callback OnFound )
+			{
+				while ( true )
+				{
+					std::shared_future<void> waiting{};
+					{
+						std::lock_guard<std::mutex> lock( mutex );
+
+						auto found = contents.find( key );
+						if ( found != contents.end() )
+						{
+							OnFound( found->second );
+							return true;
+						}
+						// else
+
+						auto loading = loadings.find( key );
+						if ( loading == loadings.end() )
+						{
+							if ( reserve )
+							{
+								Loading &reserved = loadings[key];
+								reserved.future = reserved.promise.get_future().share();
+							}
+							return false;
+						}
+						// else
+
+						waiting = loading->second.future;
+					}
+
+					// The loading thread may fail or not cache it, so find it again after the waiting.
+					waiting.wait();
+				}
+			}
+			/// <summary>
+			/// Call it after the loading that is reserved by Find().<para></para>
+			/// Caches the "pLoaded" if it is not null, then wakes the waiting threads up.
+			/// </summary>
+			void FinishLoading( const Key &key, const Contents *pLoaded )
+			{
+				std::promise<void> promise{};
+				{
+					std::lock_guard<std::mutex> lock( mutex );
+
+					if ( pLoaded )
+					{
+						contents.insert( std::make_pair( key, *pLoaded ) );
+					}
+
+					auto loading = loadings.find( key );
+					if ( loading == loadings.end() ) { return; }
+					// else
+
+					promise = std::move( loading->second.promise );
+					loadings.erase( loading );
+				}
+				promise.set_value();
+			}
+			/// <summary>
+			/// Releases the cached contents. The loadings in progress are not affected.
+			/// </summary>
+			void Clear()
+			{
+				std::lock_guard<std::mutex> lock( mutex );
+				contents.clear();
+			}
+		};
+
+	#pragma endregion
+
 	#pragma region VerteShaderCache
 
 		struct VertexShaderCacheContents
@@ -55,9 +160,13 @@ namespace Donya
 		};
 
 		static std::unordered_map<std::string, VertexShaderCacheContents> vertexShaderCache{};
+		static std::mutex vertexShaderCacheMutex{};
 		
 		void CreateVertexShaderFromCso( ID3D11Device *d3dDevice, std::string csoName, const char *openMode, ID3D11VertexShader **d3dVertexShader, ID3D11InputLayout **d3dInputLayout, D3D11_INPUT_ELEMENT_DESC *d3dInputElementsDesc, size_t inputElementDescSize, bool enableCache )
 		{
+			// The models are created on some threads, so the find and the insert must not be interrupted.
+			std::lock_guard<std::mutex> lock( vertexShaderCacheMutex );
+
 			HRESULT hr = S_OK;
 			
 			auto it = vertexShaderCache.find( csoName );
@@ -130,6 +239,7 @@ namespace Donya
 
 		void ReleaseAllVertexShaderCaches()
 		{
+			std::lock_guard<std::mutex> lock( vertexShaderCacheMutex );
 			vertexShaderCache.clear();
 		}
 
@@ -138,9 +248,12 @@ namespace Donya
 	#pragma region PixelShaderCache
 
 		static std::unordered_map<std::string, Microsoft::WRL::ComPtr<ID3D11PixelShader>> pixelShaderCache{};
+		static std::mutex pixelShaderCacheMutex{};
 		
 		void CreatePixelShaderFromCso( ID3D11Device *d3dDevice, std::string csoName, const char *openMode, ID3D11PixelShader **d3dPixelShader, bool enableCache )
 		{
+			std::lock_guard<std::mutex> lock( pixelShaderCacheMutex );
+
 			HRESULT hr = S_OK;
 
 			auto it = pixelShaderCache.find( csoName );
@@ -189,6 +302,7 @@ namespace Donya
 
 		void ReleaseAllPixelShaderCaches()
 		{
+			std::lock_guard<std::mutex> lock( pixelShaderCacheMutex );
 			pixelShaderCache.clear();
 		}
 
@@ -212,24 +326,12 @@ namespace Donya
 			}
 		};
 
-		static std::unordered_map<std::wstring, SpriteCacheContents> spriteCache{};
-		
-		bool CreateTexture2DFromFile( ID3D11Device *d3dDevice, const std::wstring &fileName, ID3D11ShaderResourceView **d3dShaderResourceView, D3D11_TEXTURE2D_DESC *d3dTexture2DDesc, bool isEnableCache )
+		static LoadOnceCache<std::wstring, SpriteCacheContents> spriteCache{};
+
+		bool DecodeTexture2DFromFile( ID3D11Device *d3dDevice, const std::wstring &fileName, ID3D11ShaderResourceView **d3dShaderResourceView, D3D11_TEXTURE2D_DESC *d3dTexture2DDesc )
 		{
 			HRESULT hr = S_OK;
 
-			auto it = spriteCache.find( fileName );
-			if ( it != spriteCache.end() )
-			{
-				*d3dShaderResourceView = it->second.d3dShaderResourceView.Get();
-				( *d3dShaderResourceView )->AddRef();
-
-				*d3dTexture2DDesc = it->second.d3dTexture2DDesc;
-
-				return true;
-			}
-			// else
-
 			if ( !Donya::IsExistFile( fileName ) ) { return false; }
 			// else
 
@@ -260,23 +362,37 @@ namespace Donya
 
 			d3dTexture2D->GetDesc( d3dTexture2DDesc );
 
+			return true;
+		}
+		bool CreateTexture2DFromFile( ID3D11Device *d3dDevice, const std::wstring &fileName, ID3D11ShaderResourceView **d3dShaderResourceView, D3D11_TEXTURE2D_DESC *d3dTexture2DDesc, bool isEnableCache )
+		{
+			auto AssignCache = [&]( const SpriteCacheContents &cache )
+			{
+				*d3dShaderResourceView = cache.d3dShaderResourceView.Get();
+				( *d3dShaderResourceView )->AddRef();
+
+				*d3dTexture2DDesc = cache.d3dTexture2DDesc;
+			};
+			if ( spriteCache.Find( fileName, isEnableCache, AssignCache ) ) { return true; }
+			// else
+
+			// The decoding is done without the lock, so the other textures can be created at the same time.
+			const bool succeeded = DecodeTexture2DFromFile( d3dDevice, fileName, d3dShaderResourceView, d3dTexture2DDesc );
+
 			if ( isEnableCache )
 			{
-				spriteCache.insert
-				(
-					std::make_pair
-					(
-						fileName,
-						SpriteCacheContents
-						{
-							*d3dShaderResourceView,
-							d3dTexture2DDesc
-						}
-					)
-				);
+				if ( succeeded )
+				{
+					const SpriteCacheContents loaded{ *d3dShaderResourceView, d3dTexture2DDesc };
+					spriteCache.FinishLoading( fileName, &loaded );
+				}
+				else
+				{
+					spriteCache.FinishLoading( fileName, nullptr );
+				}
 			}
 
-			return true;
+			return succeeded;
 		}
 
 		void CreateUnicolorTexture( ID3D11Device *pDevice, ID3D11ShaderResourceView **pOutSRV, D3D11_TEXTURE2D_DESC *pOutTexDesc, unsigned int dimensions, float R, float G, float B, float A, bool isEnableCache )
@@ -302,14 +418,12 @@ namespace Donya
 			}
 
 			std::wstring dummyFileName = L"UnicolorTexture:[RGBA:" + std::to_wstring( RGBA ) + L"]";
-			auto &it = spriteCache.find( dummyFileName );
-			if ( it != spriteCache.end() )
+			auto AssignCache = [&]( const SpriteCacheContents &cache )
 			{
-				*pOutSRV = it->second.d3dShaderResourceView.Get();
+				*pOutSRV = cache.d3dShaderResourceView.Get();
 				( *pOutSRV )->AddRef();
-
-				return;
-			}
+			};
+			if ( spriteCache.Find( dummyFileName, isEnableCache, AssignCache ) ) { return; }
 			// else
 
 			HRESULT hr = S_OK;
@@ -352,24 +466,14 @@ namespace Donya
 
 			if ( isEnableCache )
 			{
-				spriteCache.insert
-				(
-					std::make_pair
-					(
-						dummyFileName,
-						SpriteCacheContents
-						{
-							*pOutSRV,
-							pOutTexDesc
-						}
-					)
-				);
+				const SpriteCacheContents created{ *pOutSRV, pOutTexDesc };
+				spriteCache.FinishLoading( dummyFileName, &created );
 			}
 		}
 
 		void ReleaseAllTexture2DCaches()
 		{
-			spriteCache.clear();
+			spriteCache.Clear();
 		}
 
 	#pragma endregion
@@ -377,6 +481,7 @@ namespace Donya
 	#pragma region Sampler
 
 		static std::unordered_map<size_t, Microsoft::WRL::ComPtr<ID3D11SamplerState>> samplerCache{};
+		static std::mutex samplerCacheMutex{};
 
 		size_t RequireSamplerDescHash( const D3D11_SAMPLER_DESC &key )
 		{
@@ -388,6 +493,8 @@ namespace Donya
 		{
 			size_t hash = RequireSamplerDescHash( samplerDesc );
 
+			std::lock_guard<std::mutex> lock( samplerCacheMutex );
+
 			auto it = samplerCache.find( hash );
 			if ( it != samplerCache.end() )
 			{
@@ -410,6 +517,8 @@ namespace Donya
 		Microsoft::WRL::ComPtr<ID3D11SamplerState> &RequireInvalidSamplerStateComPtr()
 		{
 			static Microsoft::WRL::ComPtr<ID3D11SamplerState> pInvalidSampler;
+
+			std::lock_guard<std::mutex> lock( samplerCacheMutex );
 			if ( !pInvalidSampler )
 			{
 				D3D11_SAMPLER_DESC null{};
@@ -459,7 +568,7 @@ namespace Donya
 			}
 		};
 
-		static std::unordered_map<std::wstring, ObjFileCacheContents> objFileCache;
+		static LoadOnceCache<std::wstring, ObjFileCacheContents> objFileCache{};
 
 		/// <summary>
 		/// It is storage of materials by mtl-file.
@@ -691,272 +800,401 @@ namespace Donya
 			}
 		};
 
-		// TODO:There are many unsupported extensions yet.
-		void LoadObjFile( ID3D11Device *pDevice, const std::wstring &objFileName, std::vector<DirectX::XMFLOAT3> *pVertices, std::vector<DirectX::XMFLOAT3> *pNormals, std::vector<XMFLOAT2> *pTexCoords, std::vector<size_t> *pIndices, std::vector<Material> *pMaterials, bool *hasLoadedMtl, bool isEnableCache )
+		/// <summary>
+		/// The cursor of one line in the OBJ text. It parses the bytes in-place, so it does not allocate.
+		/// </summary>
+		struct ObjLineCursor
 		{
-			// check objFileName already has cached ?
+			const char *pos;
+			const char *end;	// Exclusive, it points the '\n' or the end of text.
+		public:
+			static bool IsSpace( char c ) { return ( c == ' ' || c == '\t' || c == '\r' ); }
+			static bool IsDigit( char c ) { return ( '0' <= c && c <= '9' ); }
+		public:
+			bool IsEnd() const { return ( end <= pos ); }
+			char Peek()  const { return ( IsEnd() ) ? '\0' : *pos; }
+			void SkipSpaces()
 			{
-				decltype( objFileCache )::iterator it = objFileCache.find( objFileName );
-				if ( it != objFileCache.end() )
-				{
-					if ( pVertices ) { *pVertices = it->second.vertices; }
-					if ( pNormals ) { *pNormals = it->second.normals; }
-					if ( pTexCoords ) { *pNormals = it->second.normals; }
-					if ( pIndices ) { *pIndices = it->second.indices; }
-					if ( pMaterials ) { *pMaterials = it->second.materials; }
-
-					return;
-				}
+				while ( !IsEnd() && IsSpace( *pos ) ) { ++pos; }
 			}
-			// else
-
-			if ( pVertices == nullptr ) { return; }
-			// else
-
-			std::wifstream ifs( objFileName.c_str() );
-			if ( !ifs )
+			/// <summary>
+			/// Returns the length of the token, that is separated by spaces. The "*ppToken" points to the first character.
+			/// </summary>
+			size_t ReadToken( const char **ppToken )
 			{
-				_ASSERT_EXPR( 0, L"Failed : load obj flie." );
-				return;
+				SkipSpaces();
+				*ppToken = pos;
+				while ( !IsEnd() && !IsSpace( *pos ) ) { ++pos; }
+				return scast<size_t>( pos - *ppToken );
 			}
-			// else
-
-			size_t lastVertexIndex = 0;	// zero-based number.
-			size_t lastNormalIndex = 0;	// zero-based number.
-			size_t lastTexCoordIndex = 0;	// zero-based number.
-			std::wstring command{};
-			std::wstringstream ss{};
-			std::vector<DirectX::XMFLOAT3> tmpPositions{};
-			std::vector<DirectX::XMFLOAT3> tmpNormals{};
-			std::vector<DirectX::XMFLOAT2> tmpTexCoords{};
-
-			size_t		materialCount = 0;	// zero-based number.
-			Material *usemtlTarget = nullptr;
-			std::unique_ptr<MtlFile> pMtllib{};
-
-			for ( size_t i = 0; ifs; ++i )	// i is column num.
+			bool ReadInt( int *pOutput )
 			{
-				std::getline( ifs, command );
+				SkipSpaces();
+				const char *p = pos;
 
-				if ( IsContainStr( command, L"#" ) )
+				bool isNegative = false;
+				if ( p < end && ( *p == '-' || *p == '+' ) )
 				{
-					// comment.
-					continue;
+					isNegative = ( *p == '-' );
+					++p;
 				}
+				if ( p == end || !IsDigit( *p ) ) { return false; }
 				// else
-				if ( IsContainStr( command, L"\n" ) )
+
+				int value = 0;
+				for ( ; p < end && IsDigit( *p ); ++p )
 				{
-					// linefeed.
-					continue;
+					value = value * 10 + ( *p - '0' );
 				}
-				// else
-				if ( IsContainStr( command, L"mtllib" ) )
-				{
-				#pragma region mtllib
 
-					SkipUntilNextDelim( &command, &ss );
+				*pOutput	= ( isNegative ) ? -value : value;
+				pos			= p;
+				return true;
+			}
+			/// <summary>
+			/// Parses the decimal notation like "-1.25e-3". It does not support "inf" and "nan".<para></para>
+			/// The significant digits are accumulated as integer(up to 19 digits), then scaled once,
+			/// so the error is at most 1 ulp of float.
+			/// </summary>
+			bool ReadFloat( float *pOutput )
+			{
+				SkipSpaces();
+				const char *p = pos;
 
-					std::wstring mtlPath = objFileName;
+				bool isNegative = false;
+				if ( p < end && ( *p == '-' || *p == '+' ) )
+				{
+					isNegative = ( *p == '-' );
+					++p;
+				}
+
+				constexpr int MAX_SIGNIFICANT_DIGITS = 19;
+				std::uint64_t	mantissa		= 0;
+				int				exponent		= 0;
+				int				digitCount		= 0; // Significant digits, the leading zeros are not counted.
+				bool			hasDigit		= false;
+				for ( ; p < end && IsDigit( *p ); ++p )
+				{
+					hasDigit = true;
+					if ( digitCount < MAX_SIGNIFICANT_DIGITS )
 					{
-						size_t lastTreePos = mtlPath.find_last_of( L"/" );
-						mtlPath = mtlPath.substr( 0, lastTreePos );
-						mtlPath += L"/";
+						mantissa = mantissa * 10 + scast<std::uint64_t>( *p - '0' );
+						if ( mantissa ) { ++digitCount; }
+					}
+					else
+					{
+						++exponent; // The dropped digit of integer part.
 					}
-
-					std::wstring mtlName; ss >> mtlName;
-
-					pMtllib = std::make_unique<MtlFile>( pDevice, mtlPath + mtlName );
-
-				#pragma endregion
-					continue;
 				}
-				// else
-				if ( IsContainStr( command, L"g " ) )
+				if ( p < end && *p == '.' )
 				{
-				#pragma region Group
-				#pragma endregion
-					continue;
+					++p;
+					for ( ; p < end && IsDigit( *p ); ++p )
+					{
+						hasDigit = true;
+						if ( digitCount < MAX_SIGNIFICANT_DIGITS )
+						{
+							mantissa = mantissa * 10 + scast<std::uint64_t>( *p - '0' );
+							if ( mantissa ) { ++digitCount; }
+							--exponent;
+						}
+					}
 				}
+				if ( !hasDigit ) { return false; }
 				// else
-				if ( IsContainStr( command, L"s " ) )
+
+				if ( p < end && ( *p == 'e' || *p == 'E' ) )
 				{
-				#pragma region Smooth
-				#pragma endregion
-					continue;
+					ObjLineCursor exponentPart{ p + 1, end };
+					int exponentValue = 0;
+					if ( !exponentPart.IsEnd() && !IsSpace( exponentPart.Peek() ) && exponentPart.ReadInt( &exponentValue ) )
+					{
+						exponent	+= exponentValue;
+						p			=  exponentPart.pos;
+					}
 				}
-				// else
-				if ( IsContainStr( command, L"v " ) )
+
+				constexpr std::array<double, 23> POWERS_OF_TEN
 				{
-				#pragma region Vertex
+					1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+					1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+					1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+				};
+				const int absExponent = ( exponent < 0 ) ? -exponent : exponent;
+				const double scale = ( absExponent < scast<int>( POWERS_OF_TEN.size() ) )
+									? POWERS_OF_TEN[absExponent]
+									: std::pow( 10.0, scast<double>( absExponent ) );
 
-					SkipUntilNextDelim( &command, &ss );
+				double value = scast<double>( mantissa );
+				value = ( exponent < 0 ) ? value / scale : value * scale;
 
-					float x, y, z;
-					ss >> x;
-					ss >> y;
-					ss >> z;
+				*pOutput	= scast<float>( ( isNegative ) ? -value : value );
+				pos			= p;
+				return true;
+			}
+		};
 
-					tmpPositions.push_back( { x, y, z } );
+		bool IsKeyword( const char *pToken, size_t tokenLength, const char *keyword )
+		{
+			const size_t keywordLength = strlen( keyword );
+			return ( tokenLength == keywordLength && !memcmp( pToken, keyword, keywordLength ) );
+		}
 
-					lastVertexIndex++;
+		/// <summary>
+		/// Convert the one-based index(or negative relative index) of OBJ to zero-based index.<para></para>
+		/// Returns false if out of range.
+		/// </summary>
+		bool ResolveObjIndex( int objIndex, size_t elementCount, size_t *pOutput )
+		{
+			if ( 0 < objIndex )
+			{
+				*pOutput = scast<size_t>( objIndex - 1 );
+			}
+			else
+			if ( objIndex < 0 && scast<size_t>( -objIndex ) <= elementCount )
+			{
+				*pOutput = elementCount - scast<size_t>( -objIndex );
+			}
+			else
+			{
+				return false;
+			}
 
-				#pragma endregion
-					continue;
-				}
-				// else
-				if ( IsContainStr( command, L"vt " ) )
+			return ( *pOutput < elementCount );
+		}
+
+		// TODO:There are many unsupported extensions yet.
+		bool ParseObjFile( ID3D11Device *pDevice, const std::wstring &objFileName, std::vector<DirectX::XMFLOAT3> *pVertices, std::vector<DirectX::XMFLOAT3> *pNormals, std::vector<XMFLOAT2> *pTexCoords, std::vector<size_t> *pIndices, std::vector<Material> *pMaterials, bool *hasLoadedMtl )
+		{
+			// The whole file is mapped, then parsed in-place without the line copies.
+			MappedFile file{};
+			if ( !file.Open( objFileName ) )
+			{
+				_ASSERT_EXPR( 0, L"Failed : load obj flie." );
+				return false;
+			}
+			// else
+
+			const char *pBegin	= reinterpret_cast<const char *>( file.GetData() );
+			const char *pEnd	= pBegin + file.GetSize();
+
+			auto NextLine = [&pEnd]( const char *pLineBegin )->ObjLineCursor
+			{
+				const void *pFound = memchr( pLineBegin, '\n', scast<size_t>( pEnd - pLineBegin ) );
+				const char *pLineEnd = ( pFound ) ? static_cast<const char *>( pFound ) : pEnd;
+				return ObjLineCursor{ pLineBegin, pLineEnd };
+			};
+
+			const char	*pToken			= nullptr;
+			size_t		tokenLength		= 0;
+
+			#pragma region Count
+
+			// Count the elements for reserve, so the following pass does not re-allocate.
+			size_t positionCount	= 0;
+			size_t texCoordCount	= 0;
+			size_t normalCount		= 0;
+			size_t cornerCount		= 0;
+			for ( const char *pLine = pBegin; pLine < pEnd; )
+			{
+				ObjLineCursor line = NextLine( pLine );
+				pLine = ( line.end < pEnd ) ? line.end + 1 : pEnd;
+
+				tokenLength = line.ReadToken( &pToken );
+				if ( IsKeyword( pToken, tokenLength, "v"  ) ) { ++positionCount;	continue; }
+				if ( IsKeyword( pToken, tokenLength, "vt" ) ) { ++texCoordCount;	continue; }
+				if ( IsKeyword( pToken, tokenLength, "vn" ) ) { ++normalCount;		continue; }
+				if ( IsKeyword( pToken, tokenLength, "f"  ) )
 				{
-				#pragma region TexCoord
-					if ( pTexCoords == nullptr ) { continue; }
-					// else
+					while ( line.ReadToken( &pToken ) ) { ++cornerCount; }
+				}
+			}
 
-					SkipUntilNextDelim( &command, &ss );
+			std::vector<DirectX::XMFLOAT3> tmpPositions{};
+			std::vector<DirectX::XMFLOAT3> tmpNormals{};
+			std::vector<DirectX::XMFLOAT2> tmpTexCoords{};
+			tmpPositions.reserve( positionCount );
+			tmpNormals.reserve( normalCount );
+			tmpTexCoords.reserve( texCoordCount );
 
-					float u, v;
-					ss >> u;
-					ss >> v;
+			pVertices->reserve( pVertices->size() + cornerCount );
+			pIndices->reserve( pIndices->size() + cornerCount );
+			if ( pNormals	&& normalCount		) { pNormals->reserve( pNormals->size() + cornerCount );		}
+			if ( pTexCoords	&& texCoordCount	) { pTexCoords->reserve( pTexCoords->size() + cornerCount );	}
 
-					// tmpTexCoords.push_back( { u, v } );	// If obj-file is LH
-					tmpTexCoords.push_back( { u, -v } );	// If obj-file is RH
+			#pragma endregion
+
+			size_t		materialCount = 0;	// zero-based number.
+			Material	*usemtlTarget = nullptr;
+			std::unique_ptr<MtlFile> pMtllib{};
 
-					lastTexCoordIndex++;
+			for ( const char *pLine = pBegin; pLine < pEnd; )
+			{
+				ObjLineCursor line = NextLine( pLine );
+				pLine = ( line.end < pEnd ) ? line.end + 1 : pEnd;
 
-				#pragma endregion
+				tokenLength = line.ReadToken( &pToken );
+				if ( !tokenLength || *pToken == '#' )
+				{
+					// Empty line or comment.
 					continue;
 				}
 				// else
-				if ( IsContainStr( command, L"vn " ) )
+				if ( IsKeyword( pToken, tokenLength, "v" ) )
 				{
-				#pragma region Normal
-					if ( pNormals == nullptr ) { continue; }
-					// else
-
-					SkipUntilNextDelim( &command, &ss );
-
-					float x, y, z;
-					ss >> x;
-					ss >> y;
-					ss >> z;
+				#pragma region Vertex
 
-					tmpNormals.push_back( { x, y, z } );
+					XMFLOAT3 position{};
+					line.ReadFloat( &position.x );
+					line.ReadFloat( &position.y );
+					line.ReadFloat( &position.z );
 
-					lastNormalIndex++;
+					tmpPositions.emplace_back( position );
 
 				#pragma endregion
 					continue;
 				}
 				// else
-				if ( IsContainStr( command, L"usemtl " ) )
+				if ( IsKeyword( pToken, tokenLength, "vt" ) )
 				{
-				#pragma region usemtl
+				#pragma region TexCoord
 
-					SkipUntilNextDelim( &command, &ss );
-					command.erase( command.begin() );	// erase space.
-					ss.ignore();
+					float u = 0.0f, v = 0.0f;
+					line.ReadFloat( &u );
+					line.ReadFloat( &v );
 
-					if ( usemtlTarget != nullptr )
-					{
-						usemtlTarget->indexCount = materialCount;
+					// tmpTexCoords.push_back( { u, v } );	// If obj-file is LH
+					tmpTexCoords.push_back( { u, -v } );	// If obj-file is RH
 
-						usemtlTarget = nullptr;
-						materialCount = 0;
-					}
+				#pragma endregion
+					continue;
+				}
+				// else
+				if ( IsKeyword( pToken, tokenLength, "vn" ) )
+				{
+				#pragma region Normal
 
-					std::wstring materialName; ss >> materialName;
-					pMtllib->Extract( materialName, &usemtlTarget );
+					XMFLOAT3 normal{};
+					line.ReadFloat( &normal.x );
+					line.ReadFloat( &normal.y );
+					line.ReadFloat( &normal.z );
 
-					if ( usemtlTarget != nullptr )
-					{
-						usemtlTarget->indexStart = pIndices->size();
-					}
+					tmpNormals.emplace_back( normal );
 
 				#pragma endregion
 					continue;
 				}
 				// else
-				if ( IsContainStr( command, L"f " ) )
+				if ( IsKeyword( pToken, tokenLength, "f" ) )
 				{
 				#pragma region Face Indices
 
-					SkipUntilNextDelim( &command, &ss );
-
-					for ( ; !ss.eof(); )
+					// The corner is "v", "v/vt", "v//vn" or "v/vt/vn".
+					for ( line.SkipSpaces(); !line.IsEnd(); line.SkipSpaces() )
 					{
-						int index = NULL;
+						int		objIndex = 0;
+						size_t	index = 0;
 
 						// Vertex
 						{
-							ss >> index;
-							if ( index < 0 )
+							if ( !line.ReadInt( &objIndex ) || !ResolveObjIndex( objIndex, tmpPositions.size(), &index ) )
 							{
-								index++; // convert to minus-one-based.
-								index = lastVertexIndex + index;
+								_ASSERT_EXPR( 0, L"obj file error! : not found specified position-index until specify position." );
+								return false;
 							}
 
-							if ( pIndices->empty() )
-							{
-								pIndices->push_back( 0 );
-							}
-							else
-							{
-								pIndices->push_back( pIndices->back() + 1 );
-							}
+							pIndices->push_back( ( pIndices->empty() ) ? 0 : pIndices->back() + 1 );
 							materialCount++;
 
-							pVertices->push_back( tmpPositions[index - 1] ); // convert one-based -> zero-based.
+							pVertices->push_back( tmpPositions[index] );
 						}
 
-						if ( ss.peek() != L'/' ) { ss.ignore( 1024, L' ' ); continue; }
+						if ( line.Peek() != '/' ) { continue; }
 						// else
-						ss.ignore();
+						line.pos++;
 
 						// TexCoord
+						if ( line.Peek() != '/' )
 						{
-							ss >> index;
-							if ( index < 0 )
-							{
-								index++; // convert to minus-one-based.
-								index = lastTexCoordIndex + index;
-							}
-
-							if ( tmpTexCoords.size() < scast<size_t>( index ) )
+							if ( !line.ReadInt( &objIndex ) || !ResolveObjIndex( objIndex, tmpTexCoords.size(), &index ) )
 							{
-								_ASSERT_EXPR( 0, L"obj file error! : not found specified normal-index until specify position." );
-								return;
+								_ASSERT_EXPR( 0, L"obj file error! : not found specified texCoord-index until specify position." );
+								return false;
 							}
 
-							pTexCoords->push_back( tmpTexCoords[index - 1] ); // convert one-based -> zero-based.
+							if ( pTexCoords ) { pTexCoords->push_back( tmpTexCoords[index] ); }
 						}
 
-						if ( ss.peek() != L'/' ) { ss.ignore( 1024, L' ' ); continue; }
+						if ( line.Peek() != '/' ) { continue; }
 						// else
-						ss.ignore();
+						line.pos++;
 
 						// Normal
 						{
-							ss >> index;
-							if ( index < 0 )
-							{
-								index++; // convert to minus-one-based.
-								index = lastNormalIndex + index;
-							}
-
-							if ( tmpNormals.size() < scast<size_t>( index ) )
+							if ( !line.ReadInt( &objIndex ) || !ResolveObjIndex( objIndex, tmpNormals.size(), &index ) )
 							{
 								_ASSERT_EXPR( 0, L"obj file error! : not found specified normal-index until specify position." );
-								return;
+								return false;
 							}
 
-							pNormals->push_back( tmpNormals[index - 1] ); // convert one-based -> zero-based.
+							if ( pNormals ) { pNormals->push_back( tmpNormals[index] ); }
 						}
+					}
+
+				#pragma endregion
+					continue;
+				}
+				// else
+				if ( IsKeyword( pToken, tokenLength, "usemtl" ) )
+				{
+				#pragma region usemtl
+
+					if ( usemtlTarget != nullptr )
+					{
+						usemtlTarget->indexCount = materialCount;
+
+						usemtlTarget = nullptr;
+						materialCount = 0;
+					}
+
+					tokenLength = line.ReadToken( &pToken );
+					const std::wstring materialName = MultiToWide( std::string{ pToken, tokenLength } );
+					if ( pMtllib )
+					{
+						pMtllib->Extract( materialName, &usemtlTarget );
+					}
+
+					if ( usemtlTarget != nullptr )
+					{
+						usemtlTarget->indexStart = pIndices->size();
+					}
+
+				#pragma endregion
+					continue;
+				}
+				// else
+				if ( IsKeyword( pToken, tokenLength, "mtllib" ) )
+				{
+				#pragma region mtllib
 
-						ss.ignore();
+					std::wstring mtlPath = objFileName;
+					{
+						size_t lastTreePos = mtlPath.find_last_of( L"/" );
+						mtlPath = mtlPath.substr( 0, lastTreePos );
+						mtlPath += L"/";
 					}
 
+					tokenLength = line.ReadToken( &pToken );
+					const std::wstring mtlName = MultiToWide( std::string{ pToken, tokenLength } );
+
+					pMtllib = std::make_unique<MtlFile>( pDevice, mtlPath + mtlName );
+
 				#pragma endregion
 					continue;
 				}
 				// else
+
+				// "g", "s", "o" and the others are ignored.
 			}
 
 			if ( usemtlTarget != nullptr )
@@ -967,29 +1205,57 @@ namespace Donya
 				materialCount = 0;
 			}
 
+			if ( hasLoadedMtl != nullptr )
+			{
+				*hasLoadedMtl = ( pMtllib != nullptr );
+			}
+
 			if ( pMaterials != nullptr && pMtllib != nullptr )
 			{
 				pMtllib->CopyAllMaterialsToVector( pMaterials );
 			}
 
-			ifs.close();
+			file.Close();
+
+			return true;
+		}
+		void LoadObjFile( ID3D11Device *pDevice, const std::wstring &objFileName, std::vector<DirectX::XMFLOAT3> *pVertices, std::vector<DirectX::XMFLOAT3> *pNormals, std::vector<XMFLOAT2> *pTexCoords, std::vector<size_t> *pIndices, std::vector<Material> *pMaterials, bool *hasLoadedMtl, bool isEnableCache )
+		{
+			auto AssignCache = [&]( const ObjFileCacheContents &cache )
+			{
+				if ( pVertices ) { *pVertices = cache.vertices; }
+				if ( pNormals ) { *pNormals = cache.normals; }
+				if ( pTexCoords ) { *pTexCoords = cache.texCoords; }
+				if ( pIndices ) { *pIndices = cache.indices; }
+				if ( pMaterials ) { *pMaterials = cache.materials; }
+			};
+
+			// The outputs can not be filled if the cache was not found, so do not reserve the loading.
+			const bool canParse = ( pVertices != nullptr && pIndices != nullptr );
+			if ( objFileCache.Find( objFileName, isEnableCache && canParse, AssignCache ) ) { return; }
+			if ( !canParse ) { return; }
+			// else
+
+			// The parsing is done without the lock, so the other files can be loaded at the same time.
+			const bool succeeded = ParseObjFile( pDevice, objFileName, pVertices, pNormals, pTexCoords, pIndices, pMaterials, hasLoadedMtl );
 
 			if ( isEnableCache )
 			{
-				objFileCache.insert
-				(
-					std::make_pair
-					(
-						objFileName,
-						ObjFileCacheContents{ pVertices, pNormals, pTexCoords, pIndices, pMaterials }
-					)
-				);
+				if ( succeeded )
+				{
+					const ObjFileCacheContents loaded{ pVertices, pNormals, pTexCoords, pIndices, pMaterials };
+					objFileCache.FinishLoading( objFileName, &loaded );
+				}
+				else
+				{
+					objFileCache.FinishLoading( objFileName, nullptr );
+				}
 			}
 		}
 
 		void ReleaseAllObjFileCaches()
 		{
-			objFileCache.clear();
+			objFileCache.Clear();
 		}
 
 	#pragma endregion
@@ -9,6 +9,10 @@
 
 namespace Donya
 {
+	/// <summary>
+	/// The caches of these functions are guarded by each mutex, so these can be called from the loading threads.<para></para>
+	/// The textures and the OBJ files are loaded without the lock, and the threads that require the same file wait for the first one.
+	/// </summary>
 	namespace Resource
 	{
 	#pragma region Shader
@@ -5,12 +5,152 @@
 #include <memory>
 #include <sstream>
 
+#include <type_traits>
+#include <vector>
+
 #include "cereal/cereal.hpp"
 #include "cereal/archives/binary.hpp"
 #include "cereal/archives/json.hpp"
 
+#include "MappedFile.h"
+#include "Useful.h"
+
+/// <summary>
+/// The archive that can serialize the raw bytes by cereal::binary_data(), e.g. cereal::BinaryOutputArchive.
+/// </summary>
+template<class Archive>
+struct IsBinaryArchive : std::integral_constant
+<
+	bool,
+	cereal::traits::is_output_serializable<cereal::BinaryData<char *>, Archive>::value ||
+	cereal::traits::is_input_serializable<cereal::BinaryData<char *>, Archive>::value
+>
+{};
+
+/// <summary>
+/// Specialize this to std::true_type if the T can be serialized as the raw bytes(e.g. the struct of some floats).
+/// </summary>
+template<typename T>
+struct IsBulkSerializable : std::integral_constant<bool, std::is_arithmetic<T>::value> {};
+
+/// <summary>
+/// The wrapper of std::vector, that is serialized as one block of raw bytes by the binary archives.<para></para>
+/// The text archives(e.g. JSON) serialize each element as same as std::vector, so the output is still readable.<para></para>
+/// Please use via CEREAL_BULK_NVP() or MakeBulkVector().
+/// </summary>
+template<typename T>
+class BulkVector
+{
+	static_assert( IsBulkSerializable<T>::value, "The element must be specialized by IsBulkSerializable." );
+private:
+	std::vector<T> &vector;
+public:
+	BulkVector( std::vector<T> &vector ) : vector( vector ) {}
+public:
+	template<class Archive>
+	void save( Archive &archive ) const
+	{
+		Save( archive, IsBinaryArchive<Archive>{} );
+	}
+	template<class Archive>
+	void load( Archive &archive )
+	{
+		Load( archive, IsBinaryArchive<Archive>{} );
+	}
+private:
+	template<class Archive>
+	void Save( Archive &archive, std::true_type ) const
+	{
+		archive( cereal::make_size_tag( static_cast<cereal::size_type>( vector.size() ) ) );
+		archive( cereal::binary_data( vector.data(), vector.size() * sizeof( T ) ) );
+	}
+	template<class Archive>
+	void Save( Archive &archive, std::false_type ) const
+	{
+		archive( cereal::make_size_tag( static_cast<cereal::size_type>( vector.size() ) ) );
+		for ( const auto &it : vector )
+		{
+			archive( it );
+		}
+	}
+	template<class Archive>
+	void Load( Archive &archive, std::true_type )
+	{
+		cereal::size_type size{};
+		archive( cereal::make_size_tag( size ) );
+
+		vector.resize( static_cast<size_t>( size ) );
+		archive( cereal::binary_data( vector.data(), static_cast<size_t>( size ) * sizeof( T ) ) );
+	}
+	template<class Archive>
+	void Load( Archive &archive, std::false_type )
+	{
+		cereal::size_type size{};
+		archive( cereal::make_size_tag( size ) );
+
+		vector.resize( static_cast<size_t>( size ) );
+		for ( auto &it : vector )
+		{
+			archive( it );
+		}
+	}
+};
+template<typename T>
+BulkVector<T> MakeBulkVector( std::vector<T> &vector )
+{
+	return BulkVector<T>{ vector };
+}
+#define CEREAL_BULK_NVP( T ) ::cereal::make_nvp( #T, MakeBulkVector( T ) )
+
+/// <summary>
+/// The read-only std::streambuf over the memory(e.g. the memory-mapped file). It does not copy the memory.
+/// </summary>
+class MemoryStreamBuffer : public std::streambuf
+{
+public:
+	MemoryStreamBuffer() : std::streambuf() {}
+	MemoryStreamBuffer( const MemoryStreamBuffer & ) = delete;
+	MemoryStreamBuffer &operator = ( const MemoryStreamBuffer & ) = delete;
+public:
+	void Reset( const void *pData, size_t size )
+	{
+		// The get area is never written, so the const_cast is safe.
+		char *pBegin = const_cast<char *>( static_cast<const char *>( pData ) );
+		setg( pBegin, pBegin, pBegin + size );
+	}
+protected:
+	pos_type seekoff( off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode which ) override
+	{
+		if ( !( which & std::ios_base::in ) ) { return pos_type( off_type( -1 ) ); }
+		// else
+
+		char *pBase = nullptr;
+		switch ( direction )
+		{
+		case std::ios_base::beg: pBase = eback();	break;
+		case std::ios_base::cur: pBase = gptr();	break;
+		case std::ios_base::end: pBase = egptr();	break;
+		default: return pos_type( off_type( -1 ) );
+		}
+
+		char *pTarget = pBase + offset;
+		if ( pTarget < eback() || egptr() < pTarget ) { return pos_type( off_type( -1 ) ); }
+		// else
+
+		setg( eback(), pTarget, egptr() );
+		return pos_type( off_type( pTarget - eback() ) );
+	}
+	pos_type seekpos( pos_type position, std::ios_base::openmode which ) override
+	{
+		return seekoff( off_type( position ), std::ios_base::beg, which );
+	}
+};
+
 /// <summary>
-/// Ver 2019/09/14.
+/// Ver 2019/09/14.<para></para>
+/// The Load reads directly from the memory-mapped file(or the buffered file stream if can not map),
+/// and the Save writes directly to the buffered temporary file, then replaces the destination atomically.<para></para>
+/// So the whole file is never copied into the intermediate buffer.
 /// </summary>
 class Serializer
 {
@@ -20,42 +160,142 @@ public:
 		BINARY = 0,
 		JSON,
 	};
+private:
+	static constexpr size_t FILE_BUFFER_SIZE = 1024U * 64U;
+
+	/// <summary>
+	/// The input stream of a file.
+	/// </summary>
+	class InputSource
+	{
+	private:
+		Donya::MappedFile		mappedFile;
+		MemoryStreamBuffer		memoryBuffer;
+		std::istream			memoryStream;
+		std::vector<char>		fileBuffer;
+		std::ifstream			fileStream;
+		std::istream			*pStream;
+	public:
+		InputSource() : mappedFile(), memoryBuffer(), memoryStream( &memoryBuffer ), fileBuffer(), fileStream(), pStream( nullptr ) {}
+		InputSource( const InputSource & ) = delete;
+		InputSource &operator = ( const InputSource & ) = delete;
+	public:
+		bool Open( Extension extension, const char *fullFilePath )
+		{
+			if ( mappedFile.Open( std::string{ fullFilePath } ) )
+			{
+				memoryBuffer.Reset( mappedFile.GetData(), mappedFile.GetSize() );
+				pStream = &memoryStream;
+				return true;
+			}
+			// else
+
+			// The empty file can not be mapped. Read by the buffered stream.
+			fileBuffer.resize( FILE_BUFFER_SIZE );
+			fileStream.rdbuf()->pubsetbuf( fileBuffer.data(), fileBuffer.size() );
+
+			auto openMode = ( extension == Extension::BINARY ) ? std::ios::in | std::ios::binary : std::ios::in;
+			fileStream.open( fullFilePath, openMode );
+			if ( !fileStream.is_open() ) { return false; }
+			// else
+
+			pStream = &fileStream;
+			return true;
+		}
+		std::istream &GetStream() { return *pStream; }
+	};
+	/// <summary>
+	/// The output stream to a temporary file. Commit() replaces the destination by it.<para></para>
+	/// If not committed, the temporary file is removed at destructor, and the destination is not changed.
+	/// </summary>
+	class OutputSink
+	{
+	private:
+		std::string				destinationPath;
+		std::string				temporaryPath;
+		std::vector<char>		fileBuffer;
+		std::ofstream			fileStream;
+	public:
+		OutputSink() : destinationPath(), temporaryPath(), fileBuffer(), fileStream() {}
+		~OutputSink()
+		{
+			Discard();
+		}
+		OutputSink( const OutputSink & ) = delete;
+		OutputSink &operator = ( const OutputSink & ) = delete;
+	public:
+		bool Open( Extension extension, const char *fullFilePath )
+		{
+			destinationPath	= fullFilePath;
+			temporaryPath	= Donya::MakeTemporaryFilePath( destinationPath );
+
+			fileBuffer.resize( FILE_BUFFER_SIZE );
+			fileStream.rdbuf()->pubsetbuf( fileBuffer.data(), fileBuffer.size() );
+
+			auto openMode = ( extension == Extension::BINARY ) ? std::ios::out | std::ios::binary : std::ios::out;
+			fileStream.open( temporaryPath, openMode );
+			return fileStream.is_open();
+		}
+		std::ostream &GetStream() { return fileStream; }
+
+		bool Commit()
+		{
+			if ( !fileStream.is_open() ) { return false; }
+			// else
+
+			fileStream.close();
+			if ( fileStream.fail() )
+			{
+				Discard();
+				return false;
+			}
+			// else
+
+			const bool succeeded = Donya::ReplaceFileAtomically( temporaryPath, destinationPath );
+			temporaryPath.clear();
+			return succeeded;
+		}
+		void Discard()
+		{
+			if ( fileStream.is_open() ) { fileStream.close(); }
+			if ( !temporaryPath.empty() )
+			{
+				std::remove( temporaryPath.c_str() );
+				temporaryPath.clear();
+			}
+		}
+	};
 private:	// Use for Begin() ~ End() process.
 	Extension	ext;
-	std::unique_ptr<std::ifstream>					pIfs;
-	std::unique_ptr<std::ofstream>					pOfs;
-	std::unique_ptr<std::stringstream>				pSS;
+	std::unique_ptr<InputSource>					pInput;
+	std::unique_ptr<OutputSink>						pOutput;
 	std::unique_ptr<cereal::BinaryInputArchive>		pBinInArc;
 	std::unique_ptr<cereal::JSONInputArchive>		pJsonInArc;
 	std::unique_ptr<cereal::BinaryOutputArchive>	pBinOutArc;
 	std::unique_ptr<cereal::JSONOutputArchive>		pJsonOutArc;
 	bool isValid;	// It will be true while Begin() ~ End(), else false.
 public:
-	Serializer() : ext( BINARY ), pIfs( nullptr ), pSS( nullptr ), pBinInArc( nullptr ), pJsonInArc( nullptr ), pBinOutArc( nullptr ), pJsonOutArc( nullptr ), isValid( false )
+	Serializer() : ext( BINARY ), pInput( nullptr ), pOutput( nullptr ), pBinInArc( nullptr ), pJsonInArc( nullptr ), pBinOutArc( nullptr ), pJsonOutArc( nullptr ), isValid( false )
 	{}
 public:
 	template<class CLASS>
 	bool Load( Extension extension, const char *fullFilePath, const char *objectName, CLASS &instance ) const
 	{
-		auto openMode = ( extension == Extension::BINARY ) ? std::ios::in | std::ios::binary : std::ios::in;
-		std::ifstream ifs( fullFilePath, openMode );
-		if ( !ifs.is_open() ) { return false; }
+		InputSource input{};
+		if ( !input.Open( extension, fullFilePath ) ) { return false; }
 		// else
 
-		std::stringstream ss{};
-		ss << ifs.rdbuf();
-
 		switch ( extension )
 		{
 		case BINARY:
 			{
-				cereal::BinaryInputArchive binInArchive( ss );
+				cereal::BinaryInputArchive binInArchive( input.GetStream() );
 				binInArchive( cereal::make_nvp( objectName, instance ) );
 			}
 			break;
 		case JSON:
 			{
-				cereal::JSONInputArchive jsonInArchive( ss );
+				cereal::JSONInputArchive jsonInArchive( input.GetStream() );
 				jsonInArchive( cereal::make_nvp( objectName, instance ) );
 			}
 			break;
@@ -63,28 +303,28 @@ public:
 			return false;
 		}
 
-		ifs.close();
-		ss.clear();
-
 		return true;
 	}
 
 	template<class CLASS>
 	bool Save( Extension extension, const char *fullFilePath, const char *objectName, CLASS &instance ) const
 	{
-		std::stringstream ss{};
+		OutputSink output{};
+		if ( !output.Open( extension, fullFilePath ) ) { return false; }
+		// else
 
 		switch ( extension )
 		{
 		case BINARY:
 			{
-				cereal::BinaryOutputArchive binOutArchive( ss );
+				cereal::BinaryOutputArchive binOutArchive( output.GetStream() );
 				binOutArchive( cereal::make_nvp( objectName, instance ) );
 			}
 			break;
 		case JSON:
 			{
-				cereal::JSONOutputArchive jsonOutArchive( ss );
+				// The JSON archive is completed at destructor.
+				cereal::JSONOutputArchive jsonOutArchive( output.GetStream() );
 				jsonOutArchive( cereal::make_nvp( objectName, instance ) );
 			}
 			break;
@@ -92,17 +332,7 @@ public:
 			return false;
 		}
 
-		auto openMode = ( extension == Extension::BINARY ) ? std::ios::out | std::ios::binary : std::ios::out;
-		std::ofstream ofs( fullFilePath, openMode );
-		if ( !ofs.is_open() ) { return false; }
-		// else
-
-		ofs << ss.str();
-
-		ofs.close();
-		ss.clear();
-
-		return true;
+		return output.Commit();
 	}
 public:
 	bool LoadBegin( Extension extension, const char *fullFilePath )
@@ -118,24 +348,25 @@ public:
 		}
 		// else
 
-		auto openMode = ( extension == Extension::BINARY ) ? std::ios::in | std::ios::binary : std::ios::in;
-		pIfs = std::make_unique<std::ifstream>( fullFilePath, openMode );
-		if ( !pIfs->is_open() ) { return false; }
+		pInput = std::make_unique<InputSource>();
+		if ( !pInput->Open( extension, fullFilePath ) )
+		{
+			pInput.reset( nullptr );
+			return false;
+		}
 		// else
 
-		pSS = std::make_unique<std::stringstream>();
-		*pSS << pIfs->rdbuf();
-
 		ext = extension;
 		switch ( extension )
 		{
 		case BINARY:
-			pBinInArc  = std::make_unique<cereal::BinaryInputArchive>( *pSS );
+			pBinInArc  = std::make_unique<cereal::BinaryInputArchive>( pInput->GetStream() );
 			break;
 		case JSON:
-			pJsonInArc = std::make_unique<cereal::JSONInputArchive>( *pSS );
+			pJsonInArc = std::make_unique<cereal::JSONInputArchive>( pInput->GetStream() );
 			break;
 		default:
+			pInput.reset( nullptr );
 			return false;
 		}
 
@@ -186,11 +417,7 @@ public:
 			break;
 		}
 
-		pIfs->close();
-		pSS->clear();
-
-		pIfs.reset( nullptr );
-		pSS.reset( nullptr );
+		pInput.reset( nullptr );
 
 		isValid  = false;
 	}
@@ -208,26 +435,28 @@ public:
 		}
 		// else
 
-		pSS = std::make_unique<std::stringstream>();
+		pOutput = std::make_unique<OutputSink>();
+		if ( !pOutput->Open( extension, fullFilePath ) )
+		{
+			pOutput.reset( nullptr );
+			return false;
+		}
+		// else
 
 		ext = extension;
 		switch ( extension )
 		{
 		case BINARY:
-			pBinOutArc  = std::make_unique<cereal::BinaryOutputArchive>( *pSS );
+			pBinOutArc  = std::make_unique<cereal::BinaryOutputArchive>( pOutput->GetStream() );
 			break;
 		case JSON:
-			pJsonOutArc = std::make_unique<cereal::JSONOutputArchive>( *pSS );
+			pJsonOutArc = std::make_unique<cereal::JSONOutputArchive>( pOutput->GetStream() );
 			break;
 		default:
+			pOutput.reset( nullptr );
 			return false;
 		}
 
-		auto openMode = ( extension == Extension::BINARY ) ? std::ios::out | std::ios::binary : std::ios::out;
-		pOfs = std::make_unique<std::ofstream>( fullFilePath, openMode );
-		if ( !pOfs->is_open() ) { return false; }
-		// else
-
 		isValid = true;
 
 		return true;
@@ -258,11 +487,15 @@ public:
 		return true;
 	}
 
-	void SaveEnd()
+	/// <summary>
+	/// Returns false if failed to write or replace the file.
+	/// </summary>
+	bool SaveEnd()
 	{
-		if ( !isValid ) { return; }
+		if ( !isValid ) { return false; }
 		// else
 
+		// The archives flush(the JSON archive is completed) at destructor, so destroy those before commit.
 		switch ( ext )
 		{
 		case BINARY:
@@ -275,14 +508,11 @@ public:
 			break;
 		}
 
-		*pOfs << pSS->str();
-
-		pOfs->close();
-		pSS->clear();
-
-		pOfs.reset( nullptr );
-		pSS.reset( nullptr );
+		const bool succeeded = pOutput->Commit();
+		pOutput.reset( nullptr );
 
 		isValid = false;
+
+		return succeeded;
 	}
 };
@@ -1,16 +1,182 @@
 #include "SkinnedMesh.h"
 
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
 #include "Common.h"
 #include "Direct3DUtil.h"
 #include "Donya.h"
 #include "Loader.h"
 #include "Resource.h"
 #include "Useful.h"
+#include "VertexQuantization.h"
 
 using namespace DirectX;
 
 namespace Donya
 {
+	/// <summary>
+	/// Packs the strongest influences into the vertex.<para></para>
+	/// The imported influences are already limited and sorted, but the old serialized data may not be, so I select those here also.<para></para>
+	/// The influence that the bone index is over 255 can not be packed(the importer compacts the bindings so the indices fit in usual),
+	/// so it is ignored and the weights of the others are renormalized. Returns the count of those ignored influences.
+	/// </summary>
+	size_t PackBoneInfluences( const Loader::BoneInfluence *pInfluences, size_t influenceCount, SkinnedMesh::Vertex *pVertex )
+	{
+		constexpr size_t MAX_COUNT = SkinnedMesh::MAX_BONE_INFLUENCES;
+		size_t unpackableCount = 0;
+
+		// Insertion into the small array that is sorted by weight in descending order.
+		std::array<Loader::BoneInfluence, MAX_COUNT> strongest{};
+		size_t strongestCount = 0;
+		for ( size_t i = 0; i < influenceCount; ++i )
+		{
+			const Loader::BoneInfluence &influence = pInfluences[i];
+			if ( UINT8_MAX < influence.index && 0.0f < influence.weight ) { ++unpackableCount; }
+			if ( influence.index < 0 || UINT8_MAX < influence.index || influence.weight <= 0.0f ) { continue; }
+			// else
+
+			size_t insertPos = strongestCount;
+			while ( insertPos && strongest[insertPos - 1].weight < influence.weight )
+			{
+				--insertPos;
+			}
+			if ( MAX_COUNT <= insertPos ) { continue; }
+			// else
+
+			const size_t lastPos = ( strongestCount < MAX_COUNT ) ? strongestCount : MAX_COUNT - 1;
+			for ( size_t k = lastPos; insertPos < k; --k )
+			{
+				strongest[k] = strongest[k - 1];
+			}
+			strongest[insertPos] = influence;
+
+			if ( strongestCount < MAX_COUNT ) { ++strongestCount; }
+		}
+
+		if ( !strongestCount ) { return unpackableCount; } // Keep the default, that is fully influenced by the bone 0.
+		// else
+
+		float sum = 0.0f;
+		for ( size_t k = 0; k < strongestCount; ++k )
+		{
+			sum += strongest[k].weight;
+		}
+
+		// Quantize to UNORM8, then give the rounding error to the strongest one, so the sum is exactly 255.
+		int quantizedSum = 0;
+		for ( size_t k = 0; k < MAX_COUNT; ++k )
+		{
+			int quantized = 0;
+			int boneIndex = 0;
+			if ( k < strongestCount )
+			{
+				quantized = scast<int>( strongest[k].weight / sum * 255.0f + 0.5f );
+				boneIndex = strongest[k].index;
+			}
+
+			pVertex->boneIndices[k] = scast<std::uint8_t>( boneIndex );
+			pVertex->boneWeights[k] = scast<std::uint8_t>( quantized );
+			quantizedSum += quantized;
+		}
+		pVertex->boneWeights[0] = scast<std::uint8_t>( pVertex->boneWeights[0] + 255 - quantizedSum );
+
+		return unpackableCount;
+	}
+
+	/// <summary>
+	/// Returns the pixels per unit of the mesh space, at the nearest point of the bounds of mesh. So the projected error is conservative.<para></para>
+	/// Returns negative value if the bounds reaches behind the eye, then the full resolution should be used.
+	/// </summary>
+	float CalcPixelsPerUnit( const DirectX::XMFLOAT4X4 &meshWVP, const SkinnedMesh::Mesh &mesh )
+	{
+		constexpr float MIN_W = 1.0e-4f;
+
+		const DirectX::XMFLOAT4X4 &m = meshWVP;
+		const DirectX::XMFLOAT3 &offset	= mesh.positionOffset;
+		const DirectX::XMFLOAT3 &scale	= mesh.positionScale;
+		const DirectX::XMFLOAT3 center
+		{
+			offset.x + scale.x * 0.5f,
+			offset.y + scale.y * 0.5f,
+			offset.z + scale.z * 0.5f
+		};
+		const float radius = 0.5f * sqrtf( scale.x * scale.x + scale.y * scale.y + scale.z * scale.z );
+
+		// The row vector is transformed as "v * m", so the w of clip space is the dot with the fourth column.
+		const float centerW		= center.x * m._14 + center.y * m._24 + center.z * m._34 + m._44;
+		const float nearestW	= centerW - radius * sqrtf( m._14 * m._14 + m._24 * m._24 + m._34 * m._34 );
+		if ( nearestW <= MIN_W ) { return -1.0f; }
+		// else
+
+		const float pixelsX = sqrtf( m._11 * m._11 + m._21 * m._21 + m._31 * m._31 ) * Common::HalfScreenWidthF();
+		const float pixelsY = sqrtf( m._12 * m._12 + m._22 * m._22 + m._32 * m._32 ) * Common::HalfScreenHeightF();
+		return ( ( pixelsX < pixelsY ) ? pixelsY : pixelsX ) / nearestW;
+	}
+
+	/// <summary>
+	/// Returns the matrix that transforms from the space of bounds(the globalTransform is applied) into world space.<para></para>
+	/// The rendering applies the coordinateConversion before the globalTransform, so it is put between the inverse of globalTransform and the globalTransform.
+	/// </summary>
+	DirectX::XMFLOAT4X4 CalcBoundsToWorld( const SkinnedMesh::Mesh &mesh, const DirectX::XMFLOAT4X4 &world )
+	{
+		const DirectX::XMMATRIX global		= DirectX::XMLoadFloat4x4( &mesh.globalTransform );
+		const DirectX::XMMATRIX conversion	= DirectX::XMLoadFloat4x4( &mesh.coordinateConversion );
+
+		DirectX::XMVECTOR determinant{};
+		const DirectX::XMMATRIX inverseGlobal = DirectX::XMMatrixInverse( &determinant, global );
+
+		// The degenerated globalTransform can not be undone, then the conversion is ignored.
+		const DirectX::XMMATRIX boundsToModel = ( ZeroEqual( DirectX::XMVectorGetX( determinant ) ) )
+		? DirectX::XMMatrixIdentity()
+		: inverseGlobal * conversion * global;
+
+		DirectX::XMFLOAT4X4 rv{};
+		DirectX::XMStoreFloat4x4( &rv, boundsToModel * DirectX::XMLoadFloat4x4( &world ) );
+		return rv;
+	}
+
+	/// <summary>
+	/// The radius is scaled by the largest scale of the axes, so the transformed sphere is conservative.
+	/// </summary>
+	DirectX::XMFLOAT4 TransformSphere( const DirectX::XMFLOAT4 &sphere, const DirectX::XMFLOAT4X4 &matrix )
+	{
+		const DirectX::XMMATRIX m = DirectX::XMLoadFloat4x4( &matrix );
+
+		DirectX::XMFLOAT4 rv{};
+		DirectX::XMStoreFloat4( &rv, DirectX::XMVector3Transform( DirectX::XMVectorSet( sphere.x, sphere.y, sphere.z, 1.0f ), m ) );
+
+		const float scaleSqX = DirectX::XMVectorGetX( DirectX::XMVector3LengthSq( m.r[0] ) );
+		const float scaleSqY = DirectX::XMVectorGetX( DirectX::XMVector3LengthSq( m.r[1] ) );
+		const float scaleSqZ = DirectX::XMVectorGetX( DirectX::XMVector3LengthSq( m.r[2] ) );
+		rv.w = sphere.w * sqrtf( std::max( scaleSqX, std::max( scaleSqY, scaleSqZ ) ) );
+		return rv;
+	}
+
+	/// <summary>
+	/// Selects the LOD level from the previous level, so the level does not flicker at the boundary of the threshold.
+	/// </summary>
+	size_t SelectLODLevel( const SkinnedMesh::Mesh &mesh, float pixelsPerUnit, float pixelErrorThreshold )
+	{
+		// The coarser level is chosen only when the error of it is enough less than the threshold.
+		constexpr float HYSTERESIS = 0.75f;
+
+		if ( pixelsPerUnit < 0.0f || pixelErrorThreshold <= 0.0f ) { return 0; }
+		// else
+
+		size_t level = ( mesh.lodLevel < mesh.lods.size() ) ? mesh.lodLevel : mesh.lods.size();
+		while ( level && pixelErrorThreshold < mesh.lods[level - 1].error * pixelsPerUnit )
+		{
+			--level;
+		}
+		while ( level < mesh.lods.size() && mesh.lods[level].error * pixelsPerUnit <= pixelErrorThreshold * HYSTERESIS )
+		{
+			++level;
+		}
+		return level;
+	}
+
 	bool SkinnedMesh::Create( const Loader *loader, SkinnedMesh *pOutput )
 	{
 		if ( !loader || !pOutput ) { return false; }
@@ -19,7 +185,9 @@ namespace Donya
 		const std::vector<Loader::Mesh> *pLoadedMeshes = loader->GetMeshes();
 		size_t loadedMeshCount = pLoadedMeshes->size();
 
-		std::vector<std::vector<size_t>> argIndices{};
+		// The indices are not copied, these are uploaded from the loader's storage(or the mapped file) directly.
+		std::vector<Donya::ArrayView<std::uint16_t>> argIndices16{};
+		std::vector<Donya::ArrayView<std::uint32_t>> argIndices32{};
 		std::vector<std::vector<Vertex>> argVertices{};
 
 		std::vector<SkinnedMesh::Mesh> meshes{};
@@ -27,38 +195,76 @@ namespace Donya
 		for ( size_t i = 0; i < loadedMeshCount; ++i )
 		{
 			auto &loadedMesh = ( *pLoadedMeshes )[i];
+			const Loader::MeshView loadedView = loader->GetMeshView( i );
 
 			meshes[i].coordinateConversion = loadedMesh.coordinateConversion;
 			meshes[i].globalTransform = loadedMesh.globalTransform;
 
 			std::vector<Vertex> vertices{};
 			{
-				const std::vector<Donya::Vector3> &normals   = loadedMesh.normals;
-				const std::vector<Donya::Vector3> &positions = loadedMesh.positions;
-				const std::vector<Donya::Vector2> &texCoords = loadedMesh.texCoords;
-				const std::vector<Loader::BoneInfluencesPerControlPoint> &boneInfluences = loadedMesh.influences;
-
-				vertices.resize( std::max( normals.size(), positions.size() ) );
+				const Donya::ArrayView<Donya::Vector3> &normals   = loadedView.normals;
+				const Donya::ArrayView<Donya::Vector3> &positions = loadedView.positions;
+				const Donya::ArrayView<Donya::Vector2> &texCoords = loadedView.texCoords;
+				const Donya::ArrayView<std::uint32_t>			&influenceOffsets = loadedView.influenceOffsets;
+				const Donya::ArrayView<Loader::BoneInfluence>	&influenceEntries = loadedView.influenceEntries;
+
+				// The positions are quantized relative to the bounds, the shader restores those by the frame.
+				const VertexQuantization::PositionFrame frame = VertexQuantization::MakePositionFrame( positions );
+				meshes[i].positionOffset	= frame.offset;
+				meshes[i].positionScale		= frame.scale;
+
+				vertices.resize( std::min( normals.size(), positions.size() ) );
+				size_t unpackableCount = 0;
 				size_t end = vertices.size();
 				for ( size_t j = 0; j < end; ++j )
 				{
-					vertices[j].normal		= normals[j];
-					vertices[j].pos			= positions[j];
-					
-					vertices[j].texCoord	= ( j < texCoords.size() )
-											? texCoords[j]
-											: Donya::Vector2{};
+					const VertexQuantization::QuantizedPosition		pos		= VertexQuantization::EncodePosition( positions[j], frame );
+					const VertexQuantization::OctahedralNormal16	normal	= VertexQuantization::EncodeNormal16( normals[j] );
+					vertices[j].pos			= { pos.x, pos.y, pos.z, 0 };
+					vertices[j].normal		= { normal.x, normal.y };
 
-					size_t influenceCount = boneInfluences[j].cluster.size();
-					for ( size_t k = 0; k < influenceCount; ++k )
-					{
-						vertices[j].boneIndices[k] = boneInfluences[j].cluster[k].index;
-						vertices[j].boneWeights[k] = boneInfluences[j].cluster[k].weight;
-					}
+					const VertexQuantization::HalfTexCoord texCoord = ( j < texCoords.size() )
+											? VertexQuantization::EncodeTexCoord( texCoords[j] )
+											: VertexQuantization::HalfTexCoord{};
+					vertices[j].texCoord	= { texCoord.u, texCoord.v };
+
+					if ( influenceOffsets.size() <= j + 1 ) { continue; }
+					// else
+
+					const std::uint32_t influenceBegin = influenceOffsets[j];
+					unpackableCount += PackBoneInfluences
+					(
+						influenceEntries.data() + influenceBegin,
+						influenceOffsets[j + 1] - influenceBegin,
+						&vertices[j]
+					);
+				}
+
+				if ( unpackableCount )
+				{
+					const std::string message = "[SkinnedMesh] Mesh[" + std::to_string( i ) + "] uses the bones over 256, "
+											  + std::to_string( unpackableCount ) + " influences are ignored.\n";
+					OutputDebugStringA( message.c_str() );
 				}
 			}
-			argVertices.emplace_back( vertices );
-			argIndices.emplace_back( loadedMesh.indices );
+			argVertices.emplace_back( std::move( vertices ) );
+
+			// The empty bounds is never culled.
+			auto ToSphere = []( const Loader::Bounds &bounds )
+			{
+				return ( bounds.IsEmpty() )
+				? DirectX::XMFLOAT4{ 0.0f, 0.0f, 0.0f, FLT_MAX }
+				: DirectX::XMFLOAT4{ bounds.center.x, bounds.center.y, bounds.center.z, bounds.radius };
+			};
+			meshes[i].boundingSphere = ToSphere( loadedMesh.bounds );
+			for ( const auto &it : loadedMesh.subsets )
+			{
+				meshes[i].subsetSpheres.emplace_back( ToSphere( it.bounds ) );
+			}
+
+			argIndices16.emplace_back( loadedView.indices16 );
+			argIndices32.emplace_back( loadedView.indices );
+			meshes[i].indexFormat = ( loadedView.IsIndex16() ) ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
 			
 			size_t subsetCount = loadedMesh.subsets.size();
 			meshes[i].subsets.resize( subsetCount );
@@ -94,14 +300,28 @@ namespace Donya
 				FetchMaterialContain( &mySubset.specular,	loadedSubset.specular	);
 				mySubset.specular.color.w = loadedSubset.specular.color.w;
 			}
+
+			meshes[i].lods.resize( loadedMesh.lods.size() );
+			for ( size_t j = 0; j < loadedMesh.lods.size(); ++j )
+			{
+				const auto	&loadedLevel	= loadedMesh.lods[j];
+				auto		&myLevel		= meshes[i].lods[j];
+
+				myLevel.error = loadedLevel.error;
+				for ( const auto &range : loadedLevel.subsetRanges )
+				{
+					myLevel.indexStarts.emplace_back( range.indexStart );
+					myLevel.indexCounts.emplace_back( range.indexCount );
+				}
+			}
 		} // meshs loop
 
-		pOutput->Init( argIndices, argVertices, meshes );
+		pOutput->Init( argIndices16, argIndices32, argVertices, meshes );
 
 		return true;
 	}
 
-	SkinnedMesh::SkinnedMesh() : meshes(),
+	SkinnedMesh::SkinnedMesh() : meshes(), lodPixelError( 1.0f ), cullingStatistics(),
 		iConstantBuffer(), iMaterialCBuffer(),
 		iInputLayout(), iVertexShader(), iPixelShader(),
 		iRasterizerStateWire(), iRasterizerStateSurface(), iDepthStencilState()
@@ -114,7 +334,7 @@ namespace Donya
 		meshes.shrink_to_fit();
 	}
 
-	bool SkinnedMesh::Init( const std::vector<std::vector<size_t>> &allIndices, const std::vector<std::vector<Vertex>> &allVertices, const std::vector<Mesh> &loadedMeshes )
+	bool SkinnedMesh::Init( const std::vector<Donya::ArrayView<std::uint16_t>> &allIndices16, const std::vector<Donya::ArrayView<std::uint32_t>> &allIndices32, const std::vector<std::vector<Vertex>> &allVertices, const std::vector<Mesh> &loadedMeshes )
 	{
 		if ( !meshes.empty() ) { return false; }
 		// else
@@ -139,13 +359,27 @@ namespace Donya
 		// Create IndexBuffers
 		for ( size_t i = 0; i < meshCount; ++i )
 		{
-			hr = CreateIndexBuffer
-			(
-				pDevice,
-				allIndices[i],
-				meshes[i].iIndexBuffer.GetAddressOf()
-			);
-			_ASSERT_EXPR( SUCCEEDED( hr ), L"Failed : Create Vertex-Buffer" );
+			if ( meshes[i].indexFormat == DXGI_FORMAT_R16_UINT )
+			{
+				hr = CreateIndexBuffer
+				(
+					pDevice,
+					allIndices16[i].data(),
+					allIndices16[i].size(),
+					meshes[i].iIndexBuffer.GetAddressOf()
+				);
+			}
+			else
+			{
+				hr = CreateIndexBuffer
+				(
+					pDevice,
+					allIndices32[i].data(),
+					allIndices32[i].size(),
+					meshes[i].iIndexBuffer.GetAddressOf()
+				);
+			}
+			_ASSERT_EXPR( SUCCEEDED( hr ), L"Failed : Create Index-Buffer" );
 		}
 		// Create ConstantBuffers
 		{
@@ -169,11 +403,11 @@ namespace Donya
 		{
 			D3D11_INPUT_ELEMENT_DESC d3d11InputElementsDesc[] =
 			{
-				{ "POSITION"	, 0, DXGI_FORMAT_R32G32B32_FLOAT,		0, D3D11_APPEND_ALIGNED_ELEMENT,	D3D11_INPUT_PER_VERTEX_DATA, 0 },
-				{ "NORMAL"		, 0, DXGI_FORMAT_R32G32B32_FLOAT,		0, D3D11_APPEND_ALIGNED_ELEMENT,	D3D11_INPUT_PER_VERTEX_DATA, 0 },
-				{ "TEXCOORD"	, 0, DXGI_FORMAT_R32G32_FLOAT,			0, D3D11_APPEND_ALIGNED_ELEMENT,	D3D11_INPUT_PER_VERTEX_DATA, 0 },
-				{ "BONES"		, 0, DXGI_FORMAT_R32G32B32A32_UINT,		0, D3D11_APPEND_ALIGNED_ELEMENT,	D3D11_INPUT_PER_VERTEX_DATA, 0 },
-				{ "WEIGHTS"		, 0, DXGI_FORMAT_R32G32B32A32_FLOAT,	0, D3D11_APPEND_ALIGNED_ELEMENT,	D3D11_INPUT_PER_VERTEX_DATA, 0 },
+				{ "POSITION"	, 0, DXGI_FORMAT_R16G16B16A16_UNORM,	0, D3D11_APPEND_ALIGNED_ELEMENT,	D3D11_INPUT_PER_VERTEX_DATA, 0 },
+				{ "NORMAL"		, 0, DXGI_FORMAT_R16G16_SNORM,			0, D3D11_APPEND_ALIGNED_ELEMENT,	D3D11_INPUT_PER_VERTEX_DATA, 0 },
+				{ "TEXCOORD"	, 0, DXGI_FORMAT_R16G16_FLOAT,			0, D3D11_APPEND_ALIGNED_ELEMENT,	D3D11_INPUT_PER_VERTEX_DATA, 0 },
+				{ "BONES"		, 0, DXGI_FORMAT_R8G8B8A8_UINT,			0, D3D11_APPEND_ALIGNED_ELEMENT,	D3D11_INPUT_PER_VERTEX_DATA, 0 },
+				{ "WEIGHTS"		, 0, DXGI_FORMAT_R8G8B8A8_UNORM,		0, D3D11_APPEND_ALIGNED_ELEMENT,	D3D11_INPUT_PER_VERTEX_DATA, 0 },
 			};
 
 			Resource::CreateVertexShaderFromCso
@@ -307,8 +541,30 @@ namespace Donya
 		return true;
 	}
 
-	void SkinnedMesh::Render( const DirectX::XMFLOAT4X4 &worldViewProjection, const DirectX::XMFLOAT4X4 &world, const DirectX::XMFLOAT4 &eyePosition, const DirectX::XMFLOAT4 &lightColor, const DirectX::XMFLOAT4 &lightDirection, bool isEnableFill )
+	DirectX::XMFLOAT4X4 SkinnedMesh::CalcMeshToWorld( size_t meshIndex, const DirectX::XMFLOAT4X4 &world ) const
+	{
+		_ASSERT_EXPR( meshIndex < meshes.size(), L"Error : The mesh index is out of range." );
+
+		const Mesh &mesh = meshes[meshIndex];
+
+		DirectX::XMFLOAT4X4 rv{};
+		DirectX::XMStoreFloat4x4
+		(
+			&rv,
+			DirectX::XMLoadFloat4x4( &mesh.coordinateConversion ) * DirectX::XMLoadFloat4x4( &mesh.globalTransform ) * DirectX::XMLoadFloat4x4( &world )
+		);
+		return rv;
+	}
+
+	void SkinnedMesh::SetLODPixelError( float pixels )
 	{
+		lodPixelError = pixels;
+	}
+
+	void SkinnedMesh::Render( const DirectX::XMFLOAT4X4 &worldViewProjection, const DirectX::XMFLOAT4X4 &world, const DirectX::XMFLOAT4 &eyePosition, const DirectX::XMFLOAT4 &lightColor, const DirectX::XMFLOAT4 &lightDirection, bool isEnableFill, const Donya::Frustum *pWorldFrustum )
+	{
+		cullingStatistics = CullingStatistics{};
+
 		if ( meshes.empty() ) { return; }
 		// else
 
@@ -321,6 +577,12 @@ namespace Donya
 			if ( ImGui::BeginIfAllowed( "SkinnedMesh" ) )
 			// if ( ImGui::BeginIfAllowed() )
 			{
+				ImGui::SliderFloat( "LOD Pixel Error", &lodPixelError, 0.0f, 16.0f );
+				for ( size_t i = 0; i < meshes.size(); ++i )
+				{
+					ImGui::Text( "Mesh[%d]:[LOD:%d/%d]", scast<int>( i ), scast<int>( meshes[i].lodLevel ), scast<int>( meshes[i].lods.size() ) );
+				}
+
 				if ( ImGui::TreeNode( "CoordinateConversion" ) )
 				{
 					ImGui::SliderFloat4( "11, 12, 13, 14", &coordConversion._11, -1.0f, 1.0f );
@@ -384,8 +646,48 @@ namespace Donya
 			pImmediateContext->OMSetDepthStencilState( iDepthStencilState.Get(), 0xffffffff );
 		}
 
-		for ( auto &mesh : meshes )
+		const size_t meshCount = meshes.size();
+
+		// The spheres of meshes are tested at once in world space.
+		std::vector<DirectX::XMFLOAT4X4>	boundsToWorlds( meshCount );
+		std::vector<std::uint8_t>			meshVisibles( meshCount, 1 );
+		if ( pWorldFrustum )
+		{
+			std::vector<DirectX::XMFLOAT4> worldSpheres( meshCount );
+			for ( size_t i = 0; i < meshCount; ++i )
+			{
+				boundsToWorlds[i]	= CalcBoundsToWorld( meshes[i], world );
+				worldSpheres[i]		= TransformSphere( meshes[i].boundingSphere, boundsToWorlds[i] );
+			}
+			pWorldFrustum->TestSpheres( worldSpheres.data(), meshCount, meshVisibles.data() );
+		}
+
+		std::vector<std::uint8_t> subsetVisibles{};
+		for ( size_t i = 0; i < meshCount; ++i )
 		{
+			auto &mesh = meshes[i];
+			const size_t subsetCount = mesh.subsets.size();
+
+			// The spheres of subsets are tested in the space of bounds, the frustum is transformed instead of those.
+			subsetVisibles.assign( subsetCount, meshVisibles[i] );
+			if ( pWorldFrustum && meshVisibles[i] )
+			{
+				const Donya::Frustum boundsFrustum = pWorldFrustum->Transformed( boundsToWorlds[i] );
+				const size_t testCount = ( mesh.subsetSpheres.size() < subsetCount ) ? mesh.subsetSpheres.size() : subsetCount;
+				boundsFrustum.TestSpheres( mesh.subsetSpheres.data(), testCount, subsetVisibles.data() );
+			}
+
+			const size_t visibleSubsetCount = scast<size_t>( std::count( subsetVisibles.begin(), subsetVisibles.end(), scast<std::uint8_t>( 1 ) ) );
+			cullingStatistics.drawnSubsets	+= visibleSubsetCount;
+			cullingStatistics.culledSubsets	+= subsetCount - visibleSubsetCount;
+			if ( !visibleSubsetCount )
+			{
+				++cullingStatistics.culledMeshes;
+				continue;
+			}
+			// else
+			++cullingStatistics.drawnMeshes;
+
 			// Update Constant Buffer
 			{
 				auto Mul4x4 =
@@ -404,10 +706,14 @@ namespace Donya
 				ConstantBuffer cb;
 				cb.worldViewProjection	= Mul4x4( Mul4x4( mesh.coordinateConversion, mesh.globalTransform ), worldViewProjection );
 				cb.world				= Mul4x4( Mul4x4( mesh.coordinateConversion, mesh.globalTransform ), world );
+				cb.positionOffset		= DirectX::XMFLOAT4{ mesh.positionOffset.x, mesh.positionOffset.y, mesh.positionOffset.z, 0.0f };
+				cb.positionScale		= DirectX::XMFLOAT4{ mesh.positionScale.x,  mesh.positionScale.y,  mesh.positionScale.z,  0.0f };
 				cb.lightColor			= lightColor;
 				cb.lightDir				= lightDirection;
 				// cb.eyePosition			= eyePosition;
 				pImmediateContext->UpdateSubresource( iConstantBuffer.Get(), 0, nullptr, &cb, 0, 0 );
+
+				mesh.lodLevel = SelectLODLevel( mesh, CalcPixelsPerUnit( cb.worldViewProjection, mesh ), lodPixelError );
 			}
 			pImmediateContext->VSSetConstantBuffers( 0, 1, iConstantBuffer.GetAddressOf() );
 			pImmediateContext->PSSetConstantBuffers( 0, 1, iConstantBuffer.GetAddressOf() );
@@ -415,10 +721,17 @@ namespace Donya
 			UINT stride = sizeof( Vertex );
 			UINT offset = 0;
 			pImmediateContext->IASetVertexBuffers( 0, 1, mesh.iVertexBuffer.GetAddressOf(), &stride, &offset );
-			pImmediateContext->IASetIndexBuffer( mesh.iIndexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0 );
+			pImmediateContext->IASetIndexBuffer( mesh.iIndexBuffer.Get(), mesh.indexFormat, 0 );
+
+			const LODLevel *pLevel = ( mesh.lodLevel ) ? &mesh.lods[mesh.lodLevel - 1] : nullptr;
 
-			for ( auto &subset : mesh.subsets )
+			for ( size_t j = 0; j < subsetCount; ++j )
 			{
+				if ( !subsetVisibles[j] ) { continue; }
+				// else
+
+				auto &subset = mesh.subsets[j];
+
 				// Update Material-Constant Buffer
 				{
 					MaterialConstantBuffer mtlCB{};
@@ -441,7 +754,14 @@ namespace Donya
 				{
 					pImmediateContext->PSSetShaderResources( 0, 1, texture.iSRV.GetAddressOf() );
 					
-					pImmediateContext->DrawIndexed( subset.indexCount, subset.indexStart, 0 );
+					if ( pLevel && j < pLevel->indexStarts.size() )
+					{
+						pImmediateContext->DrawIndexed( pLevel->indexCounts[j], pLevel->indexStarts[j], 0 );
+					}
+					else
+					{
+						pImmediateContext->DrawIndexed( subset.indexCount, subset.indexStart, 0 );
+					}
 				}
 			}
 		}
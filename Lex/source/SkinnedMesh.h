@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
 #include <d3d11.h>
 #include <DirectXMath.h>
 #include <memory>
@@ -8,10 +9,16 @@
 #include <vector>
 #include <wrl.h>
 
+#include "ArrayView.h"
+#include "Frustum.h"
+
 namespace Donya
 {
 	class Loader;
 
+	/// <summary>
+	/// It can only move. The instance owns the GPU resources that made by Create().
+	/// </summary>
 	class SkinnedMesh
 	{
 	public:
@@ -22,19 +29,28 @@ namespace Donya
 		static bool Create( const Loader *loader, SkinnedMesh *pOutput );
 	public:
 		static constexpr const int MAX_BONE_INFLUENCES = 4;
+		/// <summary>
+		/// The attributes are quantized(24 bytes per vertex), the vertex shader decodes those.<para></para>
+		/// The pos is R16G16B16A16_UNORM relative to the bounds of mesh(see Mesh::positionOffset), the w is not used.<para></para>
+		/// The normal is octahedral R16G16_SNORM, the texCoord is R16G16_FLOAT.<para></para>
+		/// The bone influences are packed into 8 bytes, the strongest one is at first.<para></para>
+		/// The boneIndices is fed as R8G8B8A8_UINT, the boneWeights is fed as R8G8B8A8_UNORM(the sum is 255).
+		/// </summary>
 		struct Vertex
 		{
-			DirectX::XMFLOAT3	pos{};
-			DirectX::XMFLOAT3	normal{};
-			DirectX::XMFLOAT2	texCoord{};
-			std::array<int,		MAX_BONE_INFLUENCES> boneIndices{};
-			std::array<float,	MAX_BONE_INFLUENCES> boneWeights{ 1.0f, 0.0f, 0.0f, 0.0f };
+			std::array<std::uint16_t, 4>	pos{};
+			std::array<std::int16_t, 2>		normal{};
+			std::array<std::uint16_t, 2>	texCoord{};
+			std::array<std::uint8_t, MAX_BONE_INFLUENCES> boneIndices{};
+			std::array<std::uint8_t, MAX_BONE_INFLUENCES> boneWeights{ 255, 0, 0, 0 };
 		};
 
 		struct ConstantBuffer
 		{
 			DirectX::XMFLOAT4X4	worldViewProjection;
 			DirectX::XMFLOAT4X4	world;
+			DirectX::XMFLOAT4	positionOffset;
+			DirectX::XMFLOAT4	positionScale;
 			// DirectX::XMFLOAT4	eyePosition;
 			DirectX::XMFLOAT4	lightColor;
 			DirectX::XMFLOAT4	lightDir;
@@ -85,13 +101,36 @@ namespace Donya
 			{}
 		};
 
+		/// <summary>
+		/// A simplified level of a mesh. The ranges are per subset, those refer to the same index buffer as the subsets.
+		/// </summary>
+		struct LODLevel
+		{
+			float				error;	// The max geometric error from the full resolution, in the unit of positions.
+			std::vector<UINT>	indexStarts;
+			std::vector<UINT>	indexCounts;
+		public:
+			LODLevel() : error( 0.0f ), indexStarts(), indexCounts()
+			{}
+		};
+
 		struct Mesh
 		{
 			DirectX::XMFLOAT4X4 coordinateConversion;
 			DirectX::XMFLOAT4X4 globalTransform;
 			Microsoft::WRL::ComPtr<ID3D11Buffer> iIndexBuffer;
+			DXGI_FORMAT indexFormat;	// DXGI_FORMAT_R16_UINT or DXGI_FORMAT_R32_UINT.
 			Microsoft::WRL::ComPtr<ID3D11Buffer> iVertexBuffer;
+			// The decoded position is "positionOffset + pos * positionScale".
+			DirectX::XMFLOAT3 positionOffset;
+			DirectX::XMFLOAT3 positionScale;
 			std::vector<Subset> subsets;
+			// The bounding spheres(xyz is the center, w is the radius) in the space of mesh with the globalTransform applied.
+			// The subsets' ones are separated from the Subset, so those can be tested at once.
+			DirectX::XMFLOAT4 boundingSphere;
+			std::vector<DirectX::XMFLOAT4> subsetSpheres;
+			std::vector<LODLevel> lods;	// The coarser is at the back.
+			size_t lodLevel;			// The level that was selected at the last Render(). Zero is the full resolution, N is the lods[N - 1].
 		public:
 			Mesh() : coordinateConversion
 			(
@@ -111,12 +150,28 @@ namespace Donya
 					0, 0, 0, 1
 				}
 			),
-			iVertexBuffer(), iIndexBuffer(), subsets()
+			iVertexBuffer(), iIndexBuffer(), indexFormat( DXGI_FORMAT_R32_UINT ), positionOffset( 0.0f, 0.0f, 0.0f ), positionScale( 1.0f, 1.0f, 1.0f ), subsets(),
+			boundingSphere( 0.0f, 0.0f, 0.0f, 0.0f ), subsetSpheres(), lods(), lodLevel( 0 )
 			{}
 			Mesh( const Mesh & ) = default;
+			Mesh( Mesh && ) = default;
+			Mesh &operator = ( const Mesh & ) = default;
+			Mesh &operator = ( Mesh && ) = default;
+		};
+		/// <summary>
+		/// The counts of the last Render().
+		/// </summary>
+		struct CullingStatistics
+		{
+			size_t drawnMeshes{};
+			size_t culledMeshes{};
+			size_t drawnSubsets{};
+			size_t culledSubsets{};
 		};
 	private:
 		std::vector<Mesh> meshes;
+		float lodPixelError;	// The allowed projected error of the LOD, in pixels.
+		CullingStatistics cullingStatistics;
 	#define	COM_PTR Microsoft::WRL::ComPtr
 		COM_PTR<ID3D11Buffer>				iConstantBuffer;
 		COM_PTR<ID3D11Buffer>				iMaterialCBuffer;
@@ -130,8 +185,24 @@ namespace Donya
 	public:
 		SkinnedMesh();
 		~SkinnedMesh();
+		SkinnedMesh( const SkinnedMesh & ) = delete;
+		SkinnedMesh( SkinnedMesh && ) = default;
+		SkinnedMesh &operator = ( const SkinnedMesh & ) = delete;
+		SkinnedMesh &operator = ( SkinnedMesh && ) = default;
 	public:
-		bool Init( const std::vector<std::vector<size_t>> &allMeshesIndex, const std::vector<std::vector<SkinnedMesh::Vertex>> &allMeshesVertices, const std::vector<SkinnedMesh::Mesh> &loadedMeshes );
+		/// <summary>
+		/// The index buffer of each mesh is made from allMeshesIndex16 or allMeshesIndex32, that is decided by the Mesh::indexFormat.
+		/// </summary>
+		bool Init( const std::vector<Donya::ArrayView<std::uint16_t>> &allMeshesIndex16, const std::vector<Donya::ArrayView<std::uint32_t>> &allMeshesIndex32, const std::vector<std::vector<SkinnedMesh::Vertex>> &allMeshesVertices, const std::vector<SkinnedMesh::Mesh> &loadedMeshes );
+		/// <summary>
+		/// The Render() uses the coarsest LOD level that the projected error is less than or equal to the "pixels".<para></para>
+		/// Zero means always the full resolution.
+		/// </summary>
+		void SetLODPixelError( float pixels );
+		/// <summary>
+		/// The meshes and subsets that are outside of the "pWorldFrustum" are skipped before any update of constant buffers.<para></para>
+		/// Nothing is culled if the "pWorldFrustum" is nullptr.
+		/// </summary>
 		void Render
 		(
 			const DirectX::XMFLOAT4X4	&worldViewProjection,
@@ -139,7 +210,14 @@ namespace Donya
 			const DirectX::XMFLOAT4		&eyePosition,
 			const DirectX::XMFLOAT4		&lightColor,
 			const DirectX::XMFLOAT4		&lightDirection,
-			bool isEnableFill = true
+			bool isEnableFill = true,
+			const Donya::Frustum		*pWorldFrustum = nullptr
 		);
+		const CullingStatistics &GetCullingStatistics() const { return cullingStatistics; }
+		size_t GetMeshCount() const { return meshes.size(); }
+		/// <summary>
+		/// Returns the matrix that transforms the vertices of the mesh into world space, it is same as the Render() uses.
+		/// </summary>
+		DirectX::XMFLOAT4X4 CalcMeshToWorld( size_t meshIndex, const DirectX::XMFLOAT4X4 &world ) const;
 	};
 }
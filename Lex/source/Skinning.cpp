@@ -0,0 +1,970 @@
+#include "Skinning.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <immintrin.h>
+#include <vector>
+
+#include "Common.h"
+#include "CPUFeatures.h"
+#include "Useful.h"		// Use ParallelFor().
+
+using namespace DirectX;
+
+namespace Donya
+{
+	namespace Skinning
+	{
+		constexpr int	INFLUENCE_COUNT		= 4;
+		constexpr float	WEIGHT_SCALE		= 1.0f / 255.0f;
+		// The zero-length normal keeps zero instead of NaN.
+		constexpr float	MIN_LENGTH_SQ		= 1.0e-30f;
+		// The vertices are processed by this count per task of threads.
+		constexpr size_t BLOCK_VERTEX_COUNT	= 4096;
+		// The fewer vertices are processed on the calling thread only, because the creation of threads costs more than those.
+		constexpr size_t MIN_PARALLEL_VERTEX_COUNT = BLOCK_VERTEX_COUNT * 8;
+
+		const char *GetKernelName( Kernel kernel )
+		{
+			switch ( kernel )
+			{
+			case Kernel::Auto:		return "Auto";
+			case Kernel::Scalar:	return "Scalar";
+			case Kernel::SSE:		return "SSE";
+			case Kernel::AVX2:		return "AVX2";
+			default: break;
+			}
+			return "Unknown";
+		}
+		bool IsSupported( Kernel kernel )
+		{
+			const CPUFeatures &features = GetCPUFeatures();
+			switch ( kernel )
+			{
+			case Kernel::Auto:		return true;
+			case Kernel::Scalar:	return true;
+			case Kernel::SSE:		return features.sse2;
+			case Kernel::AVX2:		return features.avx2 && features.fma;
+			default: break;
+			}
+			return false;
+		}
+		Kernel GetBestKernel()
+		{
+			if ( IsSupported( Kernel::AVX2	) ) { return Kernel::AVX2;	}
+			if ( IsSupported( Kernel::SSE	) ) { return Kernel::SSE;	}
+			// else
+			return Kernel::Scalar;
+		}
+
+		DualQuaternion DualQuaternion::Make( const Donya::Quaternion &rotation, const Donya::Vector3 &translation )
+		{
+			DualQuaternion result{};
+			result.real = rotation;
+			result.real.Normalize();
+
+			// dual = 0.5 * translation * real
+			const Donya::Quaternion pureTranslation{ translation.x, translation.y, translation.z, 0.0f };
+			result.dual = ( pureTranslation * result.real ) * 0.5f;
+			return result;
+		}
+		DualQuaternion DualQuaternion::Make( const XMFLOAT4X4 &matrix )
+		{
+			// The rows of rotation part are scaled by the scale.
+			XMFLOAT4X4 rotation = matrix;
+			for ( int r = 0; r < 3; ++r )
+			{
+				const float length = sqrtf( rotation.m[r][0] * rotation.m[r][0] + rotation.m[r][1] * rotation.m[r][1] + rotation.m[r][2] * rotation.m[r][2] );
+				if ( length <= FLT_EPSILON ) { continue; }
+				// else
+
+				for ( int c = 0; c < 3; ++c )
+				{
+					rotation.m[r][c] /= length;
+				}
+			}
+
+			return Make( Donya::Quaternion::Make( rotation ), Donya::Vector3{ matrix._41, matrix._42, matrix._43 } );
+		}
+		Donya::Vector3 DualQuaternion::GetTranslation() const
+		{
+			// translation = 2 * dual * real^-1
+			return ( ( dual * real.Conjugate() ) * 2.0f ).GetAxis();
+		}
+		Donya::Vector3 DualQuaternion::TransformPosition( const Donya::Vector3 &position ) const
+		{
+			return real.RotateVector( position ) + GetTranslation();
+		}
+		void MakeDualQuaternionPalette( const ArrayView<XMFLOAT4X4> &matrices, DualQuaternion *pOutput )
+		{
+			const size_t count = matrices.size();
+			for ( size_t i = 0; i < count; ++i )
+			{
+				pOutput[i] = DualQuaternion::Make( matrices[i] );
+			}
+		}
+	#pragma region Kernels
+
+		/// <summary>
+		/// The kernel processes the vertices of [begin ~ end). The arguments are already validated.
+		/// </summary>
+		using KernelFunction = void( * )( const Source &source, const XMFLOAT4X4 *pPalette, size_t begin, size_t end, const Destination &destination );
+
+		/// <summary>
+		/// The reference. The other kernels calculate in the same order, so the differences are only the rounding of fused operations.
+		/// </summary>
+		void SkinScalar( const Source &source, const XMFLOAT4X4 *pPalette, size_t begin, size_t end, const Destination &destination )
+		{
+			const InfluenceStream	&influences	= source.influences;
+			const bool				skinNormals	= ( destination.pNormals != nullptr );
+			for ( size_t i = begin; i < end; ++i )
+			{
+				const std::uint8_t *pIndices = influences.pIndices + influences.stride * i;
+				const std::uint8_t *pWeights = influences.pWeights + influences.stride * i;
+
+				float blended[4][4]{};
+				for ( int k = 0; k < INFLUENCE_COUNT; ++k )
+				{
+					if ( !pWeights[k] ) { continue; }
+					// else
+
+					const float			weight	= scast<float>( pWeights[k] ) * WEIGHT_SCALE;
+					const XMFLOAT4X4	&bone	= pPalette[pIndices[k]];
+					for ( int r = 0; r < 4; ++r )
+					{
+						for ( int c = 0; c < 4; ++c )
+						{
+							blended[r][c] += weight * bone.m[r][c];
+						}
+					}
+				}
+
+				// Copy the inputs, so the destination can be the same as the source.
+				const Donya::Vector3 position = source.positions[i];
+				Donya::Vector3 &outputPosition = destination.pPositions[i];
+				outputPosition.x = ( position.x * blended[0][0] + position.y * blended[1][0] ) + ( position.z * blended[2][0] + blended[3][0] );
+				outputPosition.y = ( position.x * blended[0][1] + position.y * blended[1][1] ) + ( position.z * blended[2][1] + blended[3][1] );
+				outputPosition.z = ( position.x * blended[0][2] + position.y * blended[1][2] ) + ( position.z * blended[2][2] + blended[3][2] );
+
+				if ( !skinNormals ) { continue; }
+				// else
+
+				const Donya::Vector3 normal = source.normals[i];
+				Donya::Vector3 skinned
+				{
+					( normal.x * blended[0][0] + normal.y * blended[1][0] ) + normal.z * blended[2][0],
+					( normal.x * blended[0][1] + normal.y * blended[1][1] ) + normal.z * blended[2][1],
+					( normal.x * blended[0][2] + normal.y * blended[1][2] ) + normal.z * blended[2][2]
+				};
+				const float lengthSq = skinned.x * skinned.x + skinned.y * skinned.y + skinned.z * skinned.z;
+				const float length   = sqrtf( std::max( lengthSq, MIN_LENGTH_SQ ) );
+				destination.pNormals[i] = Donya::Vector3{ skinned.x / length, skinned.y / length, skinned.z / length };
+			}
+		}
+
+		void StoreFloat3( Donya::Vector3 *pOutput, __m128 value )
+		{
+			_mm_storel_pi( reinterpret_cast<__m64 *>( &pOutput->x ), value );
+			_mm_store_ss( &pOutput->z, _mm_movehl_ps( value, value ) );
+		}
+		/// <summary>
+		/// Returns the normalized xyz, the w is not used.
+		/// </summary>
+		__m128 NormalizeFloat3( __m128 value )
+		{
+			const __m128 squared	= _mm_mul_ps( value, value );
+			const __m128 yzxw		= _mm_shuffle_ps( squared, squared, _MM_SHUFFLE( 3, 0, 2, 1 ) );
+			const __m128 zxyw		= _mm_shuffle_ps( squared, squared, _MM_SHUFFLE( 3, 1, 0, 2 ) );
+			const __m128 lengthSq	= _mm_add_ps( _mm_add_ps( squared, yzxw ), zxyw );
+			const __m128 length		= _mm_sqrt_ps( _mm_max_ps( lengthSq, _mm_set1_ps( MIN_LENGTH_SQ ) ) );
+			return _mm_div_ps( value, length );
+		}
+
+		/// <summary>
+		/// Blends the palette rows by 4-wide vectors, one vertex per iteration. It needs only SSE2.
+		/// </summary>
+		void SkinSSE( const Source &source, const XMFLOAT4X4 *pPalette, size_t begin, size_t end, const Destination &destination )
+		{
+			const InfluenceStream	&influences	= source.influences;
+			const bool				skinNormals	= ( destination.pNormals != nullptr );
+			const __m128			weightScale	= _mm_set1_ps( WEIGHT_SCALE );
+			for ( size_t i = begin; i < end; ++i )
+			{
+				const std::uint8_t *pIndices = influences.pIndices + influences.stride * i;
+				const std::uint8_t *pWeights = influences.pWeights + influences.stride * i;
+
+				__m128 row0 = _mm_setzero_ps();
+				__m128 row1 = _mm_setzero_ps();
+				__m128 row2 = _mm_setzero_ps();
+				__m128 row3 = _mm_setzero_ps();
+				for ( int k = 0; k < INFLUENCE_COUNT; ++k )
+				{
+					if ( !pWeights[k] ) { continue; }
+					// else
+
+					const __m128 weight = _mm_mul_ps( _mm_set1_ps( scast<float>( pWeights[k] ) ), weightScale );
+					const float  *pBone = &pPalette[pIndices[k]].m[0][0];
+					row0 = _mm_add_ps( row0, _mm_mul_ps( weight, _mm_loadu_ps( pBone +  0 ) ) );
+					row1 = _mm_add_ps( row1, _mm_mul_ps( weight, _mm_loadu_ps( pBone +  4 ) ) );
+					row2 = _mm_add_ps( row2, _mm_mul_ps( weight, _mm_loadu_ps( pBone +  8 ) ) );
+					row3 = _mm_add_ps( row3, _mm_mul_ps( weight, _mm_loadu_ps( pBone + 12 ) ) );
+				}
+
+				const Donya::Vector3 &position = source.positions[i];
+				const __m128 skinnedPosition = _mm_add_ps
+				(
+					_mm_add_ps( _mm_mul_ps( _mm_set1_ps( position.x ), row0 ), _mm_mul_ps( _mm_set1_ps( position.y ), row1 ) ),
+					_mm_add_ps( _mm_mul_ps( _mm_set1_ps( position.z ), row2 ), row3 )
+				);
+				StoreFloat3( &destination.pPositions[i], skinnedPosition );
+
+				if ( !skinNormals ) { continue; }
+				// else
+
+				const Donya::Vector3 &normal = source.normals[i];
+				const __m128 skinnedNormal = _mm_add_ps
+				(
+					_mm_add_ps( _mm_mul_ps( _mm_set1_ps( normal.x ), row0 ), _mm_mul_ps( _mm_set1_ps( normal.y ), row1 ) ),
+					_mm_mul_ps( _mm_set1_ps( normal.z ), row2 )
+				);
+				StoreFloat3( &destination.pNormals[i], NormalizeFloat3( skinnedNormal ) );
+			}
+		}
+
+		/// <summary>
+		/// Blends two palette rows per 8-wide vector, so a influence needs two FMAs instead of four multiply-adds.<para></para>
+		/// The halves of the transformed vector are summed at last.
+		/// </summary>
+		void SkinAVX2( const Source &source, const XMFLOAT4X4 *pPalette, size_t begin, size_t end, const Destination &destination )
+		{
+			const InfluenceStream	&influences	= source.influences;
+			const bool				skinNormals	= ( destination.pNormals != nullptr );
+			const __m256			weightScale	= _mm256_set1_ps( WEIGHT_SCALE );
+			for ( size_t i = begin; i < end; ++i )
+			{
+				const std::uint8_t *pIndices = influences.pIndices + influences.stride * i;
+				const std::uint8_t *pWeights = influences.pWeights + influences.stride * i;
+
+				__m256 rows01 = _mm256_setzero_ps();
+				__m256 rows23 = _mm256_setzero_ps();
+				for ( int k = 0; k < INFLUENCE_COUNT; ++k )
+				{
+					if ( !pWeights[k] ) { continue; }
+					// else
+
+					const __m256 weight = _mm256_mul_ps( _mm256_set1_ps( scast<float>( pWeights[k] ) ), weightScale );
+					const float  *pBone = &pPalette[pIndices[k]].m[0][0];
+					rows01 = _mm256_fmadd_ps( weight, _mm256_loadu_ps( pBone + 0 ), rows01 );
+					rows23 = _mm256_fmadd_ps( weight, _mm256_loadu_ps( pBone + 8 ), rows23 );
+				}
+
+				// [x * row0 | y * row1] + [z * row2 | 1 * row3]
+				const Donya::Vector3 &position = source.positions[i];
+				const __m256 positionXY = _mm256_set_m128( _mm_set1_ps( position.y ), _mm_set1_ps( position.x ) );
+				const __m256 positionZW = _mm256_set_m128( _mm_set1_ps( 1.0f ), _mm_set1_ps( position.z ) );
+				const __m256 positionHalves = _mm256_fmadd_ps( positionXY, rows01, _mm256_mul_ps( positionZW, rows23 ) );
+				StoreFloat3
+				(
+					&destination.pPositions[i],
+					_mm_add_ps( _mm256_castps256_ps128( positionHalves ), _mm256_extractf128_ps( positionHalves, 1 ) )
+				);
+
+				if ( !skinNormals ) { continue; }
+				// else
+
+				// [x * row0 | y * row1] + [z * row2 | 0 * row3]
+				const Donya::Vector3 &normal = source.normals[i];
+				const __m256 normalXY = _mm256_set_m128( _mm_set1_ps( normal.y ), _mm_set1_ps( normal.x ) );
+				const __m256 normalZW = _mm256_set_m128( _mm_setzero_ps(), _mm_set1_ps( normal.z ) );
+				const __m256 normalHalves = _mm256_fmadd_ps( normalXY, rows01, _mm256_mul_ps( normalZW, rows23 ) );
+				StoreFloat3
+				(
+					&destination.pNormals[i],
+					NormalizeFloat3( _mm_add_ps( _mm256_castps256_ps128( normalHalves ), _mm256_extractf128_ps( normalHalves, 1 ) ) )
+				);
+			}
+
+			// Avoid the penalty of transition to the legacy SSE code.
+			_mm256_zeroupper();
+		}
+
+		KernelFunction GetKernelFunction( Kernel kernel )
+		{
+			switch ( kernel )
+			{
+			case Kernel::Scalar:	return SkinScalar;
+			case Kernel::SSE:		return SkinSSE;
+			case Kernel::AVX2:		return SkinAVX2;
+			default: break;
+			}
+			return nullptr;
+		}
+
+	// region Kernels
+	#pragma endregion
+
+	#pragma region Dual Quaternion Kernels
+
+		using DualQuaternionKernelFunction = void( * )( const Source &source, const DualQuaternion *pPalette, size_t begin, size_t end, const Destination &destination );
+
+		/// <summary>
+		/// Returns "v + 2 * real.xyz x ( real.xyz x v + real.w * v )", it is the same as "real * v * real^-1" of the normalized real.
+		/// </summary>
+		inline Donya::Vector3 RotateByUnit( const float real[4], const Donya::Vector3 &v )
+		{
+			const Donya::Vector3 t
+			{
+				( real[1] * v.z - real[2] * v.y ) + real[3] * v.x,
+				( real[2] * v.x - real[0] * v.z ) + real[3] * v.y,
+				( real[0] * v.y - real[1] * v.x ) + real[3] * v.z
+			};
+			return Donya::Vector3
+			{
+				v.x + 2.0f * ( real[1] * t.z - real[2] * t.y ),
+				v.y + 2.0f * ( real[2] * t.x - real[0] * t.z ),
+				v.z + 2.0f * ( real[0] * t.y - real[1] * t.x )
+			};
+		}
+
+		/// <summary>
+		/// The reference. The SIMD kernels calculate in the same order for the batches of vertices, and use this for the rest of batches.
+		/// </summary>
+		void SkinDualQuaternionScalar( const Source &source, const DualQuaternion *pPalette, size_t begin, size_t end, const Destination &destination )
+		{
+			const InfluenceStream	&influences	= source.influences;
+			const bool				skinNormals	= ( destination.pNormals != nullptr );
+			for ( size_t i = begin; i < end; ++i )
+			{
+				const std::uint8_t *pIndices = influences.pIndices + influences.stride * i;
+				const std::uint8_t *pWeights = influences.pWeights + influences.stride * i;
+
+				// The "q" and "-q" are the same rotation, so the one that is in the same hemisphere as the pivot is blended.
+				const Donya::Quaternion &pivot = pPalette[pIndices[0]].real;
+				float real[4]{};
+				float dual[4]{};
+				for ( int k = 0; k < INFLUENCE_COUNT; ++k )
+				{
+					if ( !pWeights[k] ) { continue; }
+					// else
+
+					const DualQuaternion	&bone	= pPalette[pIndices[k]];
+					const float				dot		= ( pivot.x * bone.real.x + pivot.y * bone.real.y ) + ( pivot.z * bone.real.z + pivot.w * bone.real.w );
+					const float				weight	= ( dot < 0.0f ) ? -( scast<float>( pWeights[k] ) * WEIGHT_SCALE ) : scast<float>( pWeights[k] ) * WEIGHT_SCALE;
+					real[0] += weight * bone.real.x;
+					real[1] += weight * bone.real.y;
+					real[2] += weight * bone.real.z;
+					real[3] += weight * bone.real.w;
+					dual[0] += weight * bone.dual.x;
+					dual[1] += weight * bone.dual.y;
+					dual[2] += weight * bone.dual.z;
+					dual[3] += weight * bone.dual.w;
+				}
+
+				const float lengthSq		= ( real[0] * real[0] + real[1] * real[1] ) + ( real[2] * real[2] + real[3] * real[3] );
+				const float inverseLength	= 1.0f / sqrtf( std::max( lengthSq, MIN_LENGTH_SQ ) );
+				for ( int c = 0; c < 4; ++c )
+				{
+					real[c] *= inverseLength;
+					dual[c] *= inverseLength;
+				}
+
+				// translation = 2 * ( real.w * dual.xyz - dual.w * real.xyz + real.xyz x dual.xyz )
+				const Donya::Vector3 translation
+				{
+					2.0f * ( ( real[3] * dual[0] - dual[3] * real[0] ) + ( real[1] * dual[2] - real[2] * dual[1] ) ),
+					2.0f * ( ( real[3] * dual[1] - dual[3] * real[1] ) + ( real[2] * dual[0] - real[0] * dual[2] ) ),
+					2.0f * ( ( real[3] * dual[2] - dual[3] * real[2] ) + ( real[0] * dual[1] - real[1] * dual[0] ) )
+				};
+				// Copy the inputs, so the destination can be the same as the source.
+				const Donya::Vector3 position = source.positions[i];
+				destination.pPositions[i] = RotateByUnit( real, position ) + translation;
+
+				if ( !skinNormals ) { continue; }
+				// else
+
+				const Donya::Vector3 normal = source.normals[i];
+				destination.pNormals[i] = RotateByUnit( real, normal );
+			}
+		}
+
+		/// <summary>
+		/// The components of 4 or 8 vectors, a lane is a vector.
+		/// </summary>
+		struct Float3x4 { __m128 x, y, z;		};
+		struct Float4x4 { __m128 x, y, z, w;	};
+		struct Float3x8 { __m256 x, y, z;		};
+		struct Float4x8 { __m256 x, y, z, w;	};
+
+		/// <summary>
+		/// Returns the 4 bytes as one 32-bit integer, the first byte is the lowest.
+		/// </summary>
+		int LoadPackedBytes( const std::uint8_t *pBytes )
+		{
+			int packed = 0;
+			memcpy( &packed, pBytes, sizeof( packed ) );
+			return packed;
+		}
+
+		static_assert( sizeof( Donya::Vector3 ) == sizeof( float ) * 3, "The 4 vectors are loaded as the 3 vectors of 4 floats." );
+		/// <summary>
+		/// The 4 vectors are the continuous 12 floats "x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3".
+		/// </summary>
+		inline Float3x4 LoadFloat3x4( const Donya::Vector3 *pVectors )
+		{
+			const float  *pFloats	= &pVectors->x;
+			const __m128 v0			= _mm_loadu_ps( pFloats + 0 );
+			const __m128 v1			= _mm_loadu_ps( pFloats + 4 );
+			const __m128 v2			= _mm_loadu_ps( pFloats + 8 );
+			const __m128 x2y2x3y3	= _mm_shuffle_ps( v1, v2, _MM_SHUFFLE( 2, 1, 3, 2 ) );
+			const __m128 y0z0y1z1	= _mm_shuffle_ps( v0, v1, _MM_SHUFFLE( 1, 0, 2, 1 ) );
+			return Float3x4
+			{
+				_mm_shuffle_ps( v0,			x2y2x3y3, _MM_SHUFFLE( 2, 0, 3, 0 ) ),
+				_mm_shuffle_ps( y0z0y1z1,	x2y2x3y3, _MM_SHUFFLE( 3, 1, 2, 0 ) ),
+				_mm_shuffle_ps( y0z0y1z1,	v2,       _MM_SHUFFLE( 3, 0, 3, 1 ) )
+			};
+		}
+		/// <summary>
+		/// The inverse of LoadFloat3x4().
+		/// </summary>
+		inline void StoreFloat3x4( Donya::Vector3 *pOutput, const Float3x4 &vectors )
+		{
+			const __m128 &x = vectors.x;
+			const __m128 &y = vectors.y;
+			const __m128 &z = vectors.z;
+			const __m128 x0x1y0y1 = _mm_shuffle_ps( x, y, _MM_SHUFFLE( 1, 0, 1, 0 ) );
+			const __m128 z0z0x1x1 = _mm_shuffle_ps( z, x, _MM_SHUFFLE( 1, 1, 0, 0 ) );
+			const __m128 y1y1z1z1 = _mm_shuffle_ps( y, z, _MM_SHUFFLE( 1, 1, 1, 1 ) );
+			const __m128 x2x2y2y2 = _mm_shuffle_ps( x, y, _MM_SHUFFLE( 2, 2, 2, 2 ) );
+			const __m128 z2z2x3x3 = _mm_shuffle_ps( z, x, _MM_SHUFFLE( 3, 3, 2, 2 ) );
+			const __m128 y3y3z3z3 = _mm_shuffle_ps( y, z, _MM_SHUFFLE( 3, 3, 3, 3 ) );
+
+			float *pFloats = &pOutput->x;
+			_mm_storeu_ps( pFloats + 0, _mm_shuffle_ps( x0x1y0y1, z0z0x1x1, _MM_SHUFFLE( 2, 0, 2, 0 ) ) );
+			_mm_storeu_ps( pFloats + 4, _mm_shuffle_ps( y1y1z1z1, x2x2y2y2, _MM_SHUFFLE( 2, 0, 2, 0 ) ) );
+			_mm_storeu_ps( pFloats + 8, _mm_shuffle_ps( z2z2x3x3, y3y3z3z3, _MM_SHUFFLE( 2, 0, 2, 0 ) ) );
+		}
+
+		/// <summary>
+		/// Loads the palette of the indices of 4 vertices, those are "stride" bytes apart. Then transposes those into the components.
+		/// </summary>
+		inline void LoadInfluencesSSE( const DualQuaternion *pPalette, const std::uint8_t *pIndices, size_t stride, Float4x4 *pReal, Float4x4 *pDual )
+		{
+			const DualQuaternion &bone0 = pPalette[pIndices[stride * 0]];
+			const DualQuaternion &bone1 = pPalette[pIndices[stride * 1]];
+			const DualQuaternion &bone2 = pPalette[pIndices[stride * 2]];
+			const DualQuaternion &bone3 = pPalette[pIndices[stride * 3]];
+
+			__m128 real0 = _mm_loadu_ps( &bone0.real.x );
+			__m128 real1 = _mm_loadu_ps( &bone1.real.x );
+			__m128 real2 = _mm_loadu_ps( &bone2.real.x );
+			__m128 real3 = _mm_loadu_ps( &bone3.real.x );
+			_MM_TRANSPOSE4_PS( real0, real1, real2, real3 );
+			*pReal = Float4x4{ real0, real1, real2, real3 };
+
+			__m128 dual0 = _mm_loadu_ps( &bone0.dual.x );
+			__m128 dual1 = _mm_loadu_ps( &bone1.dual.x );
+			__m128 dual2 = _mm_loadu_ps( &bone2.dual.x );
+			__m128 dual3 = _mm_loadu_ps( &bone3.dual.x );
+			_MM_TRANSPOSE4_PS( dual0, dual1, dual2, dual3 );
+			*pDual = Float4x4{ dual0, dual1, dual2, dual3 };
+		}
+
+		/// <summary>
+		/// The 4 vertices version of RotateByUnit().
+		/// </summary>
+		inline Float3x4 RotateByUnitSSE( const Float4x4 &real, const Float3x4 &v )
+		{
+			const Float3x4 t
+			{
+				_mm_add_ps( _mm_sub_ps( _mm_mul_ps( real.y, v.z ), _mm_mul_ps( real.z, v.y ) ), _mm_mul_ps( real.w, v.x ) ),
+				_mm_add_ps( _mm_sub_ps( _mm_mul_ps( real.z, v.x ), _mm_mul_ps( real.x, v.z ) ), _mm_mul_ps( real.w, v.y ) ),
+				_mm_add_ps( _mm_sub_ps( _mm_mul_ps( real.x, v.y ), _mm_mul_ps( real.y, v.x ) ), _mm_mul_ps( real.w, v.z ) )
+			};
+			const __m128 two = _mm_set1_ps( 2.0f );
+			return Float3x4
+			{
+				_mm_add_ps( v.x, _mm_mul_ps( two, _mm_sub_ps( _mm_mul_ps( real.y, t.z ), _mm_mul_ps( real.z, t.y ) ) ) ),
+				_mm_add_ps( v.y, _mm_mul_ps( two, _mm_sub_ps( _mm_mul_ps( real.z, t.x ), _mm_mul_ps( real.x, t.z ) ) ) ),
+				_mm_add_ps( v.z, _mm_mul_ps( two, _mm_sub_ps( _mm_mul_ps( real.x, t.y ), _mm_mul_ps( real.y, t.x ) ) ) )
+			};
+		}
+		/// <summary>
+		/// The 4 vertices version of the translation of SkinDualQuaternionScalar().
+		/// </summary>
+		inline Float3x4 CalcTranslationSSE( const Float4x4 &real, const Float4x4 &dual )
+		{
+			const __m128 two = _mm_set1_ps( 2.0f );
+			return Float3x4
+			{
+				_mm_mul_ps( two, _mm_add_ps( _mm_sub_ps( _mm_mul_ps( real.w, dual.x ), _mm_mul_ps( dual.w, real.x ) ), _mm_sub_ps( _mm_mul_ps( real.y, dual.z ), _mm_mul_ps( real.z, dual.y ) ) ) ),
+				_mm_mul_ps( two, _mm_add_ps( _mm_sub_ps( _mm_mul_ps( real.w, dual.y ), _mm_mul_ps( dual.w, real.y ) ), _mm_sub_ps( _mm_mul_ps( real.z, dual.x ), _mm_mul_ps( real.x, dual.z ) ) ) ),
+				_mm_mul_ps( two, _mm_add_ps( _mm_sub_ps( _mm_mul_ps( real.w, dual.z ), _mm_mul_ps( dual.w, real.z ) ), _mm_sub_ps( _mm_mul_ps( real.x, dual.y ), _mm_mul_ps( real.y, dual.x ) ) ) )
+			};
+		}
+		inline __m128 DotSSE( const Float4x4 &L, const Float4x4 &R )
+		{
+			return _mm_add_ps
+			(
+				_mm_add_ps( _mm_mul_ps( L.x, R.x ), _mm_mul_ps( L.y, R.y ) ),
+				_mm_add_ps( _mm_mul_ps( L.z, R.z ), _mm_mul_ps( L.w, R.w ) )
+			);
+		}
+		inline Float4x4 ScaleSSE( const Float4x4 &v, __m128 scale )
+		{
+			return Float4x4{ _mm_mul_ps( v.x, scale ), _mm_mul_ps( v.y, scale ), _mm_mul_ps( v.z, scale ), _mm_mul_ps( v.w, scale ) };
+		}
+		/// <summary>
+		/// Returns "sum + weight * v".
+		/// </summary>
+		inline Float4x4 AccumulateSSE( const Float4x4 &sum, __m128 weight, const Float4x4 &v )
+		{
+			return Float4x4
+			{
+				_mm_add_ps( sum.x, _mm_mul_ps( weight, v.x ) ),
+				_mm_add_ps( sum.y, _mm_mul_ps( weight, v.y ) ),
+				_mm_add_ps( sum.z, _mm_mul_ps( weight, v.z ) ),
+				_mm_add_ps( sum.w, _mm_mul_ps( weight, v.w ) )
+			};
+		}
+
+		/// <summary>
+		/// Processes 4 vertices per batch. The k-th influences of the batch are transposed into the components(SoA),<para></para>
+		/// so the blend, the normalization and the transform are calculated for 4 vertices per instruction. It needs only SSE2.
+		/// </summary>
+		void SkinDualQuaternionSSE( const Source &source, const DualQuaternion *pPalette, size_t begin, size_t end, const Destination &destination )
+		{
+			constexpr size_t BATCH = 4;
+
+			const InfluenceStream	&influences	= source.influences;
+			const bool				skinNormals	= ( destination.pNormals != nullptr );
+			const __m128			signMask	= _mm_set1_ps( -0.0f );
+			const __m128			weightScale	= _mm_set1_ps( WEIGHT_SCALE );
+			const __m128i			byteMask	= _mm_set1_epi32( 0xFF );
+
+			size_t i = begin;
+			for ( ; i + BATCH <= end; i += BATCH )
+			{
+				const std::uint8_t *pIndices = influences.pIndices + influences.stride * i;
+				const std::uint8_t *pWeights = influences.pWeights + influences.stride * i;
+				// The 4 weights of a vertex are one 32-bit lane, the k-th weight is the k-th byte.
+				__m128i packedWeights = _mm_setr_epi32
+				(
+					LoadPackedBytes( pWeights + influences.stride * 0 ),
+					LoadPackedBytes( pWeights + influences.stride * 1 ),
+					LoadPackedBytes( pWeights + influences.stride * 2 ),
+					LoadPackedBytes( pWeights + influences.stride * 3 )
+				);
+
+				// The first influence is the pivot of hemisphere.
+				Float4x4 pivot, real, dual;
+				LoadInfluencesSSE( pPalette, pIndices, influences.stride, &pivot, &dual );
+				__m128 weight = _mm_mul_ps( _mm_cvtepi32_ps( _mm_and_si128( packedWeights, byteMask ) ), weightScale );
+				real = ScaleSSE( pivot,	weight );
+				dual = ScaleSSE( dual,	weight );
+				for ( int k = 1; k < INFLUENCE_COUNT; ++k )
+				{
+					packedWeights = _mm_srli_epi32( packedWeights, 8 );
+					const __m128i integerWeight = _mm_and_si128( packedWeights, byteMask );
+					// Skip the influence that all the vertices of batch do not have, as same as the skip of zero weight of the other kernels.
+					if ( _mm_movemask_epi8( _mm_cmpeq_epi32( integerWeight, _mm_setzero_si128() ) ) == 0xFFFF ) { continue; }
+					// else
+
+					Float4x4 boneReal, boneDual;
+					LoadInfluencesSSE( pPalette, pIndices + k, influences.stride, &boneReal, &boneDual );
+
+					weight = _mm_mul_ps( _mm_cvtepi32_ps( integerWeight ), weightScale );
+					// Negate the weight if the dot is negative.
+					weight = _mm_xor_ps( weight, _mm_and_ps( DotSSE( pivot, boneReal ), signMask ) );
+
+					real = AccumulateSSE( real, weight, boneReal );
+					dual = AccumulateSSE( dual, weight, boneDual );
+				}
+
+				const __m128 lengthSq		= DotSSE( real, real );
+				const __m128 inverseLength	= _mm_div_ps( _mm_set1_ps( 1.0f ), _mm_sqrt_ps( _mm_max_ps( lengthSq, _mm_set1_ps( MIN_LENGTH_SQ ) ) ) );
+				real = ScaleSSE( real, inverseLength );
+				dual = ScaleSSE( dual, inverseLength );
+
+				const Float3x4 translation	= CalcTranslationSSE( real, dual );
+				const Float3x4 rotated		= RotateByUnitSSE( real, LoadFloat3x4( &source.positions[i] ) );
+				StoreFloat3x4
+				(
+					&destination.pPositions[i],
+					Float3x4{ _mm_add_ps( rotated.x, translation.x ), _mm_add_ps( rotated.y, translation.y ), _mm_add_ps( rotated.z, translation.z ) }
+				);
+
+				if ( !skinNormals ) { continue; }
+				// else
+
+				StoreFloat3x4( &destination.pNormals[i], RotateByUnitSSE( real, LoadFloat3x4( &source.normals[i] ) ) );
+			}
+
+			SkinDualQuaternionScalar( source, pPalette, i, end, destination );
+		}
+
+		/// <summary>
+		/// Loads the palette of the indices of 8 vertices, those are "stride" bytes apart.<para></para>
+		/// A dual quaternion is one 8-wide vector, so the 8x8 floats are transposed into the 8 components at once.
+		/// </summary>
+		inline void LoadInfluencesAVX2( const DualQuaternion *pPalette, const std::uint8_t *pIndices, size_t stride, Float4x8 *pReal, Float4x8 *pDual )
+		{
+			const __m256 bone0 = _mm256_loadu_ps( &pPalette[pIndices[stride * 0]].real.x );
+			const __m256 bone1 = _mm256_loadu_ps( &pPalette[pIndices[stride * 1]].real.x );
+			const __m256 bone2 = _mm256_loadu_ps( &pPalette[pIndices[stride * 2]].real.x );
+			const __m256 bone3 = _mm256_loadu_ps( &pPalette[pIndices[stride * 3]].real.x );
+			const __m256 bone4 = _mm256_loadu_ps( &pPalette[pIndices[stride * 4]].real.x );
+			const __m256 bone5 = _mm256_loadu_ps( &pPalette[pIndices[stride * 5]].real.x );
+			const __m256 bone6 = _mm256_loadu_ps( &pPalette[pIndices[stride * 6]].real.x );
+			const __m256 bone7 = _mm256_loadu_ps( &pPalette[pIndices[stride * 7]].real.x );
+
+			const __m256 t0 = _mm256_unpacklo_ps( bone0, bone1 );
+			const __m256 t1 = _mm256_unpackhi_ps( bone0, bone1 );
+			const __m256 t2 = _mm256_unpacklo_ps( bone2, bone3 );
+			const __m256 t3 = _mm256_unpackhi_ps( bone2, bone3 );
+			const __m256 t4 = _mm256_unpacklo_ps( bone4, bone5 );
+			const __m256 t5 = _mm256_unpackhi_ps( bone4, bone5 );
+			const __m256 t6 = _mm256_unpacklo_ps( bone6, bone7 );
+			const __m256 t7 = _mm256_unpackhi_ps( bone6, bone7 );
+
+			const __m256 s0 = _mm256_shuffle_ps( t0, t2, _MM_SHUFFLE( 1, 0, 1, 0 ) );
+			const __m256 s1 = _mm256_shuffle_ps( t0, t2, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+			const __m256 s2 = _mm256_shuffle_ps( t1, t3, _MM_SHUFFLE( 1, 0, 1, 0 ) );
+			const __m256 s3 = _mm256_shuffle_ps( t1, t3, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+			const __m256 s4 = _mm256_shuffle_ps( t4, t6, _MM_SHUFFLE( 1, 0, 1, 0 ) );
+			const __m256 s5 = _mm256_shuffle_ps( t4, t6, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+			const __m256 s6 = _mm256_shuffle_ps( t5, t7, _MM_SHUFFLE( 1, 0, 1, 0 ) );
+			const __m256 s7 = _mm256_shuffle_ps( t5, t7, _MM_SHUFFLE( 3, 2, 3, 2 ) );
+
+			// The lower lanes are the real, the upper lanes are the dual.
+			*pReal = Float4x8
+			{
+				_mm256_permute2f128_ps( s0, s4, 0x20 ),
+				_mm256_permute2f128_ps( s1, s5, 0x20 ),
+				_mm256_permute2f128_ps( s2, s6, 0x20 ),
+				_mm256_permute2f128_ps( s3, s7, 0x20 )
+			};
+			*pDual = Float4x8
+			{
+				_mm256_permute2f128_ps( s0, s4, 0x31 ),
+				_mm256_permute2f128_ps( s1, s5, 0x31 ),
+				_mm256_permute2f128_ps( s2, s6, 0x31 ),
+				_mm256_permute2f128_ps( s3, s7, 0x31 )
+			};
+		}
+
+		/// <summary>
+		/// The 8 vertices version of RotateByUnit().
+		/// </summary>
+		inline Float3x8 RotateByUnitAVX2( const Float4x8 &real, const Float3x8 &v )
+		{
+			const Float3x8 t
+			{
+				_mm256_fmadd_ps( real.w, v.x, _mm256_fmsub_ps( real.y, v.z, _mm256_mul_ps( real.z, v.y ) ) ),
+				_mm256_fmadd_ps( real.w, v.y, _mm256_fmsub_ps( real.z, v.x, _mm256_mul_ps( real.x, v.z ) ) ),
+				_mm256_fmadd_ps( real.w, v.z, _mm256_fmsub_ps( real.x, v.y, _mm256_mul_ps( real.y, v.x ) ) )
+			};
+			const __m256 two = _mm256_set1_ps( 2.0f );
+			return Float3x8
+			{
+				_mm256_fmadd_ps( two, _mm256_fmsub_ps( real.y, t.z, _mm256_mul_ps( real.z, t.y ) ), v.x ),
+				_mm256_fmadd_ps( two, _mm256_fmsub_ps( real.z, t.x, _mm256_mul_ps( real.x, t.z ) ), v.y ),
+				_mm256_fmadd_ps( two, _mm256_fmsub_ps( real.x, t.y, _mm256_mul_ps( real.y, t.x ) ), v.z )
+			};
+		}
+		/// <summary>
+		/// The 8 vertices version of the translation of SkinDualQuaternionScalar().
+		/// </summary>
+		inline Float3x8 CalcTranslationAVX2( const Float4x8 &real, const Float4x8 &dual )
+		{
+			const __m256 two = _mm256_set1_ps( 2.0f );
+			return Float3x8
+			{
+				_mm256_mul_ps( two, _mm256_add_ps( _mm256_fmsub_ps( real.w, dual.x, _mm256_mul_ps( dual.w, real.x ) ), _mm256_fmsub_ps( real.y, dual.z, _mm256_mul_ps( real.z, dual.y ) ) ) ),
+				_mm256_mul_ps( two, _mm256_add_ps( _mm256_fmsub_ps( real.w, dual.y, _mm256_mul_ps( dual.w, real.y ) ), _mm256_fmsub_ps( real.z, dual.x, _mm256_mul_ps( real.x, dual.z ) ) ) ),
+				_mm256_mul_ps( two, _mm256_add_ps( _mm256_fmsub_ps( real.w, dual.z, _mm256_mul_ps( dual.w, real.z ) ), _mm256_fmsub_ps( real.x, dual.y, _mm256_mul_ps( real.y, dual.x ) ) ) )
+			};
+		}
+		inline __m256 DotAVX2( const Float4x8 &L, const Float4x8 &R )
+		{
+			return _mm256_add_ps
+			(
+				_mm256_fmadd_ps( L.x, R.x, _mm256_mul_ps( L.y, R.y ) ),
+				_mm256_fmadd_ps( L.z, R.z, _mm256_mul_ps( L.w, R.w ) )
+			);
+		}
+		inline Float4x8 ScaleAVX2( const Float4x8 &v, __m256 scale )
+		{
+			return Float4x8{ _mm256_mul_ps( v.x, scale ), _mm256_mul_ps( v.y, scale ), _mm256_mul_ps( v.z, scale ), _mm256_mul_ps( v.w, scale ) };
+		}
+		/// <summary>
+		/// Returns "sum + weight * v".
+		/// </summary>
+		inline Float4x8 AccumulateAVX2( const Float4x8 &sum, __m256 weight, const Float4x8 &v )
+		{
+			return Float4x8
+			{
+				_mm256_fmadd_ps( weight, v.x, sum.x ),
+				_mm256_fmadd_ps( weight, v.y, sum.y ),
+				_mm256_fmadd_ps( weight, v.z, sum.z ),
+				_mm256_fmadd_ps( weight, v.w, sum.w )
+			};
+		}
+		/// <summary>
+		/// The vectors are loaded by the halves, as same as LoadFloat3x4().
+		/// </summary>
+		inline Float3x8 LoadFloat3x8( const Donya::Vector3 *pVectors )
+		{
+			const Float3x4 lower = LoadFloat3x4( pVectors + 0 );
+			const Float3x4 upper = LoadFloat3x4( pVectors + 4 );
+			return Float3x8
+			{
+				_mm256_set_m128( upper.x, lower.x ),
+				_mm256_set_m128( upper.y, lower.y ),
+				_mm256_set_m128( upper.z, lower.z )
+			};
+		}
+		/// <summary>
+		/// The outputs are stored by the halves, as same as StoreFloat3x4().
+		/// </summary>
+		inline void StoreFloat3x8( Donya::Vector3 *pOutput, const Float3x8 &vectors )
+		{
+			StoreFloat3x4
+			(
+				pOutput + 0,
+				Float3x4{ _mm256_castps256_ps128( vectors.x ), _mm256_castps256_ps128( vectors.y ), _mm256_castps256_ps128( vectors.z ) }
+			);
+			StoreFloat3x4
+			(
+				pOutput + 4,
+				Float3x4{ _mm256_extractf128_ps( vectors.x, 1 ), _mm256_extractf128_ps( vectors.y, 1 ), _mm256_extractf128_ps( vectors.z, 1 ) }
+			);
+		}
+
+		/// <summary>
+		/// Processes 8 vertices per batch as same as SkinDualQuaternionSSE(). The weights are loaded by the gather.
+		/// </summary>
+		void SkinDualQuaternionAVX2( const Source &source, const DualQuaternion *pPalette, size_t begin, size_t end, const Destination &destination )
+		{
+			constexpr size_t BATCH = 8;
+
+			const InfluenceStream	&influences	= source.influences;
+			const bool				skinNormals	= ( destination.pNormals != nullptr );
+			const __m256			signMask	= _mm256_set1_ps( -0.0f );
+			const __m256			weightScale	= _mm256_set1_ps( WEIGHT_SCALE );
+			const __m256i			byteMask	= _mm256_set1_epi32( 0xFF );
+			// The byte offsets of the influences of the 8 vertices from the first one.
+			const __m256i			strides		= _mm256_mullo_epi32( _mm256_setr_epi32( 0, 1, 2, 3, 4, 5, 6, 7 ), _mm256_set1_epi32( scast<int>( influences.stride ) ) );
+
+			size_t i = begin;
+			for ( ; i + BATCH <= end; i += BATCH )
+			{
+				const std::uint8_t *pIndices = influences.pIndices + influences.stride * i;
+				const std::uint8_t *pWeights = influences.pWeights + influences.stride * i;
+				// The 4 weights of a vertex are one 32-bit lane, the k-th weight is the k-th byte.
+				__m256i packedWeights = _mm256_i32gather_epi32( reinterpret_cast<const int *>( pWeights ), strides, 1 );
+
+				// The first influence is the pivot of hemisphere.
+				Float4x8 pivot, real, dual;
+				LoadInfluencesAVX2( pPalette, pIndices, influences.stride, &pivot, &dual );
+				__m256 weight = _mm256_mul_ps( _mm256_cvtepi32_ps( _mm256_and_si256( packedWeights, byteMask ) ), weightScale );
+				real = ScaleAVX2( pivot,	weight );
+				dual = ScaleAVX2( dual,		weight );
+				for ( int k = 1; k < INFLUENCE_COUNT; ++k )
+				{
+					packedWeights = _mm256_srli_epi32( packedWeights, 8 );
+					const __m256i integerWeight = _mm256_and_si256( packedWeights, byteMask );
+					// Skip the influence that all the vertices of batch do not have.
+					if ( _mm256_testz_si256( integerWeight, integerWeight ) ) { continue; }
+					// else
+
+					Float4x8 boneReal, boneDual;
+					LoadInfluencesAVX2( pPalette, pIndices + k, influences.stride, &boneReal, &boneDual );
+
+					weight = _mm256_mul_ps( _mm256_cvtepi32_ps( integerWeight ), weightScale );
+					// Negate the weight if the dot is negative.
+					weight = _mm256_xor_ps( weight, _mm256_and_ps( DotAVX2( pivot, boneReal ), signMask ) );
+
+					real = AccumulateAVX2( real, weight, boneReal );
+					dual = AccumulateAVX2( dual, weight, boneDual );
+				}
+
+				const __m256 lengthSq		= DotAVX2( real, real );
+				const __m256 inverseLength	= _mm256_div_ps( _mm256_set1_ps( 1.0f ), _mm256_sqrt_ps( _mm256_max_ps( lengthSq, _mm256_set1_ps( MIN_LENGTH_SQ ) ) ) );
+				real = ScaleAVX2( real, inverseLength );
+				dual = ScaleAVX2( dual, inverseLength );
+
+				const Float3x8 translation	= CalcTranslationAVX2( real, dual );
+				const Float3x8 rotated		= RotateByUnitAVX2( real, LoadFloat3x8( &source.positions[i] ) );
+				StoreFloat3x8
+				(
+					&destination.pPositions[i],
+					Float3x8{ _mm256_add_ps( rotated.x, translation.x ), _mm256_add_ps( rotated.y, translation.y ), _mm256_add_ps( rotated.z, translation.z ) }
+				);
+
+				if ( !skinNormals ) { continue; }
+				// else
+
+				StoreFloat3x8( &destination.pNormals[i], RotateByUnitAVX2( real, LoadFloat3x8( &source.normals[i] ) ) );
+			}
+
+			// Avoid the penalty of transition to the legacy SSE code.
+			_mm256_zeroupper();
+
+			SkinDualQuaternionScalar( source, pPalette, i, end, destination );
+		}
+
+		DualQuaternionKernelFunction GetDualQuaternionKernelFunction( Kernel kernel )
+		{
+			switch ( kernel )
+			{
+			case Kernel::Scalar:	return SkinDualQuaternionScalar;
+			case Kernel::SSE:		return SkinDualQuaternionSSE;
+			case Kernel::AVX2:		return SkinDualQuaternionAVX2;
+			default: break;
+			}
+			return nullptr;
+		}
+
+	// region Dual Quaternion Kernels
+	#pragma endregion
+
+		/// <summary>
+		/// Validates the arguments, then runs the kernel function on the calling thread or on the blocks of vertices by ParallelFor().
+		/// </summary>
+		template<typename PaletteType, typename KernelFunctionType>
+		bool Dispatch( const Source &source, const ArrayView<PaletteType> &palette, const Destination &destination, KernelFunctionType Function, size_t threadCount )
+		{
+			const size_t vertexCount = source.positions.size();
+			if ( !Function ) { return false; }
+			if ( !destination.pPositions || source.influences.count != vertexCount ) { return false; }
+			if ( destination.pNormals && source.normals.size() != vertexCount ) { return false; }
+			// else
+
+			// The kernels do not check the indices.
+			// The bytewise max of the packed indices is found without the branches, it is much faster than the early return per index.
+			const InfluenceStream &influences = source.influences;
+			if ( vertexCount && palette.size() <= UINT8_MAX )
+			{
+				__m128i packedMax = _mm_setzero_si128();
+				for ( size_t i = 0; i < vertexCount; ++i )
+				{
+					packedMax = _mm_max_epu8( packedMax, _mm_cvtsi32_si128( LoadPackedBytes( influences.pIndices + influences.stride * i ) ) );
+				}
+
+				alignas( 16 ) std::uint8_t maxIndices[16];
+				_mm_store_si128( reinterpret_cast<__m128i *>( maxIndices ), packedMax );
+				for ( int k = 0; k < INFLUENCE_COUNT; ++k )
+				{
+					if ( palette.size() <= maxIndices[k] ) { return false; }
+				}
+			}
+
+			const size_t blockCount = ( vertexCount + BLOCK_VERTEX_COUNT - 1 ) / BLOCK_VERTEX_COUNT;
+			if ( vertexCount < MIN_PARALLEL_VERTEX_COUNT || threadCount == 1 )
+			{
+				Function( source, palette.data(), 0, vertexCount, destination );
+				return true;
+			}
+			// else
+
+			ParallelFor
+			(
+				blockCount,
+				[&]( size_t blockIndex )
+				{
+					const size_t begin	= blockIndex * BLOCK_VERTEX_COUNT;
+					const size_t end	= std::min( vertexCount, begin + BLOCK_VERTEX_COUNT );
+					Function( source, palette.data(), begin, end, destination );
+				},
+				threadCount
+			);
+			return true;
+		}
+
+		bool Skin( const Source &source, const ArrayView<XMFLOAT4X4> &palette, const Destination &destination, Kernel kernel, size_t threadCount )
+		{
+			if ( kernel == Kernel::Auto ) { kernel = GetBestKernel(); }
+			if ( !IsSupported( kernel ) ) { return false; }
+			// else
+			return Dispatch( source, palette, destination, GetKernelFunction( kernel ), threadCount );
+		}
+		bool SkinDualQuaternion( const Source &source, const ArrayView<DualQuaternion> &palette, const Destination &destination, Kernel kernel, size_t threadCount )
+		{
+			if ( kernel == Kernel::Auto ) { kernel = GetBestKernel(); }
+			if ( !IsSupported( kernel ) ) { return false; }
+			// else
+			return Dispatch( source, palette, destination, GetDualQuaternionKernelFunction( kernel ), threadCount );
+		}
+
+		/// <summary>
+		/// The "SkinFunction" is called as "SkinFunction( const Destination &, Kernel )".
+		/// </summary>
+		template<typename SkinFunctionType>
+		bool CompareKernels( const Source &source, Kernel kernel, KernelError *pOutput, SkinFunctionType SkinFunction )
+		{
+			const size_t vertexCount	= source.positions.size();
+			const bool   compareNormals	= !source.normals.empty();
+
+			std::vector<Donya::Vector3> referencePositions( vertexCount ), referenceNormals( ( compareNormals ) ? vertexCount : 0 );
+			std::vector<Donya::Vector3> kernelPositions( vertexCount ), kernelNormals( ( compareNormals ) ? vertexCount : 0 );
+
+			Destination reference{};
+			reference.pPositions	= referencePositions.data();
+			reference.pNormals		= ( compareNormals ) ? referenceNormals.data() : nullptr;
+			Destination tested{};
+			tested.pPositions		= kernelPositions.data();
+			tested.pNormals			= ( compareNormals ) ? kernelNormals.data() : nullptr;
+
+			if ( !SkinFunction( reference,	Kernel::Scalar	) ) { return false; }
+			if ( !SkinFunction( tested,		kernel			) ) { return false; }
+			// else
+
+			auto CalcMaxDistance = []( const std::vector<Donya::Vector3> &L, const std::vector<Donya::Vector3> &R )
+			{
+				float maxDistance = 0.0f;
+				const size_t count = L.size();
+				for ( size_t i = 0; i < count; ++i )
+				{
+					const float dx = L[i].x - R[i].x;
+					const float dy = L[i].y - R[i].y;
+					const float dz = L[i].z - R[i].z;
+					maxDistance = std::max( maxDistance, sqrtf( dx * dx + dy * dy + dz * dz ) );
+				}
+				return maxDistance;
+			};
+
+			if ( pOutput )
+			{
+				pOutput->position	= CalcMaxDistance( referencePositions,	kernelPositions	);
+				pOutput->normal		= CalcMaxDistance( referenceNormals,	kernelNormals	);
+			}
+			return true;
+		}
+
+		bool CompareWithReference( const Source &source, const ArrayView<XMFLOAT4X4> &palette, Kernel kernel, KernelError *pOutput )
+		{
+			return CompareKernels
+			(
+				source, kernel, pOutput,
+				[&]( const Destination &destination, Kernel usedKernel )
+				{
+					return Skin( source, palette, destination, usedKernel );
+				}
+			);
+		}
+		bool CompareWithReference( const Source &source, const ArrayView<DualQuaternion> &palette, Kernel kernel, KernelError *pOutput )
+		{
+			return CompareKernels
+			(
+				source, kernel, pOutput,
+				[&]( const Destination &destination, Kernel usedKernel )
+				{
+					return SkinDualQuaternion( source, palette, destination, usedKernel );
+				}
+			);
+		}
+	}
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <DirectXMath.h>
+
+#include "ArrayView.h"
+#include "Quaternion.h"
+#include "Vector.h"
+
+namespace Donya
+{
+	/// <summary>
+	/// The skinning on CPU, for the bounds, the picking, and the headless validation of deformations.<para></para>
+	/// The linear blend skinning uses the matrix palette, the dual quaternion skinning uses the DualQuaternion palette.<para></para>
+	/// The kernels are chosen at run time by the CPUFeatures, and the scalar one is the reference of others.
+	/// </summary>
+	namespace Skinning
+	{
+		enum class Kernel
+		{
+			Auto,		// The fastest one that the CPU supports.
+			Scalar,
+			SSE,
+			AVX2,		// Needs the FMA also.
+		};
+
+		const char *GetKernelName( Kernel kernel );
+		bool IsSupported( Kernel kernel );
+		/// <summary>
+		/// Returns the fastest kernel that the CPU supports, it is never Auto.
+		/// </summary>
+		Kernel GetBestKernel();
+
+		/// <summary>
+		/// The view of the bone influences of vertices, the 4 indices(UINT8) and the 4 weights(UNORM8, the sum is 255) as same as SkinnedMesh::Vertex.<para></para>
+		/// The "stride" is the bytes between the vertices, so it can view into the array of SkinnedMesh::Vertex directly.
+		/// </summary>
+		struct InfluenceStream
+		{
+			const std::uint8_t	*pIndices	= nullptr;
+			const std::uint8_t	*pWeights	= nullptr;
+			size_t				stride		= 0;
+			size_t				count		= 0;
+		public:
+			/// <summary>
+			/// The "VertexType" must have the "boneIndices" and the "boneWeights" that are std::array of 4 std::uint8_t.
+			/// </summary>
+			template<typename VertexType>
+			static InfluenceStream View( const ArrayView<VertexType> &vertices )
+			{
+				InfluenceStream stream{};
+				if ( vertices.empty() ) { return stream; }
+				// else
+
+				stream.pIndices	= vertices[0].boneIndices.data();
+				stream.pWeights	= vertices[0].boneWeights.data();
+				stream.stride	= sizeof( VertexType );
+				stream.count	= vertices.size();
+				return stream;
+			}
+		};
+
+		/// <summary>
+		/// The streams of the bind pose. The normals can be empty if those are not skinned.
+		/// </summary>
+		struct Source
+		{
+			ArrayView<Donya::Vector3>	positions;
+			ArrayView<Donya::Vector3>	normals;
+			InfluenceStream				influences;
+		};
+		/// <summary>
+		/// The arrays must have the vertex count elements. The "pNormals" can be nullptr, then the normals are not skinned.
+		/// </summary>
+		struct Destination
+		{
+			Donya::Vector3				*pPositions	= nullptr;
+			Donya::Vector3				*pNormals	= nullptr;
+		};
+
+		/// <summary>
+		/// Transforms each vertex by the weighted sum of the palette matrices, the "palette[i]" is the matrix of influence index i.<para></para>
+		/// The matrices are row-vector style(position * matrix), e.g. "inverse bind matrix * bone's model matrix".<para></para>
+		/// The normals are transformed by the blended matrix then normalized, so the palette is expected not to have the non-uniform scale.<para></para>
+		/// The many vertices are split into the ranges, those are processed on some threads. The "threadCount" is the same as ParallelFor().<para></para>
+		/// Returns false if the streams are mismatched, some index is out of the palette, or the kernel is not supported.
+		/// </summary>
+		bool Skin( const Source &source, const ArrayView<DirectX::XMFLOAT4X4> &palette, const Destination &destination, Kernel kernel = Kernel::Auto, size_t threadCount = 0 );
+
+		/// <summary>
+		/// The rigid transform as "real + dual * e". The real is the rotation, the dual is "0.5 * translation * real".<para></para>
+		/// It transforms a position as "real * position * real^-1 + translation", as same as Donya::Quaternion::RotateVector().
+		/// </summary>
+		struct DualQuaternion
+		{
+			Donya::Quaternion real{};
+			Donya::Quaternion dual{ 0.0f, 0.0f, 0.0f, 0.0f };
+		public:
+			/// <summary>
+			/// The rotation is normalized.
+			/// </summary>
+			static DualQuaternion Make( const Donya::Quaternion &rotation, const Donya::Vector3 &translation );
+			/// <summary>
+			/// Make from the rigid part of a row-vector style matrix. The scale is removed, because the dual quaternion can not have it.
+			/// </summary>
+			static DualQuaternion Make( const DirectX::XMFLOAT4X4 &matrix );
+		public:
+			Donya::Vector3 GetTranslation() const;
+			Donya::Vector3 TransformPosition( const Donya::Vector3 &position ) const;
+		};
+		static_assert( sizeof( DualQuaternion ) == sizeof( float ) * 8, "The kernels load the real and the dual as the continuous 8 floats." );
+		/// <summary>
+		/// Converts each matrix of the palette by DualQuaternion::Make(). The "pOutput" must have the matrices.size() elements.
+		/// </summary>
+		void MakeDualQuaternionPalette( const ArrayView<DirectX::XMFLOAT4X4> &matrices, DualQuaternion *pOutput );
+
+		/// <summary>
+		/// Transforms each vertex by the normalized weighted sum of the palette dual quaternions, the "palette[i]" is of influence index i.<para></para>
+		/// The dual quaternion that is in the opposite hemisphere of the first influence's one is negated before the sum, so the shorter rotation is blended.<para></para>
+		/// It keeps the volume at the joints, that the linear blend skinning collapses. The normals are rotated only, so those keep the length.<para></para>
+		/// The vertices are processed by the batches of SIMD width. The others are the same as Skin().
+		/// </summary>
+		bool SkinDualQuaternion( const Source &source, const ArrayView<DualQuaternion> &palette, const Destination &destination, Kernel kernel = Kernel::Auto, size_t threadCount = 0 );
+
+		/// <summary>
+		/// The max distances between the results of a kernel and the scalar reference.
+		/// </summary>
+		struct KernelError
+		{
+			float position	= 0.0f;
+			float normal	= 0.0f;
+		};
+		/// <summary>
+		/// Skins by the kernel and by the scalar reference, then compares those. It allocates the temporary outputs.<para></para>
+		/// Returns false if the Skin() failed.
+		/// </summary>
+		bool CompareWithReference( const Source &source, const ArrayView<DirectX::XMFLOAT4X4> &palette, Kernel kernel, KernelError *pOutput );
+		bool CompareWithReference( const Source &source, const ArrayView<DualQuaternion> &palette, Kernel kernel, KernelError *pOutput );
+	}
+}
@@ -0,0 +1,437 @@
+#include "TriangleBVH.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cfloat>
+
+#include "Common.h"
+#include "Useful.h"
+
+namespace Donya
+{
+	namespace
+	{
+		constexpr size_t	BIN_COUNT			= 16;
+		constexpr size_t	MAX_LEAF_SIZE		= 8;		// The larger node is split even if the SAH prefers a leaf.
+		constexpr size_t	MAX_DEPTH			= 60;		// The traversal stack depends on it.
+		constexpr size_t	PARALLEL_THRESHOLD	= 65536;	// The subtree that has fewer triangles is built by one thread.
+		constexpr size_t	TRIANGLE_CHUNK_SIZE	= 16384;	// The unit of preparing the triangles in parallel.
+		constexpr float		TRAVERSAL_COST		= 1.0f;		// Relative to the cost of a ray-triangle test.
+
+		float GetAxis( const Donya::Vector3 &v, size_t axis )
+		{
+			return ( axis == 0 ) ? v.x : ( axis == 1 ) ? v.y : v.z;
+		}
+
+		struct Box
+		{
+			Donya::Vector3 min{  FLT_MAX,  FLT_MAX,  FLT_MAX };
+			Donya::Vector3 max{ -FLT_MAX, -FLT_MAX, -FLT_MAX };
+		public:
+			void Grow( const Donya::Vector3 &point )
+			{
+				min.x = std::min( min.x, point.x );	max.x = std::max( max.x, point.x );
+				min.y = std::min( min.y, point.y );	max.y = std::max( max.y, point.y );
+				min.z = std::min( min.z, point.z );	max.z = std::max( max.z, point.z );
+			}
+			void Grow( const Box &other )
+			{
+				// The empty box is also merged correctly, it has the inverted extent.
+				min.x = std::min( min.x, other.min.x );	max.x = std::max( max.x, other.max.x );
+				min.y = std::min( min.y, other.min.y );	max.y = std::max( max.y, other.max.y );
+				min.z = std::min( min.z, other.min.z );	max.z = std::max( max.z, other.max.z );
+			}
+			/// <summary>
+			/// The half of surface area is enough for comparing the costs.
+			/// </summary>
+			float HalfArea() const
+			{
+				if ( max.x < min.x ) { return 0.0f; }
+				// else
+				const Donya::Vector3 size = max - min;
+				return size.x * size.y + size.y * size.z + size.z * size.x;
+			}
+		};
+
+		/// <summary>
+		/// The triangle while building. These are partitioned directly, so the passes of binning read those sequentially.
+		/// </summary>
+		struct Primitive
+		{
+			Box				box{};
+			Donya::Vector3	centroid{};
+			std::uint32_t	triangle{};
+		};
+
+		struct Bin
+		{
+			Box		box{};
+			size_t	count{};
+		};
+
+		/// <summary>
+		/// The subtree that is built later. The node is already allocated, the triangles are primitives[begin, end).
+		/// </summary>
+		struct BuildTask
+		{
+			std::uint32_t	node;
+			std::uint32_t	begin;
+			std::uint32_t	end;
+			std::uint32_t	depth;
+		};
+
+		/// <summary>
+		/// The nodes are allocated by the atomic counter, so the subtrees can be built concurrently.
+		/// </summary>
+		struct BuildContext
+		{
+			std::vector<Primitive>			&primitives;
+			std::vector<TriangleBVH::Node>	&nodes;
+			std::atomic<std::uint32_t>		nodeCount;
+		public:
+			BuildContext( std::vector<Primitive> &primitives, std::vector<TriangleBVH::Node> &nodes ) :
+				primitives( primitives ), nodes( nodes ), nodeCount( 1 ) // The root is allocated.
+			{}
+		};
+
+		/// <summary>
+		/// Builds the subtree of primitives[begin, end) into the nodes[nodeIndex].<para></para>
+		/// If the "pDeferredTasks" is not nullptr, the children that have fewer triangles than PARALLEL_THRESHOLD are pushed to it instead of building.
+		/// </summary>
+		void BuildNode( BuildContext &context, std::uint32_t nodeIndex, std::uint32_t begin, std::uint32_t end, std::uint32_t depth, std::vector<BuildTask> *pDeferredTasks )
+		{
+			TriangleBVH::Node &node = context.nodes[nodeIndex];
+			const size_t count = end - begin;
+
+			Box box{};
+			Box centroidBox{};
+			for ( std::uint32_t i = begin; i < end; ++i )
+			{
+				box.Grow( context.primitives[i].box );
+				centroidBox.Grow( context.primitives[i].centroid );
+			}
+			node.min = box.min;
+			node.max = box.max;
+
+			auto MakeLeaf = [&]()
+			{
+				node.first = begin;
+				node.count = scast<std::uint32_t>( count );
+			};
+			if ( count <= 1 || MAX_DEPTH <= depth ) { MakeLeaf(); return; }
+			// else
+
+			// Find the cheapest split plane between the bins of centroids, on all axes.
+			size_t	bestAxis	= 0;
+			size_t	bestSplit	= 0;		// The bins[0, bestSplit] go to the left.
+			float	bestCost	= FLT_MAX;
+			for ( size_t axis = 0; axis < 3; ++axis )
+			{
+				const float axisMin = GetAxis( centroidBox.min, axis );
+				const float extent  = GetAxis( centroidBox.max, axis ) - axisMin;
+				if ( extent <= 0.0f ) { continue; }
+				// else
+
+				const float binScale = scast<float>( BIN_COUNT ) / extent;
+				std::array<Bin, BIN_COUNT> bins{};
+				for ( std::uint32_t i = begin; i < end; ++i )
+				{
+					const Primitive &primitive = context.primitives[i];
+					const size_t binIndex = std::min( BIN_COUNT - 1, scast<size_t>( ( GetAxis( primitive.centroid, axis ) - axisMin ) * binScale ) );
+					bins[binIndex].box.Grow( primitive.box );
+					++bins[binIndex].count;
+				}
+
+				// The right side is accumulated from the back.
+				std::array<float, BIN_COUNT - 1> rightCosts{};
+				{
+					Box		rightBox{};
+					size_t	rightCount = 0;
+					for ( size_t b = BIN_COUNT - 1; 0 < b; --b )
+					{
+						rightBox.Grow( bins[b].box );
+						rightCount += bins[b].count;
+						rightCosts[b - 1] = rightBox.HalfArea() * scast<float>( rightCount );
+					}
+				}
+
+				Box		leftBox{};
+				size_t	leftCount = 0;
+				for ( size_t b = 0; b < BIN_COUNT - 1; ++b )
+				{
+					leftBox.Grow( bins[b].box );
+					leftCount += bins[b].count;
+					if ( !leftCount || leftCount == count ) { continue; }
+					// else
+
+					const float cost = leftBox.HalfArea() * scast<float>( leftCount ) + rightCosts[b];
+					if ( cost < bestCost )
+					{
+						bestCost	= cost;
+						bestAxis	= axis;
+						bestSplit	= b;
+					}
+				}
+			}
+
+			// All the centroids are at the same point, these can not be split by position.
+			if ( bestCost == FLT_MAX ) { MakeLeaf(); return; }
+			// else
+
+			const float leafCost	= box.HalfArea() * scast<float>( count );
+			const float splitCost	= box.HalfArea() * TRAVERSAL_COST + bestCost;
+			if ( leafCost <= splitCost && count <= MAX_LEAF_SIZE ) { MakeLeaf(); return; }
+			// else
+
+			const float axisMin  = GetAxis( centroidBox.min, bestAxis );
+			const float binScale = scast<float>( BIN_COUNT ) / ( GetAxis( centroidBox.max, bestAxis ) - axisMin );
+			const auto  itrMid   = std::partition
+			(
+				context.primitives.begin() + begin, context.primitives.begin() + end,
+				[&]( const Primitive &primitive )
+				{
+					const size_t binIndex = std::min( BIN_COUNT - 1, scast<size_t>( ( GetAxis( primitive.centroid, bestAxis ) - axisMin ) * binScale ) );
+					return binIndex <= bestSplit;
+				}
+			);
+			const std::uint32_t mid = scast<std::uint32_t>( itrMid - context.primitives.begin() );
+			if ( mid == begin || mid == end ) { MakeLeaf(); return; } // Never happens, the bins were counted by the same rule.
+			// else
+
+			const std::uint32_t children = context.nodeCount.fetch_add( 2 );
+			node.first = children;
+			node.count = 0;
+
+			const std::array<BuildTask, 2> childTasks
+			{
+				BuildTask{ children,     begin, mid, depth + 1 },
+				BuildTask{ children + 1, mid,   end, depth + 1 }
+			};
+			for ( const auto &it : childTasks )
+			{
+				if ( pDeferredTasks && it.end - it.begin < PARALLEL_THRESHOLD )
+				{
+					pDeferredTasks->emplace_back( it );
+				}
+				else
+				{
+					BuildNode( context, it.node, it.begin, it.end, it.depth, pDeferredTasks );
+				}
+			}
+		}
+
+		bool IntersectBox( const TriangleBVH::Node &node, const Donya::Vector3 &origin, const Donya::Vector3 &inverseDirection, float maxDistance, float *pEntryDistance )
+		{
+			const float tx1 = ( node.min.x - origin.x ) * inverseDirection.x;
+			const float tx2 = ( node.max.x - origin.x ) * inverseDirection.x;
+			const float ty1 = ( node.min.y - origin.y ) * inverseDirection.y;
+			const float ty2 = ( node.max.y - origin.y ) * inverseDirection.y;
+			const float tz1 = ( node.min.z - origin.z ) * inverseDirection.z;
+			const float tz2 = ( node.max.z - origin.z ) * inverseDirection.z;
+
+			const float tMin = std::max( std::max( std::min( tx1, tx2 ), std::min( ty1, ty2 ) ), std::max( std::min( tz1, tz2 ), 0.0f ) );
+			const float tMax = std::min( std::min( std::max( tx1, tx2 ), std::max( ty1, ty2 ) ), std::min( std::max( tz1, tz2 ), maxDistance ) );
+			*pEntryDistance = tMin;
+			return ( tMin <= tMax );
+		}
+	}
+
+	TriangleBVH::TriangleBVH() : nodes(), triangles(), triangleIDs()
+	{}
+
+	void TriangleBVH::Build( const ArrayView<Donya::Vector3> &positions, const ArrayView<std::uint32_t> &indices )
+	{
+		BuildImpl( positions, indices );
+	}
+	void TriangleBVH::Build( const ArrayView<Donya::Vector3> &positions, const ArrayView<std::uint16_t> &indices )
+	{
+		BuildImpl( positions, indices );
+	}
+	void TriangleBVH::Clear()
+	{
+		nodes.clear();
+		triangles.clear();
+		triangleIDs.clear();
+	}
+
+	template<typename IndexType>
+	void TriangleBVH::BuildImpl( const ArrayView<Donya::Vector3> &positions, const ArrayView<IndexType> &indices )
+	{
+		Clear();
+
+		// The triangles that refer out of range are ignored.
+		std::vector<std::uint32_t> validTriangles{};
+		const size_t sourceTriangleCount = indices.size() / 3;
+		for ( size_t t = 0; t < sourceTriangleCount; ++t )
+		{
+			if ( indices[t * 3 + 0] < positions.size() && indices[t * 3 + 1] < positions.size() && indices[t * 3 + 2] < positions.size() )
+			{
+				validTriangles.emplace_back( scast<std::uint32_t>( t ) );
+			}
+		}
+		const size_t triangleCount = validTriangles.size();
+		if ( !triangleCount ) { return; }
+		// else
+
+		auto GetPosition = [&]( std::uint32_t triangle, size_t corner )->const Donya::Vector3 &
+		{
+			return positions[indices[triangle * 3 + corner]];
+		};
+
+		std::vector<Primitive> primitives( triangleCount );
+		Donya::ParallelFor
+		(
+			( triangleCount + TRIANGLE_CHUNK_SIZE - 1 ) / TRIANGLE_CHUNK_SIZE,
+			[&]( size_t chunk )
+			{
+				const size_t end = std::min( triangleCount, ( chunk + 1 ) * TRIANGLE_CHUNK_SIZE );
+				for ( size_t i = chunk * TRIANGLE_CHUNK_SIZE; i < end; ++i )
+				{
+					Primitive &primitive = primitives[i];
+					primitive.box.Grow( GetPosition( validTriangles[i], 0 ) );
+					primitive.box.Grow( GetPosition( validTriangles[i], 1 ) );
+					primitive.box.Grow( GetPosition( validTriangles[i], 2 ) );
+					primitive.centroid = ( primitive.box.min + primitive.box.max ) * 0.5f;
+					primitive.triangle = validTriangles[i];
+				}
+			}
+		);
+
+		// The binary tree that has N leaves has 2N - 1 nodes at most.
+		nodes.resize( triangleCount * 2 - 1 );
+		BuildContext context{ primitives, nodes };
+
+		// The top of the tree is split by this thread, then the subtrees are built in parallel.
+		std::vector<BuildTask> deferredTasks{};
+		if ( triangleCount < PARALLEL_THRESHOLD )
+		{
+			BuildNode( context, 0, 0, scast<std::uint32_t>( triangleCount ), 0, nullptr );
+		}
+		else
+		{
+			BuildNode( context, 0, 0, scast<std::uint32_t>( triangleCount ), 0, &deferredTasks );
+		}
+		Donya::ParallelFor
+		(
+			deferredTasks.size(),
+			[&]( size_t i )
+			{
+				const BuildTask &task = deferredTasks[i];
+				BuildNode( context, task.node, task.begin, task.end, task.depth, nullptr );
+			}
+		);
+		nodes.resize( context.nodeCount.load() );
+		nodes.shrink_to_fit();
+
+		triangles.resize( triangleCount );
+		triangleIDs.resize( triangleCount );
+		for ( size_t i = 0; i < triangleCount; ++i )
+		{
+			const std::uint32_t triangle = primitives[i].triangle;
+			triangles[i]	= Triangle{ GetPosition( triangle, 0 ), GetPosition( triangle, 1 ), GetPosition( triangle, 2 ) };
+			triangleIDs[i]	= triangle;
+		}
+	}
+
+	bool TriangleBVH::Intersect( const Ray &ray, float maxDistance, Hit *pOutput ) const
+	{
+		if ( nodes.empty() ) { return false; }
+		// else
+
+		const Donya::Vector3 &origin	= ray.origin;
+		const Donya::Vector3 &direction	= ray.direction;
+		// The division by zero makes the infinity, the slab test works with it.
+		const Donya::Vector3 inverseDirection{ 1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z };
+
+		float	closest		= maxDistance;
+		Hit		closestHit{};
+		bool	isHit		= false;
+
+		struct Entry
+		{
+			std::uint32_t	node;
+			float			distance;
+		};
+		// The nearer child is popped first, so the stack has one entry per depth at most.
+		std::array<Entry, MAX_DEPTH + 4> stack{};
+		size_t stackSize = 0;
+
+		float rootDistance{};
+		if ( !IntersectBox( nodes[0], origin, inverseDirection, closest, &rootDistance ) ) { return false; }
+		// else
+		stack[stackSize++] = Entry{ 0U, rootDistance };
+
+		while ( stackSize )
+		{
+			const Entry entry = stack[--stackSize];
+			if ( closest < entry.distance ) { continue; } // A closer hit is found after pushed.
+			// else
+
+			const Node &node = nodes[entry.node];
+			if ( node.count )
+			{
+				// Moller-Trumbore.
+				const std::uint32_t end = node.first + node.count;
+				for ( std::uint32_t i = node.first; i < end; ++i )
+				{
+					const Triangle &triangle = triangles[i];
+					const Donya::Vector3 edge1 = triangle.p1 - triangle.p0;
+					const Donya::Vector3 edge2 = triangle.p2 - triangle.p0;
+					const Donya::Vector3 pVec  = Donya::Vector3::Cross( direction, edge2 );
+					const float determinant = Donya::Vector3::Dot( edge1, pVec );
+					if ( determinant == 0.0f ) { continue; } // Parallel to the plane, or degenerated.
+					// else
+
+					const float inverseDeterminant = 1.0f / determinant;
+					const Donya::Vector3 tVec = origin - triangle.p0;
+					const float u = Donya::Vector3::Dot( tVec, pVec ) * inverseDeterminant;
+					if ( u < 0.0f || 1.0f < u ) { continue; }
+					// else
+
+					const Donya::Vector3 qVec = Donya::Vector3::Cross( tVec, edge1 );
+					const float v = Donya::Vector3::Dot( direction, qVec ) * inverseDeterminant;
+					if ( v < 0.0f || 1.0f < u + v ) { continue; }
+					// else
+
+					const float distance = Donya::Vector3::Dot( edge2, qVec ) * inverseDeterminant;
+					if ( distance < 0.0f || closest < distance ) { continue; }
+					// else
+
+					closest = distance;
+					closestHit.distance	= distance;
+					closestHit.triangle	= triangleIDs[i];
+					closestHit.u		= u;
+					closestHit.v		= v;
+					isHit = true;
+				}
+				continue;
+			}
+			// else
+
+			float leftDistance{};
+			float rightDistance{};
+			const bool isHitLeft	= IntersectBox( nodes[node.first    ], origin, inverseDirection, closest, &leftDistance  );
+			const bool isHitRight	= IntersectBox( nodes[node.first + 1], origin, inverseDirection, closest, &rightDistance );
+			if ( isHitLeft && isHitRight )
+			{
+				// Push the farther first.
+				if ( leftDistance < rightDistance )
+				{
+					stack[stackSize++] = Entry{ node.first + 1, rightDistance };
+					stack[stackSize++] = Entry{ node.first,     leftDistance  };
+				}
+				else
+				{
+					stack[stackSize++] = Entry{ node.first,     leftDistance  };
+					stack[stackSize++] = Entry{ node.first + 1, rightDistance };
+				}
+			}
+			else if ( isHitLeft  ) { stack[stackSize++] = Entry{ node.first,     leftDistance  }; }
+			else if ( isHitRight ) { stack[stackSize++] = Entry{ node.first + 1, rightDistance }; }
+		}
+
+		if ( isHit ) { *pOutput = closestHit; }
+		return isHit;
+	}
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ArrayView.h"
+#include "Vector.h"
+
+namespace Donya
+{
+	/// <summary>
+	/// The bounding volume hierarchy of the triangles of a mesh, for the ray queries(e.g. mouse picking).<para></para>
+	/// It is built by the binned SAH(Surface Area Heuristic), and the large subtrees are built in parallel.<para></para>
+	/// It does not use any GPU resource, so it can be used without a device.
+	/// </summary>
+	class TriangleBVH
+	{
+	public:
+		/// <summary>
+		/// The point is "origin + direction * t". The direction is not need to be normalized.
+		/// </summary>
+		struct Ray
+		{
+			Donya::Vector3 origin{};
+			Donya::Vector3 direction{};
+		};
+		struct Hit
+		{
+			float			distance{};	// The "t" of the Ray.
+			std::uint32_t	triangle{};	// The position in the source indices is "triangle * 3".
+			float			u{};		// The barycentric coordinates, the hit position is "p0 * ( 1 - u - v ) + p1 * u + p2 * v".
+			float			v{};
+		};
+		/// <summary>
+		/// The node is a leaf if the count is not zero, then the triangles are [first, first + count) of the ordered triangles.<para></para>
+		/// Else the children are nodes[first] and nodes[first + 1].
+		/// </summary>
+		struct Node
+		{
+			Donya::Vector3	min;
+			std::uint32_t	first;
+			Donya::Vector3	max;
+			std::uint32_t	count;
+		};
+		/// <summary>
+		/// The positions of a triangle, these are stored in the order of leaves for the locality.
+		/// </summary>
+		struct Triangle
+		{
+			Donya::Vector3 p0;
+			Donya::Vector3 p1;
+			Donya::Vector3 p2;
+		};
+	private:
+		std::vector<Node>			nodes;
+		std::vector<Triangle>		triangles;
+		std::vector<std::uint32_t>	triangleIDs;	// The source triangle of each ordered triangle.
+	public:
+		TriangleBVH();
+		~TriangleBVH() = default;
+		TriangleBVH( const TriangleBVH & ) = default;
+		TriangleBVH( TriangleBVH && ) = default;
+		TriangleBVH &operator = ( const TriangleBVH & ) = default;
+		TriangleBVH &operator = ( TriangleBVH && ) = default;
+	public:
+		/// <summary>
+		/// Builds from the triangle list. The triangle that has an index out of range is ignored.<para></para>
+		/// The previous hierarchy is discarded.
+		/// </summary>
+		void Build( const ArrayView<Donya::Vector3> &positions, const ArrayView<std::uint32_t> &indices );
+		void Build( const ArrayView<Donya::Vector3> &positions, const ArrayView<std::uint16_t> &indices );
+		void Clear();
+	public:
+		/// <summary>
+		/// Finds the closest hit that the distance is in [0.0f, maxDistance]. The back faces are also hit.<para></para>
+		/// Returns false if there is no hit, then the "pOutput" is not changed.
+		/// </summary>
+		bool Intersect( const Ray &ray, float maxDistance, Hit *pOutput ) const;
+
+		bool	IsEmpty()			const { return nodes.empty();		}
+		size_t	GetNodeCount()		const { return nodes.size();		}
+		size_t	GetTriangleCount()	const { return triangles.size();	}
+	private:
+		template<typename IndexType>
+		void BuildImpl( const ArrayView<Donya::Vector3> &positions, const ArrayView<IndexType> &indices );
+	};
+}
@@ -1,13 +1,20 @@
 #include "Useful.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <condition_variable>
 #include <crtdbg.h>
 #include <d3d11.h>
+#include <deque>
 #include <float.h>
 #include <fstream>
 #include <locale>
+#include <memory>
 #include <mutex>
+#include <system_error>
 #include <Shlwapi.h>	// Use PathRemoveFileSpecA(), PathAddBackslashA(), In AcquireDirectoryFromFullPath().
+#include <thread>
 #include <vector>
 #include <Windows.h>
 
@@ -125,6 +132,35 @@ namespace Donya
 		return ifs.is_open();
 	}
 
+	std::string MakeTemporaryFilePath( const std::string &destinationPath )
+	{
+		return	destinationPath + "."
+				+ std::to_string( GetCurrentProcessId() ) + "-"
+				+ std::to_string( GetCurrentThreadId() ) + ".tmp";
+	}
+	bool ReplaceFileAtomically( const std::string &sourcePath, const std::string &destinationPath, std::string *outputErrorString )
+	{
+		// The rename in same volume is atomic.
+		const BOOL result = MoveFileExA( sourcePath.c_str(), destinationPath.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH );
+		if ( !result )
+		{
+			// Fetch the error before DeleteFileA() overwrites it.
+			const DWORD errorCode = GetLastError();
+			DeleteFileA( sourcePath.c_str() );
+
+			if ( outputErrorString )
+			{
+				*outputErrorString =
+					"Failed to replace \"" + destinationPath + "\" : "
+					+ std::system_category().message( scast<int>( errorCode ) )
+					+ "(" + std::to_string( errorCode ) + ")";
+			}
+			return false;
+		}
+		// else
+		return true;
+	}
+
 #pragma region Convert Character Functions
 
 #define USE_WIN_API ( true )
@@ -310,4 +346,178 @@ namespace Donya
 
 		return fullPath.substr( fileDirectory.size() );
 	}
+
+#pragma region ParallelFor
+
+	namespace
+	{
+		/// <summary>
+		/// The indices of a ParallelFor() call, those are taken by the caller and the helpers of the pool.
+		/// </summary>
+		struct ParallelJob
+		{
+			const std::function<void( size_t index )>	*pFunction		= nullptr;
+			size_t										count			= 0;
+			size_t										maxHelperCount	= 0;
+			size_t										helperCount		= 0;	// Guarded by the mutex of pool.
+			std::atomic<size_t>							nextIndex{ 0 };
+
+			std::mutex									doneMutex;
+			std::condition_variable						doneCondition;
+			size_t										doneCount		= 0;	// Guarded by the "doneMutex".
+		public:
+			bool IsExhausted() const { return ( count <= nextIndex.load() ); }
+			void Work()
+			{
+				size_t calledCount = 0;
+				for ( size_t i = nextIndex++; i < count; i = nextIndex++ )
+				{
+					( *pFunction )( i );
+					++calledCount;
+				}
+				if ( !calledCount ) { return; }
+				// else
+
+				std::lock_guard<std::mutex> lock( doneMutex );
+				doneCount += calledCount;
+				if ( doneCount == count ) { doneCondition.notify_all(); }
+			}
+			void WaitUntilDone()
+			{
+				std::unique_lock<std::mutex> lock( doneMutex );
+				doneCondition.wait( lock, [this]() { return doneCount == count; } );
+			}
+		};
+
+		/// <summary>
+		/// The persistent threads that help the ParallelFor() calls, so a call does not create threads.<para></para>
+		/// Some calls can be in progress at the same time(e.g. from the loading threads), those share the helpers.
+		/// </summary>
+		class ParallelForPool
+		{
+		private:
+			std::mutex									mutex;
+			std::condition_variable						condition;
+			std::deque<std::shared_ptr<ParallelJob>>	jobs;
+			std::vector<std::thread>					threads;
+			bool										isTerminating = false;
+		public:
+			static thread_local bool isPoolThread;
+		public:
+			ParallelForPool( size_t threadCount )
+			{
+				threads.reserve( threadCount );
+				for ( size_t i = 0; i < threadCount; ++i )
+				{
+					threads.emplace_back( [this]() { Run(); } );
+				}
+			}
+			~ParallelForPool()
+			{
+				{
+					std::lock_guard<std::mutex> lock( mutex );
+					isTerminating = true;
+				}
+				condition.notify_all();
+
+				for ( auto &it : threads )
+				{
+					it.join();
+				}
+			}
+		public:
+			size_t GetThreadCount() const { return threads.size(); }
+			void Push( const std::shared_ptr<ParallelJob> &pJob )
+			{
+				{
+					std::lock_guard<std::mutex> lock( mutex );
+					jobs.emplace_back( pJob );
+				}
+				condition.notify_all();
+			}
+		private:
+			/// <summary>
+			/// Returns the first job that needs a helper, the exhausted jobs are removed. Call it with the lock.
+			/// </summary>
+			std::shared_ptr<ParallelJob> FindJob()
+			{
+				jobs.erase
+				(
+					std::remove_if( jobs.begin(), jobs.end(), []( const std::shared_ptr<ParallelJob> &pJob ) { return pJob->IsExhausted(); } ),
+					jobs.end()
+				);
+				for ( const auto &pJob : jobs )
+				{
+					if ( pJob->helperCount < pJob->maxHelperCount ) { return pJob; }
+				}
+				return nullptr;
+			}
+			void Run()
+			{
+				isPoolThread = true;
+
+				while ( true )
+				{
+					std::shared_ptr<ParallelJob> pJob{};
+					{
+						std::unique_lock<std::mutex> lock( mutex );
+						condition.wait( lock, [&]() { return isTerminating || ( pJob = FindJob() ) != nullptr; } );
+						if ( isTerminating ) { return; }
+						// else
+						++pJob->helperCount;
+					}
+
+					pJob->Work();
+				}
+			}
+		};
+		thread_local bool ParallelForPool::isPoolThread = false;
+
+		ParallelForPool &GetParallelForPool()
+		{
+			// The calling thread is also a worker, so the pool does not need the thread for it.
+			const size_t hardwareCount = scast<size_t>( std::thread::hardware_concurrency() );
+			static ParallelForPool pool{ ( hardwareCount ) ? hardwareCount - 1 : 0 };
+			return pool;
+		}
+	}
+
+	void ParallelFor( size_t count, const std::function<void( size_t index )> &function, size_t threadCount )
+	{
+		if ( !count ) { return; }
+		// else
+
+		// The nested call(e.g. from the function of outer call) is processed by its thread only,
+		// because the helpers are already busy and the waiting of helper for helper may never end.
+		if ( ParallelForPool::isPoolThread || threadCount == 1 || count == 1 )
+		{
+			for ( size_t i = 0; i < count; ++i )
+			{
+				function( i );
+			}
+			return;
+		}
+		// else
+
+		ParallelForPool &pool = GetParallelForPool();
+		if ( !threadCount ) { threadCount = pool.GetThreadCount() + 1; }
+
+		if ( count < threadCount ) { threadCount = count; }
+
+		auto pJob = std::make_shared<ParallelJob>();
+		pJob->pFunction			= &function;
+		pJob->count				= count;
+		pJob->maxHelperCount	= threadCount - 1;
+		if ( pool.GetThreadCount() < pJob->maxHelperCount ) { pJob->maxHelperCount = pool.GetThreadCount(); }
+		if ( pJob->maxHelperCount )
+		{
+			pool.Push( pJob );
+		}
+
+		pJob->Work();
+		pJob->WaitUntilDone();
+	}
+
+// region ParallelFor
+#pragma endregion
 }
\ No newline at end of file
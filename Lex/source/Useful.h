@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <string>
 
 struct ID3D11Buffer;
@@ -20,6 +21,18 @@ namespace Donya
 	bool IsExistFile( const std::string &wholePath );
 	bool IsExistFile( const std::wstring &wholePath );
 
+	/// <summary>
+	/// Returns the path that is unique for each process and thread, e.g. "destinationPath.1234-5678.tmp".<para></para>
+	/// Write to this, then call ReplaceFileAtomically().
+	/// </summary>
+	std::string MakeTemporaryFilePath( const std::string &destinationPath );
+	/// <summary>
+	/// Move the "sourcePath" file to "destinationPath", replace it if exists.<para></para>
+	/// The readers of "destinationPath" see either the old file or the new file, never a partially written file.<para></para>
+	/// The source file is deleted if failed, and the reason(e.g. the destination is opened without FILE_SHARE_DELETE) is written to "outputErrorString" if it is not null.
+	/// </summary>
+	bool ReplaceFileAtomically( const std::string &sourcePath, const std::string &destinationPath, std::string *outputErrorString = nullptr );
+
 #pragma region Convert Character Functions
 
 	/// <summary>
@@ -67,4 +80,13 @@ namespace Donya
 	/// If fullPath is invalid, returns ""(You can error-check with std::string::empty());
 	/// </summary>
 	std::string ExtractFileNameFromFullPath( std::string fullPath );
+
+	/// <summary>
+	/// Calls the "function" with each index of [0, count) on some threads, and returns after all calls are finished.<para></para>
+	/// The calling thread is also used as one of workers, the others are the persistent threads of a pool, so a call does not create any threads.<para></para>
+	/// If the "threadCount" is zero, I use all threads of the pool(std::thread::hardware_concurrency() in total).<para></para>
+	/// If it is called from the "function" of other call, it is processed by the calling thread only.<para></para>
+	/// The order of calls is not guaranteed, so the "function" should write only to the region of its index.
+	/// </summary>
+	void ParallelFor( size_t count, const std::function<void( size_t index )> &function, size_t threadCount = 0 );
 }
@@ -0,0 +1,360 @@
+#include "VertexQuantization.h"
+
+#include <cmath>
+#include <DirectXPackedVector.h>
+
+#include "Common.h"
+
+namespace Donya
+{
+	namespace VertexQuantization
+	{
+		constexpr float UNORM16_MAX = 65535.0f;
+
+		const char *GetEncodingName( Encoding encoding )
+		{
+			switch ( encoding )
+			{
+			case Encoding::Float32:			return "Float32";
+			case Encoding::Unorm16:			return "Unorm16";
+			case Encoding::Octahedral8:		return "Octahedral8";
+			case Encoding::Octahedral16:	return "Octahedral16";
+			case Encoding::Half:			return "Half";
+			default: break;
+			}
+			return "Unknown";
+		}
+
+		/// <summary>
+		/// Keeps the NaN error as infinity, so the encoding that made it is never chosen.
+		/// </summary>
+		void UpdateMaxError( float error, float *pMaxError )
+		{
+			if ( error <= *pMaxError ) { return; }
+			// else
+			*pMaxError = ( std::isnan( error ) ) ? HUGE_VALF : error;
+		}
+
+	#pragma region Position
+
+		PositionFrame MakePositionFrame( const ArrayView<Donya::Vector3> &positions )
+		{
+			PositionFrame frame{};
+			if ( positions.empty() ) { return frame; }
+			// else
+
+			Donya::Vector3 min = positions[0];
+			Donya::Vector3 max = positions[0];
+			for ( const auto &it : positions )
+			{
+				min.x = ( it.x < min.x ) ? it.x : min.x;
+				min.y = ( it.y < min.y ) ? it.y : min.y;
+				min.z = ( it.z < min.z ) ? it.z : min.z;
+				max.x = ( max.x < it.x ) ? it.x : max.x;
+				max.y = ( max.y < it.y ) ? it.y : max.y;
+				max.z = ( max.z < it.z ) ? it.z : max.z;
+			}
+
+			frame.offset	= min;
+			frame.scale		= Donya::Vector3{ max.x - min.x, max.y - min.y, max.z - min.z };
+			return frame;
+		}
+
+		std::uint16_t EncodeUnorm16( float value, float offset, float scale )
+		{
+			if ( scale <= 0.0f ) { return 0; }
+			// else
+
+			float normalized = ( value - offset ) / scale;
+			normalized = ( normalized < 0.0f ) ? 0.0f : ( 1.0f < normalized ) ? 1.0f : normalized;
+			return scast<std::uint16_t>( normalized * UNORM16_MAX + 0.5f );
+		}
+		QuantizedPosition EncodePosition( const Donya::Vector3 &position, const PositionFrame &frame )
+		{
+			QuantizedPosition quantized{};
+			quantized.x = EncodeUnorm16( position.x, frame.offset.x, frame.scale.x );
+			quantized.y = EncodeUnorm16( position.y, frame.offset.y, frame.scale.y );
+			quantized.z = EncodeUnorm16( position.z, frame.offset.z, frame.scale.z );
+			return quantized;
+		}
+		Donya::Vector3 DecodePosition( const QuantizedPosition &position, const PositionFrame &frame )
+		{
+			return Donya::Vector3
+			{
+				frame.offset.x + scast<float>( position.x ) / UNORM16_MAX * frame.scale.x,
+				frame.offset.y + scast<float>( position.y ) / UNORM16_MAX * frame.scale.y,
+				frame.offset.z + scast<float>( position.z ) / UNORM16_MAX * frame.scale.z
+			};
+		}
+
+	// region Position
+	#pragma endregion
+
+	#pragma region Normal
+
+		float SignNotZero( float value )
+		{
+			return ( value < 0.0f ) ? -1.0f : 1.0f;
+		}
+
+		/// <summary>
+		/// The "x" and "y" are [-1.0f ~ +1.0f].
+		/// </summary>
+		Donya::Vector3 DecodeOctahedral( float x, float y )
+		{
+			float z = 1.0f - fabsf( x ) - fabsf( y );
+			if ( z < 0.0f )
+			{
+				// Unfold the lower hemisphere.
+				const float foldedX = x;
+				x = ( 1.0f - fabsf( y		) ) * SignNotZero( foldedX	);
+				y = ( 1.0f - fabsf( foldedX	) ) * SignNotZero( y		);
+			}
+
+			const float length = sqrtf( x * x + y * y + z * z );
+			return Donya::Vector3{ x / length, y / length, z / length };
+		}
+
+		template<typename Normal, typename Component, int MAX>
+		Normal EncodeOctahedral( const Donya::Vector3 &normal )
+		{
+			const float sum = fabsf( normal.x ) + fabsf( normal.y ) + fabsf( normal.z );
+			if ( !( 0.0f < sum ) ) { return Normal{}; }
+			// else
+
+			// Project onto the octahedron, then fold the lower hemisphere onto the upper one.
+			float x = normal.x / sum;
+			float y = normal.y / sum;
+			if ( normal.z < 0.0f )
+			{
+				const float projectedX = x;
+				x = ( 1.0f - fabsf( y			) ) * SignNotZero( projectedX	);
+				y = ( 1.0f - fabsf( projectedX	) ) * SignNotZero( y			);
+			}
+
+			// The rounding to nearest is not always the best after the decode, so I try the four grid points around.
+			const float length = sqrtf( normal.x * normal.x + normal.y * normal.y + normal.z * normal.z );
+			const float floorX = floorf( x * MAX );
+			const float floorY = floorf( y * MAX );
+
+			Normal	best{};
+			float	bestDot = -2.0f;
+			for ( int i = 0; i < 4; ++i )
+			{
+				float gridX = floorX + scast<float>( i & 1 );
+				float gridY = floorY + scast<float>( i >> 1 );
+				gridX = ( gridX < -MAX ) ? -MAX : ( MAX < gridX ) ? MAX : gridX;
+				gridY = ( gridY < -MAX ) ? -MAX : ( MAX < gridY ) ? MAX : gridY;
+
+				const Donya::Vector3 decoded = DecodeOctahedral( gridX / MAX, gridY / MAX );
+				const float dot = ( decoded.x * normal.x + decoded.y * normal.y + decoded.z * normal.z ) / length;
+				if ( bestDot < dot )
+				{
+					bestDot	= dot;
+					best.x	= scast<Component>( gridX );
+					best.y	= scast<Component>( gridY );
+				}
+			}
+			return best;
+		}
+
+		OctahedralNormal8 EncodeNormal8( const Donya::Vector3 &normal )
+		{
+			return EncodeOctahedral<OctahedralNormal8, std::int8_t, INT8_MAX>( normal );
+		}
+		OctahedralNormal16 EncodeNormal16( const Donya::Vector3 &normal )
+		{
+			return EncodeOctahedral<OctahedralNormal16, std::int16_t, INT16_MAX>( normal );
+		}
+		Donya::Vector3 DecodeNormal( const OctahedralNormal8 &normal )
+		{
+			// The SNORM maps both -128 and -127 to -1.0f.
+			const float x = scast<float>( normal.x ) / INT8_MAX;
+			const float y = scast<float>( normal.y ) / INT8_MAX;
+			return DecodeOctahedral( ( x < -1.0f ) ? -1.0f : x, ( y < -1.0f ) ? -1.0f : y );
+		}
+		Donya::Vector3 DecodeNormal( const OctahedralNormal16 &normal )
+		{
+			const float x = scast<float>( normal.x ) / INT16_MAX;
+			const float y = scast<float>( normal.y ) / INT16_MAX;
+			return DecodeOctahedral( ( x < -1.0f ) ? -1.0f : x, ( y < -1.0f ) ? -1.0f : y );
+		}
+
+		/// <summary>
+		/// Returns the angle in degrees. It is computed by double, because the acos() of float is not precise around zero degrees.
+		/// </summary>
+		float CalcAngleError( const Donya::Vector3 &source, const Donya::Vector3 &decoded )
+		{
+			const double sx = source.x, sy = source.y, sz = source.z;
+			const double dx = decoded.x, dy = decoded.y, dz = decoded.z;
+			const double crossX = sy * dz - sz * dy;
+			const double crossY = sz * dx - sx * dz;
+			const double crossZ = sx * dy - sy * dx;
+			const double sine	= sqrt( crossX * crossX + crossY * crossY + crossZ * crossZ );
+			const double cosine	= sx * dx + sy * dy + sz * dz;
+
+			constexpr double TO_DEGREE = 180.0 / 3.14159265358979323846;
+			return scast<float>( atan2( sine, cosine ) * TO_DEGREE );
+		}
+
+	// region Normal
+	#pragma endregion
+
+		HalfTexCoord EncodeTexCoord( const Donya::Vector2 &texCoord )
+		{
+			HalfTexCoord quantized{};
+			quantized.u = DirectX::PackedVector::XMConvertFloatToHalf( texCoord.x );
+			quantized.v = DirectX::PackedVector::XMConvertFloatToHalf( texCoord.y );
+			return quantized;
+		}
+		Donya::Vector2 DecodeTexCoord( const HalfTexCoord &texCoord )
+		{
+			return Donya::Vector2
+			{
+				DirectX::PackedVector::XMConvertHalfToFloat( texCoord.u ),
+				DirectX::PackedVector::XMConvertHalfToFloat( texCoord.v )
+			};
+		}
+
+		QuantizedAttributes Quantize( const ArrayView<Donya::Vector3> &positions, const ArrayView<Donya::Vector3> &normals, const ArrayView<Donya::Vector2> &texCoords, const Tolerance &tolerance )
+		{
+			QuantizedAttributes result{};
+			Report &report = result.report;
+
+			if ( !positions.empty() )
+			{
+				const PositionFrame frame = MakePositionFrame( positions );
+				float largestExtent = ( frame.scale.x < frame.scale.y ) ? frame.scale.y : frame.scale.x;
+				largestExtent = ( largestExtent < frame.scale.z ) ? frame.scale.z : largestExtent;
+
+				std::vector<QuantizedPosition> encoded( positions.size() );
+				float maxError = 0.0f;
+				for ( size_t i = 0; i < positions.size(); ++i )
+				{
+					encoded[i] = EncodePosition( positions[i], frame );
+
+					const Donya::Vector3 decoded = DecodePosition( encoded[i], frame );
+					const float dx = decoded.x - positions[i].x;
+					const float dy = decoded.y - positions[i].y;
+					const float dz = decoded.z - positions[i].z;
+					UpdateMaxError( sqrtf( dx * dx + dy * dy + dz * dz ), &maxError );
+				}
+
+				if ( maxError <= tolerance.position * largestExtent )
+				{
+					result.positionFrame	= frame;
+					result.positions		= std::move( encoded );
+					report.positionEncoding	= Encoding::Unorm16;
+					report.positionError	= maxError;
+				}
+			}
+
+			if ( !normals.empty() )
+			{
+				auto EncodeAll = [&normals]( auto Encode, auto *pOutput )
+				{
+					pOutput->resize( normals.size() );
+
+					float maxError = 0.0f;
+					for ( size_t i = 0; i < normals.size(); ++i )
+					{
+						( *pOutput )[i] = Encode( normals[i] );
+
+						// The zero vector has no direction, so any decoded one is fine.
+						const auto &source = normals[i];
+						if ( source.x == 0.0f && source.y == 0.0f && source.z == 0.0f ) { continue; }
+						// else
+						UpdateMaxError( CalcAngleError( source, DecodeNormal( ( *pOutput )[i] ) ), &maxError );
+					}
+					return maxError;
+				};
+
+				const float error8 = EncodeAll( EncodeNormal8, &result.normals8 );
+				if ( error8 <= tolerance.normal )
+				{
+					report.normalEncoding	= Encoding::Octahedral8;
+					report.normalError		= error8;
+				}
+				else
+				{
+					result.normals8.clear();
+
+					const float error16 = EncodeAll( EncodeNormal16, &result.normals16 );
+					if ( error16 <= tolerance.normal )
+					{
+						report.normalEncoding	= Encoding::Octahedral16;
+						report.normalError		= error16;
+					}
+					else
+					{
+						result.normals16.clear();
+					}
+				}
+			}
+
+			if ( !texCoords.empty() )
+			{
+				std::vector<HalfTexCoord> encoded( texCoords.size() );
+				float maxError = 0.0f;
+				for ( size_t i = 0; i < texCoords.size(); ++i )
+				{
+					encoded[i] = EncodeTexCoord( texCoords[i] );
+
+					const Donya::Vector2 decoded = DecodeTexCoord( encoded[i] );
+					UpdateMaxError( fabsf( decoded.x - texCoords[i].x ), &maxError );
+					UpdateMaxError( fabsf( decoded.y - texCoords[i].y ), &maxError );
+				}
+
+				if ( maxError <= tolerance.texCoord )
+				{
+					result.texCoords		= std::move( encoded );
+					report.texCoordEncoding	= Encoding::Half;
+					report.texCoordError	= maxError;
+				}
+			}
+
+			return result;
+		}
+
+		std::vector<Donya::Vector3> DecodePositions( const ArrayView<QuantizedPosition> &positions, const PositionFrame &frame )
+		{
+			std::vector<Donya::Vector3> decoded{};
+			decoded.reserve( positions.size() );
+			for ( const auto &it : positions )
+			{
+				decoded.emplace_back( DecodePosition( it, frame ) );
+			}
+			return decoded;
+		}
+		std::vector<Donya::Vector3> DecodeNormals( const ArrayView<OctahedralNormal8> &normals )
+		{
+			std::vector<Donya::Vector3> decoded{};
+			decoded.reserve( normals.size() );
+			for ( const auto &it : normals )
+			{
+				decoded.emplace_back( DecodeNormal( it ) );
+			}
+			return decoded;
+		}
+		std::vector<Donya::Vector3> DecodeNormals( const ArrayView<OctahedralNormal16> &normals )
+		{
+			std::vector<Donya::Vector3> decoded{};
+			decoded.reserve( normals.size() );
+			for ( const auto &it : normals )
+			{
+				decoded.emplace_back( DecodeNormal( it ) );
+			}
+			return decoded;
+		}
+		std::vector<Donya::Vector2> DecodeTexCoords( const ArrayView<HalfTexCoord> &texCoords )
+		{
+			std::vector<Donya::Vector2> decoded{};
+			decoded.reserve( texCoords.size() );
+			for ( const auto &it : texCoords )
+			{
+				decoded.emplace_back( DecodeTexCoord( it ) );
+			}
+			return decoded;
+		}
+	}
+}
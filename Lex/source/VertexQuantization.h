@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "ArrayView.h"
+#include "Vector.h"
+
+namespace Donya
+{
+	/// <summary>
+	/// The compact encodings of vertex attributes, for the native file(and the import cache) and the vertex buffer.<para></para>
+	/// Positions : UNORM16 relative to the bounds of mesh.<para></para>
+	/// Normals : Octahedral SNORM8 or SNORM16.<para></para>
+	/// TexCoords : Half float.
+	/// </summary>
+	namespace VertexQuantization
+	{
+		/// <summary>
+		/// Do not change the values, these are saved in the file.
+		/// </summary>
+		enum class Encoding : std::uint32_t
+		{
+			Float32			= 0,	// Not quantized.
+			Unorm16			= 1,
+			Octahedral8		= 2,
+			Octahedral16	= 3,
+			Half			= 4,
+		};
+
+		/// <summary>
+		/// The max error that is allowed per attribute. The attribute that can not be kept within it is stored as Float32.
+		/// </summary>
+		struct Tolerance
+		{
+			float position	= 1.0e-4f;			// Relative to the largest extent of the mesh bounds.
+			float normal	= 0.5f;				// Degrees.
+			float texCoord	= 1.0f / 4096.0f;	// UV units.
+		};
+
+		/// <summary>
+		/// The chosen encodings and the measured max errors of a mesh. The units of errors are the same as Tolerance, except the position is absolute.
+		/// </summary>
+		struct Report
+		{
+			Encoding	positionEncoding	= Encoding::Float32;
+			Encoding	normalEncoding		= Encoding::Float32;
+			Encoding	texCoordEncoding	= Encoding::Float32;
+			float		positionError		= 0.0f;
+			float		normalError			= 0.0f;
+			float		texCoordError		= 0.0f;
+		};
+
+		const char *GetEncodingName( Encoding encoding );
+
+	#pragma region Elements
+
+		/// <summary>
+		/// The decoded position is "offset + unorm * scale", the unorm is [0.0f ~ 1.0f].
+		/// </summary>
+		struct PositionFrame
+		{
+			Donya::Vector3 offset;
+			Donya::Vector3 scale;
+		};
+		struct QuantizedPosition
+		{
+			std::uint16_t x, y, z;
+		};
+		struct OctahedralNormal8
+		{
+			std::int8_t x, y;
+		};
+		struct OctahedralNormal16
+		{
+			std::int16_t x, y;
+		};
+		struct HalfTexCoord
+		{
+			std::uint16_t u, v;
+		};
+
+		static_assert( sizeof( QuantizedPosition	) == 6, "The size is saved in the file." );
+		static_assert( sizeof( OctahedralNormal8	) == 2, "The size is saved in the file." );
+		static_assert( sizeof( OctahedralNormal16	) == 4, "The size is saved in the file." );
+		static_assert( sizeof( HalfTexCoord			) == 4, "The size is saved in the file." );
+
+	// region Elements
+	#pragma endregion
+
+		/// <summary>
+		/// Returns the frame that covers the bounds of positions. The scale of flat axis is zero.
+		/// </summary>
+		PositionFrame		MakePositionFrame( const ArrayView<Donya::Vector3> &positions );
+
+		QuantizedPosition	EncodePosition( const Donya::Vector3 &position, const PositionFrame &frame );
+		Donya::Vector3		DecodePosition( const QuantizedPosition &position, const PositionFrame &frame );
+		/// <summary>
+		/// The normal is not need to be normalized. The decoded one is normalized.
+		/// </summary>
+		OctahedralNormal8	EncodeNormal8( const Donya::Vector3 &normal );
+		OctahedralNormal16	EncodeNormal16( const Donya::Vector3 &normal );
+		Donya::Vector3		DecodeNormal( const OctahedralNormal8 &normal );
+		Donya::Vector3		DecodeNormal( const OctahedralNormal16 &normal );
+		HalfTexCoord		EncodeTexCoord( const Donya::Vector2 &texCoord );
+		Donya::Vector2		DecodeTexCoord( const HalfTexCoord &texCoord );
+
+		/// <summary>
+		/// The quantized attributes of a mesh. Only the arrays of chosen encoding are not empty.
+		/// </summary>
+		struct QuantizedAttributes
+		{
+			Report								report;
+			PositionFrame						positionFrame;
+			std::vector<QuantizedPosition>		positions;
+			std::vector<OctahedralNormal8>		normals8;
+			std::vector<OctahedralNormal16>		normals16;
+			std::vector<HalfTexCoord>			texCoords;
+		};
+
+		/// <summary>
+		/// Encodes each attribute by the most compact encoding that keeps the error within the tolerance.<para></para>
+		/// The errors are measured by decoding, not estimated.
+		/// </summary>
+		QuantizedAttributes Quantize( const ArrayView<Donya::Vector3> &positions, const ArrayView<Donya::Vector3> &normals, const ArrayView<Donya::Vector2> &texCoords, const Tolerance &tolerance );
+
+		std::vector<Donya::Vector3> DecodePositions( const ArrayView<QuantizedPosition> &positions, const PositionFrame &frame );
+		std::vector<Donya::Vector3> DecodeNormals( const ArrayView<OctahedralNormal8> &normals );
+		std::vector<Donya::Vector3> DecodeNormals( const ArrayView<OctahedralNormal16> &normals );
+		std::vector<Donya::Vector2> DecodeTexCoords( const ArrayView<HalfTexCoord> &texCoords );
+	}
+}
@@ -2,6 +2,7 @@
 
 #include <array>
 #include <algorithm>
+#include <cfloat>
 #include <thread>
 
 #include "Benchmark.h"
@@ -22,6 +23,9 @@ extern LRESULT ImGui_ImplWin32_WndProcHandler( HWND hWnd, UINT msg, WPARAM wpara
 
 #endif // USE_IMGUI
 
+#undef min
+#undef max
+
 using namespace DirectX;
 
 static constexpr char *ImGuiWindowName = "File Information";
@@ -31,17 +35,26 @@ Framework::Framework( HWND hwnd ) :
 	camera(),
 	light(),
 	meshes(),
+	cullingStatistics(),
+	isEnableCulling( true ),
+	pickResult(),
+	isEnablePicking( true ),
 	pressMouseButton( NULL ),
 	isCaptureWindow( false ),
 	isSolidState( true ),
-	// mutex(),
-	pLoadThread( nullptr ),
-	pCurrentLoading( nullptr ),
-	currentLoadingFileNameUTF8(),
-	reservedAbsFilePaths(),
-	reservedFileNamesUTF8()
+	loadWorkers(),
+	loadMutex(),
+	loadCondition(),
+	reservedLoads(),
+	runningLoads(),
+	canceledLoadIDs(),
+	finishedLoads(),
+	nextLoadID( 0 ),
+	isStoppingLoad( false )
 {
 	DragAcceptFiles( hWnd, TRUE );
+
+	StartLoadWorkers();
 }
 Framework::~Framework()
 {
@@ -50,13 +63,10 @@ Framework::~Framework()
 		ReleaseMouseCapture();
 	}
 
+	StopLoadWorkers();
+
 	meshes.clear();
 	meshes.shrink_to_fit();
-
-	if ( pLoadThread && pLoadThread->joinable() )
-	{
-		pLoadThread->join();
-	}
 };
 
 LRESULT CALLBACK Framework::HandleMessage( HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam )
@@ -519,13 +529,16 @@ void Framework::Update( float elapsedTime/*Elapsed seconds from last frame*/ )
 
 	AppendModelIfLoadFinished();
 
-	StartLoadIfVacant();
-
 	ShowNowLoadingModels();
 
 	Donya::Vector3 origin{ 0.0f, 0.0f, 0.0f };
 	camera.Update( origin );
 
+	if ( isEnablePicking )
+	{
+		PickModelByMouse();
+	}
+
 #if USE_IMGUI && DEBUG_MODE
 
 	if ( ImGui::BeginIfAllowed() )
@@ -547,6 +560,12 @@ void Framework::Update( float elapsedTime/*Elapsed seconds from last frame*/ )
 		ShowModelInfo();
 		ImGui::Text( "" );
 
+		ShowCullingInfo();
+		ImGui::Text( "" );
+
+		ShowPickingInfo();
+		ImGui::Text( "" );
+
 		ImGui::End();
 	}
 
@@ -582,49 +601,12 @@ void Framework::Render( float elapsedTime/*Elapsed seconds from last frame*/ )
 	);
 	*/
 	
-	XMMATRIX W{};
-	{
-		static float scale	= 0.1f; // 0.1f;
-		static float angleX	= 0.0f; // -10.0f;
-		static float angleY	= 0.0f; // -160.0f;
-		static float angleZ	= 0.0f; // 0;
-		static float moveX	= 0.0f; // 2.0f;
-		static float moveY	= 0.0f; // -2.0f;
-		static float moveZ	= 0.0f; // 0;
-
-		if ( 0 )
-		{
-			constexpr float SCALE_ADD = 0.0012f;
-			constexpr float ANGLE_ADD = 0.12f;
-			constexpr float MOVE_ADD  = 0.04f;
-
-			if ( Donya::Keyboard::Press( 'W'		) ) { scale  += SCALE_ADD; }
-			if ( Donya::Keyboard::Press( 'S'		) ) { scale  -= SCALE_ADD; }
-			if ( Donya::Keyboard::Press( VK_UP		) ) { angleX += ANGLE_ADD; }
-			if ( Donya::Keyboard::Press( VK_DOWN	) ) { angleX -= ANGLE_ADD; }
-			if ( Donya::Keyboard::Press( VK_LEFT	) ) { angleY += ANGLE_ADD; }
-			if ( Donya::Keyboard::Press( VK_RIGHT	) ) { angleY -= ANGLE_ADD; }
-			if ( Donya::Keyboard::Press( 'A'		) ) { angleZ += ANGLE_ADD; }
-			if ( Donya::Keyboard::Press( 'D'		) ) { angleZ -= ANGLE_ADD; }
-			if ( Donya::Keyboard::Press( 'I'		) ) { moveY  += MOVE_ADD;  }
-			if ( Donya::Keyboard::Press( 'K'		) ) { moveY  -= MOVE_ADD;  }
-			if ( Donya::Keyboard::Press( 'L'		) ) { moveX  += MOVE_ADD;  }
-			if ( Donya::Keyboard::Press( 'J'		) ) { moveX  -= MOVE_ADD;  }
-		}
-
-		XMMATRIX S	= XMMatrixScaling( scale, scale, scale );
-		XMMATRIX RX	= XMMatrixRotationX( ToRadian( angleX ) );
-		XMMATRIX RY	= XMMatrixRotationY( ToRadian( angleY ) );
-		XMMATRIX RZ	= XMMatrixRotationZ( ToRadian( angleZ ) );
-		XMMATRIX R	= ( RZ * RY ) * RX;
-		XMMATRIX T	= XMMatrixTranslation( moveX, moveY, moveZ );
-
-		W = S * R * T;
-	}
+	XMMATRIX W = CalcWorldMatrix();
 
 	XMMATRIX V = camera.CalcViewMatrix();
 
 	XMFLOAT4X4 worldViewProjection{};
+	XMFLOAT4X4 viewProjection{};
 	{
 		XMMATRIX projPerspective = camera.GetProjectionMatrix();
 
@@ -633,8 +615,16 @@ void Framework::Render( float elapsedTime/*Elapsed seconds from last frame*/ )
 			&worldViewProjection,
 			DirectX::XMMatrixMultiply( W, DirectX::XMMatrixMultiply( V, projPerspective ) )
 		);
+		XMStoreFloat4x4
+		(
+			&viewProjection,
+			DirectX::XMMatrixMultiply( V, projPerspective )
+		);
 	}
 
+	// The planes are in world space, each model culls the meshes and subsets by those.
+	const Donya::Frustum frustum = Donya::Frustum::FromMatrix( viewProjection );
+
 	XMFLOAT4X4 world{};
 	XMStoreFloat4x4( &world, W );
 
@@ -647,9 +637,16 @@ void Framework::Render( float elapsedTime/*Elapsed seconds from last frame*/ )
 		cameraPos.w = 1.0f;
 	}
 
+	cullingStatistics = Donya::SkinnedMesh::CullingStatistics{};
 	for ( auto &it : meshes )
 	{
-		it.mesh.Render( worldViewProjection, world, cameraPos, light.color, light.direction, isSolidState );
+		it.mesh.Render( worldViewProjection, world, cameraPos, light.color, light.direction, isSolidState, ( isEnableCulling ) ? &frustum : nullptr );
+
+		const auto &stats = it.mesh.GetCullingStatistics();
+		cullingStatistics.drawnMeshes	+= stats.drawnMeshes;
+		cullingStatistics.culledMeshes	+= stats.culledMeshes;
+		cullingStatistics.drawnSubsets	+= stats.drawnSubsets;
+		cullingStatistics.culledSubsets	+= stats.culledSubsets;
 	}
 
 #if USE_IMGUI
@@ -664,15 +661,60 @@ void Framework::Render( float elapsedTime/*Elapsed seconds from last frame*/ )
 	_ASSERT_EXPR( SUCCEEDED( hr ), L"Failed : Present()" );
 }
 
-void Framework::ReserveLoadFile( std::string filePath )
+XMMATRIX Framework::CalcWorldMatrix()
+{
+	XMMATRIX W{};
+	{
+		static float scale	= 0.1f; // 0.1f;
+		static float angleX	= 0.0f; // -10.0f;
+		static float angleY	= 0.0f; // -160.0f;
+		static float angleZ	= 0.0f; // 0;
+		static float moveX	= 0.0f; // 2.0f;
+		static float moveY	= 0.0f; // -2.0f;
+		static float moveZ	= 0.0f; // 0;
+
+		if ( 0 )
+		{
+			constexpr float SCALE_ADD = 0.0012f;
+			constexpr float ANGLE_ADD = 0.12f;
+			constexpr float MOVE_ADD  = 0.04f;
+
+			if ( Donya::Keyboard::Press( 'W'		) ) { scale  += SCALE_ADD; }
+			if ( Donya::Keyboard::Press( 'S'		) ) { scale  -= SCALE_ADD; }
+			if ( Donya::Keyboard::Press( VK_UP		) ) { angleX += ANGLE_ADD; }
+			if ( Donya::Keyboard::Press( VK_DOWN	) ) { angleX -= ANGLE_ADD; }
+			if ( Donya::Keyboard::Press( VK_LEFT	) ) { angleY += ANGLE_ADD; }
+			if ( Donya::Keyboard::Press( VK_RIGHT	) ) { angleY -= ANGLE_ADD; }
+			if ( Donya::Keyboard::Press( 'A'		) ) { angleZ += ANGLE_ADD; }
+			if ( Donya::Keyboard::Press( 'D'		) ) { angleZ -= ANGLE_ADD; }
+			if ( Donya::Keyboard::Press( 'I'		) ) { moveY  += MOVE_ADD;  }
+			if ( Donya::Keyboard::Press( 'K'		) ) { moveY  -= MOVE_ADD;  }
+			if ( Donya::Keyboard::Press( 'L'		) ) { moveX  += MOVE_ADD;  }
+			if ( Donya::Keyboard::Press( 'J'		) ) { moveX  -= MOVE_ADD;  }
+		}
+
+		XMMATRIX S	= XMMatrixScaling( scale, scale, scale );
+		XMMATRIX RX	= XMMatrixRotationX( ToRadian( angleX ) );
+		XMMATRIX RY	= XMMatrixRotationY( ToRadian( angleY ) );
+		XMMATRIX RZ	= XMMatrixRotationZ( ToRadian( angleZ ) );
+		XMMATRIX R	= ( RZ * RY ) * RX;
+		XMMATRIX T	= XMMatrixTranslation( moveX, moveY, moveZ );
+
+		W = S * R * T;
+	}
+
+	return W;
+}
+
+void Framework::ReserveLoadFile( std::string filePath, int priority )
 {
 	auto CanLoadFile = []( std::string filePath )->bool
 	{
-		constexpr std::array<const char *, 5> EXTENSIONS
+		constexpr std::array<const char *, 6> EXTENSIONS
 		{
 			".obj", ".OBJ",
 			".fbx", ".FBX",
-			".bin"
+			".bin", ".nmesh"
 		};
 
 		for ( size_t i = 0; i < EXTENSIONS.size(); ++i )
@@ -686,118 +728,285 @@ void Framework::ReserveLoadFile( std::string filePath )
 		return false;
 	};
 
-	if ( CanLoadFile( filePath ) )
+	if ( !CanLoadFile( filePath ) ) { return; }
+	// else
+
+	LoadTask task{};
+	task.priority		= priority;
+	task.absFilePath	= filePath;
+
+	const std::string fileName = Donya::ExtractFileNameFromFullPath( filePath );
+	if ( !fileName.empty() )
 	{
-		reservedAbsFilePaths.push( filePath );
+		task.fileNameUTF8 = Donya::MultiToUTF8( fileName );
+	}
+	else
+	{
+		task.fileNameUTF8 = Donya::MultiToUTF8( filePath );
+	}
 
-		const std::string fileName = Donya::ExtractFileNameFromFullPath( filePath );
-		if ( !fileName.empty() )
-		{
-			reservedFileNamesUTF8.push( Donya::MultiToUTF8( fileName ) );
-		}
-		else
+	{
+		std::lock_guard<std::mutex> lock( loadMutex );
+		task.id = nextLoadID++;
+		reservedLoads.emplace_back( std::move( task ) );
+	}
+	loadCondition.notify_one();
+}
+
+bool Framework::IsLoadedEarlier( const LoadTask &L, const LoadTask &R )
+{
+	if ( L.priority != R.priority ) { return R.priority < L.priority; }
+	// else
+	return L.id < R.id;
+}
+
+void Framework::CancelLoad( size_t taskID )
+{
+	std::lock_guard<std::mutex> lock( loadMutex );
+
+	auto IsTarget = [&taskID]( const LoadTask &task )
+	{
+		return task.id == taskID;
+	};
+
+	auto reserved = std::find_if( reservedLoads.begin(), reservedLoads.end(), IsTarget );
+	if ( reserved != reservedLoads.end() )
+	{
+		reservedLoads.erase( reserved );
+		return;
+	}
+	// else
+
+	// The running task can not be interrupted, so the worker discards the result when finished.
+	if ( std::any_of( runningLoads.begin(), runningLoads.end(), IsTarget ) )
+	{
+		canceledLoadIDs.insert( taskID );
+	}
+}
+
+void Framework::PrioritizeLoad( size_t taskID )
+{
+	std::lock_guard<std::mutex> lock( loadMutex );
+
+	auto target = std::find_if
+	(
+		reservedLoads.begin(), reservedLoads.end(),
+		[&taskID]( const LoadTask &task )
 		{
-			reservedFileNamesUTF8.push( Donya::MultiToUTF8( filePath ) );
+			return task.id == taskID;
 		}
+	);
+	if ( target == reservedLoads.end() ) { return; }
+	// else
+
+	int highest = target->priority;
+	for ( const auto &it : reservedLoads )
+	{
+		if ( highest < it.priority ) { highest = it.priority; }
 	}
+
+	target->priority = highest + 1;
 }
 
-void Framework::StartLoadIfVacant()
+void Framework::StartLoadWorkers()
 {
-	if ( pCurrentLoading )		{ return; }
-	if ( reservedAbsFilePaths.empty() )	{ return; }
+	if ( !loadWorkers.empty() ) { return; }
 	// else
 
-	auto Load = []( std::string filePath, AsyncLoad *pElement )
+	// Leave a core for the main thread. The importing uses much memory, so too many workers are not effective.
+	constexpr unsigned int MAX_WORKER_COUNT = 4U;
+	const unsigned int hardwareCount = std::thread::hardware_concurrency();
+	unsigned int workerCount = ( 1U < hardwareCount ) ? hardwareCount - 1U : 1U;
+	if ( MAX_WORKER_COUNT < workerCount ) { workerCount = MAX_WORKER_COUNT; }
+
 	{
-		if ( !pElement ) { return; }
-		// else
+		std::lock_guard<std::mutex> lock( loadMutex );
+		isStoppingLoad = false;
+	}
 
-		HRESULT hr = CoInitializeEx( NULL, COINIT_MULTITHREADED | COINIT_DISABLE_OLE1DDE );
+	loadWorkers.reserve( workerCount );
+	for ( unsigned int i = 0; i < workerCount; ++i )
+	{
+		loadWorkers.emplace_back( &Framework::LoadWorker, this );
+	}
+}
 
-		if ( FAILED( hr ) )
-		{
-			std::lock_guard<std::mutex> lock( pElement->flagMutex );
+void Framework::StopLoadWorkers()
+{
+	{
+		std::lock_guard<std::mutex> lock( loadMutex );
+		isStoppingLoad = true;
+	}
+	loadCondition.notify_all();
 
-			pElement->isFinished  = true;
-			pElement->isSucceeded = false;
-			return;
+	// The workers finish the running task, then exit. The reserved tasks are not loaded.
+	for ( auto &it : loadWorkers )
+	{
+		if ( it.joinable() )
+		{
+			it.join();
 		}
+	}
+	loadWorkers.clear();
 
-		bool createResult = false; // Will be change by below process, if load succeeded.
+	std::lock_guard<std::mutex> lock( loadMutex );
+	reservedLoads.clear();
+	runningLoads.clear();
+	canceledLoadIDs.clear();
+	finishedLoads = std::queue<FinishedLoad>{};
+}
+
+void Framework::LoadWorker()
+{
+	// The COM is initialized once per worker, not per task.
+	const HRESULT hr = CoInitializeEx( NULL, COINIT_MULTITHREADED | COINIT_DISABLE_OLE1DDE );
 
-		// Load model, using lock_guard by pLoadMutex.
+	auto IsCanceled = [&]( size_t taskID )
+	{
+		std::lock_guard<std::mutex> lock( loadMutex );
+		return ( canceledLoadIDs.find( taskID ) != canceledLoadIDs.end() );
+	};
+
+	while ( true )
+	{
+		LoadTask task{};
 		{
-			Donya::Loader tmpHeavyLoad{}; // For reduce time of lock.
-			bool loadResult = tmpHeavyLoad.Load( filePath, nullptr );
+			std::unique_lock<std::mutex> lock( loadMutex );
+			loadCondition.wait
+			(
+				lock,
+				[&]()
+				{
+					return isStoppingLoad || !reservedLoads.empty();
+				}
+			);
 
-			std::lock_guard<std::mutex> lock( pElement->meshMutex );
+			if ( isStoppingLoad ) { break; }
+			// else
 
-			// bool loadResult  = pElement->meshInfo.loader.Load( fullPath, nullptr );
-			pElement->meshInfo.loader = tmpHeavyLoad; // Takes only assignment-time.
-			if ( loadResult )
-			{
-				createResult = Donya::SkinnedMesh::Create
-				(
-					&pElement->meshInfo.loader,
-					&pElement->meshInfo.mesh
-				);
+			auto next = std::min_element( reservedLoads.begin(), reservedLoads.end(), IsLoadedEarlier );
+			task = std::move( *next );
+			reservedLoads.erase( next );
 
-			}
+			runningLoads.emplace_back( task );
 		}
 
-		std::lock_guard<std::mutex> lock( pElement->flagMutex );
+		FinishedLoad result{};
+		result.id			= task.id;
+		result.pMeshInfo	= std::make_unique<MeshAndInfo>();
+		result.isSucceeded	= SUCCEEDED( hr ) && result.pMeshInfo->loader.Load( task.absFilePath, nullptr );
 
-		pElement->isFinished  = true;
-		pElement->isSucceeded = createResult;
+		// The importing can not be interrupted, but the creation of resources can be skipped.
+		if ( result.isSucceeded && !IsCanceled( task.id ) )
+		{
+			result.isSucceeded = Donya::SkinnedMesh::Create
+			(
+				&result.pMeshInfo->loader,
+				&result.pMeshInfo->mesh
+			);
+		}
+		if ( result.isSucceeded && !IsCanceled( task.id ) )
+		{
+			BuildTriangleBVHs( result.pMeshInfo->loader, &result.pMeshInfo->bvhs );
+		}
 
-		CoUninitialize();
-	};
+		std::lock_guard<std::mutex> lock( loadMutex );
 
-	const std::string loadFilePath = reservedAbsFilePaths.front();
-	reservedAbsFilePaths.pop();
-	reservedFileNamesUTF8.pop();
+		runningLoads.erase
+		(
+			std::remove_if
+			(
+				runningLoads.begin(), runningLoads.end(),
+				[&task]( const LoadTask &running )
+				{
+					return running.id == task.id;
+				}
+			),
+			runningLoads.end()
+		);
 
-	currentLoadingFileNameUTF8 = Donya::ExtractFileNameFromFullPath( loadFilePath );
+		const bool wasCanceled = ( canceledLoadIDs.erase( task.id ) != 0 );
+		if ( !wasCanceled )
+		{
+			finishedLoads.push( std::move( result ) );
+		}
+	}
 
-	pCurrentLoading = std::make_unique<AsyncLoad>();
-	pLoadThread = std::make_unique<std::thread>( Load, loadFilePath, pCurrentLoading.get() );
+	if ( SUCCEEDED( hr ) )
+	{
+		CoUninitialize();
+	}
 }
 
-void Framework::AppendModelIfLoadFinished()
+void Framework::BuildTriangleBVHs( const Donya::Loader &loader, std::vector<Donya::TriangleBVH> *pOutput )
 {
-	if ( !pCurrentLoading ) { return; }
-	// else
+	const std::vector<Donya::Loader::Mesh> &loadedMeshes = *loader.GetMeshes();
 
+	pOutput->clear();
+	pOutput->resize( loadedMeshes.size() );
+	for ( size_t i = 0; i < loadedMeshes.size(); ++i )
 	{
-		std::lock_guard<std::mutex> flagLock( pCurrentLoading->flagMutex );
-
-		if ( !pCurrentLoading->isFinished ) { return; }
-		// else
-
-		if ( pLoadThread && pLoadThread->joinable() )
+		// The indices of LOD levels are stored after the subsets, so only the range of subsets is used.
+		size_t indexCount = 0;
+		for ( const auto &subset : loadedMeshes[i].subsets )
 		{
-			pLoadThread->join();
+			indexCount = std::max( indexCount, subset.indexStart + subset.indexCount );
 		}
 
-		if ( pCurrentLoading->isSucceeded )
+		const Donya::Loader::MeshView view = loader.GetMeshView( i );
+		if ( view.IsIndex16() )
 		{
-			std::lock_guard<std::mutex> meshLock( pCurrentLoading->meshMutex );
-
-			meshes.emplace_back( pCurrentLoading->meshInfo );
+			pOutput->at( i ).Build( view.positions, Donya::ArrayView<std::uint16_t>{ view.indices16.data(), std::min( indexCount, view.indices16.size() ) } );
+		}
+		else
+		{
+			pOutput->at( i ).Build( view.positions, Donya::ArrayView<std::uint32_t>{ view.indices.data(), std::min( indexCount, view.indices.size() ) } );
 		}
 	}
+}
 
-	pCurrentLoading.reset( nullptr );
+void Framework::AppendModelIfLoadFinished()
+{
+	std::queue<FinishedLoad> finished{};
+	{
+		std::lock_guard<std::mutex> lock( loadMutex );
+		if ( finishedLoads.empty() ) { return; }
+		// else
+
+		finished.swap( finishedLoads );
+	}
+
+	while ( !finished.empty() )
+	{
+		FinishedLoad &result = finished.front();
+		if ( result.isSucceeded && result.pMeshInfo )
+		{
+			meshes.emplace_back( std::move( *result.pMeshInfo ) );
+		}
+
+		finished.pop();
+	}
 }
 
 void Framework::ShowNowLoadingModels()
 {
 #if USE_IMGUI
 
-	if ( !pCurrentLoading ) { return; }
+	std::vector<LoadTask>		running{};
+	std::vector<LoadTask>		reserved{};
+	std::unordered_set<size_t>	canceled{};
+	{
+		std::lock_guard<std::mutex> lock( loadMutex );
+		running		= runningLoads;
+		reserved	= reservedLoads;
+		canceled	= canceledLoadIDs;
+	}
+
+	if ( running.empty() && reserved.empty() ) { return; }
 	// else
 
+	std::sort( reserved.begin(), reserved.end(), IsLoadedEarlier );
+
 	const Donya::Vector2 WINDOW_POS{ Common::HalfScreenWidthF(), Common::HalfScreenHeightF() };
 	const Donya::Vector2 WINDOW_SIZE{ 360.0f, 180.0f };
 	auto Convert = []( const Donya::Vector2 &vec )
@@ -808,20 +1017,43 @@ void Framework::ShowNowLoadingModels()
 	ImGui::SetNextWindowPos( Convert( WINDOW_POS ), ImGuiCond_Once );
 	ImGui::SetNextWindowSize( Convert( WINDOW_SIZE ), ImGuiCond_Once );
 
+	std::vector<size_t> cancelIDs{};
+	std::vector<size_t> prioritizeIDs{};
+
 	if ( ImGui::BeginIfAllowed( "Loading Files" ) )
 	{
-		std::queue<std::string> fileListUTF8 = reservedFileNamesUTF8;
-		ImGui::Text( "Reserving load file list : %d", fileListUTF8.size() + 1 );
+		ImGui::Text( "Loading : %d, Reserving : %d", scast<int>( running.size() ), scast<int>( reserved.size() ) );
 
 		ImGui::BeginChild( ImGui::GetID( scast<void *>( NULL ) ), ImVec2( 0, 0 ) );
 
-		std::string fileNameUTF8 = currentLoadingFileNameUTF8;
-		ImGui::Text( "Now:[%s]", fileNameUTF8.c_str() );
-		while ( !fileListUTF8.empty() )
+		for ( const auto &it : running )
 		{
-			fileNameUTF8 = fileListUTF8.front();
-			ImGui::Text( "[%s]", fileNameUTF8.c_str() );
-			fileListUTF8.pop();
+			ImGui::PushID( scast<int>( it.id ) );
+
+			if ( canceled.find( it.id ) != canceled.end() )
+			{
+				ImGui::Text( "Canceling:[%s]", it.fileNameUTF8.c_str() );
+			}
+			else
+			{
+				ImGui::Text( "Now:[%s]", it.fileNameUTF8.c_str() );
+				ImGui::SameLine();
+				if ( ImGui::Button( "Cancel" ) ) { cancelIDs.emplace_back( it.id ); }
+			}
+
+			ImGui::PopID();
+		}
+		for ( const auto &it : reserved )
+		{
+			ImGui::PushID( scast<int>( it.id ) );
+
+			ImGui::Text( "[%s]", it.fileNameUTF8.c_str() );
+			ImGui::SameLine();
+			if ( ImGui::Button( "Prior"  ) ) { prioritizeIDs.emplace_back( it.id ); }
+			ImGui::SameLine();
+			if ( ImGui::Button( "Cancel" ) ) { cancelIDs.emplace_back( it.id ); }
+
+			ImGui::PopID();
 		}
 
 		ImGui::EndChild();
@@ -829,6 +1061,15 @@ void Framework::ShowNowLoadingModels()
 		ImGui::End();
 	}
 
+	for ( const auto &it : prioritizeIDs )
+	{
+		PrioritizeLoad( it );
+	}
+	for ( const auto &it : cancelIDs )
+	{
+		CancelLoad( it );
+	}
+
 #endif // USE_IMGUI
 }
 
@@ -877,6 +1118,7 @@ std::string GetSaveFileNameByCommonDialog( const HWND &hWnd )
 	ofn.lStructSize		= sizeof( OPENFILENAME );
 	ofn.hwndOwner		= hWnd;
 	ofn.lpstrFilter		= "Binary-file(*.bin)\0*.bin\0"
+						  "Native-mesh-file(*.nmesh)\0*.nmesh\0"
 						  "\0";
 	ofn.lpstrFile		= fileNameBuffer;
 	ofn.nMaxFile		= MAX_PATH;
@@ -966,6 +1208,78 @@ void Framework::PutLimitMouseMoveArea()
 	}
 }
 
+void Framework::PickModelByMouse()
+{
+	Benchmark benchmark{};
+
+	pickResult = PickResult{};
+
+	int mouseX{}, mouseY{};
+	Donya::Mouse::GetMouseCoord( &mouseX, &mouseY );
+
+	Donya::Vector3 rayOrigin{};
+	Donya::Vector3 rayDirection{};
+	if ( !camera.CalcRayFromScreen( Donya::Vector2{ scast<float>( mouseX ), scast<float>( mouseY ) }, &rayOrigin, &rayDirection ) ) { return; }
+	// else
+
+	XMFLOAT4X4 world{};
+	XMStoreFloat4x4( &world, CalcWorldMatrix() );
+
+	// The "t" of a ray is kept by the affine transformation, so the hits in the space of each mesh are comparable by it.
+	// The direction is normalized, so the "t" is also the distance in world space.
+	float closestDistance = FLT_MAX;
+	for ( size_t modelIndex = 0; modelIndex < meshes.size(); ++modelIndex )
+	{
+		const MeshAndInfo &model = meshes[modelIndex];
+		const size_t meshCount = std::min( model.bvhs.size(), model.mesh.GetMeshCount() );
+		for ( size_t meshIndex = 0; meshIndex < meshCount; ++meshIndex )
+		{
+			const Donya::TriangleBVH &bvh = model.bvhs[meshIndex];
+			if ( bvh.IsEmpty() ) { continue; }
+			// else
+
+			const XMFLOAT4X4 meshToWorld = model.mesh.CalcMeshToWorld( meshIndex, world );
+
+			XMVECTOR determinant{};
+			const XMMATRIX worldToMesh = XMMatrixInverse( &determinant, XMLoadFloat4x4( &meshToWorld ) );
+			if ( ZeroEqual( XMVectorGetX( determinant ) ) ) { continue; }
+			// else
+
+			Donya::TriangleBVH::Ray localRay{};
+			XMStoreFloat3( &localRay.origin,	XMVector3TransformCoord( XMLoadFloat3( &rayOrigin ), worldToMesh ) );
+			XMStoreFloat3( &localRay.direction,	XMVector3TransformNormal( XMLoadFloat3( &rayDirection ), worldToMesh ) );
+
+			Donya::TriangleBVH::Hit hit{};
+			if ( !bvh.Intersect( localRay, closestDistance, &hit ) ) { continue; }
+			// else
+
+			closestDistance = hit.distance;
+
+			pickResult.isHit		= true;
+			pickResult.modelIndex	= modelIndex;
+			pickResult.meshIndex	= meshIndex;
+			pickResult.subsetIndex	= 0;
+			pickResult.triangle		= hit.triangle;
+			pickResult.u			= hit.u;
+			pickResult.v			= hit.v;
+			pickResult.distance		= hit.distance;
+
+			const auto &subsets = model.loader.GetMeshes()->at( meshIndex ).subsets;
+			const size_t firstIndex = scast<size_t>( hit.triangle ) * 3;
+			for ( size_t i = 0; i < subsets.size(); ++i )
+			{
+				if ( subsets[i].indexStart <= firstIndex && firstIndex < subsets[i].indexStart + subsets[i].indexCount )
+				{
+					pickResult.subsetIndex = i;
+					break;
+				}
+			}
+		}
+	}
+
+	pickResult.elapsedMicroseconds = benchmark.EndF() * 1000000.0f;
+}
+
 void Framework::ShowMouseInfo()
 {
 #if USE_IMGUI && DEBUG_MODE
@@ -1023,6 +1337,25 @@ void Framework::ShowModelInfo()
 						it->loader.SaveByCereal( saveName );
 					}
 				}
+				ImGui::SameLine();
+				if ( ImGui::Button( "Save Native" ) )
+				{
+					std::string saveName = GetSaveFileNameByCommonDialog( hWnd );
+					// The empty name means the dialog was canceled.
+					if ( !saveName.empty() )
+					{
+						if ( saveName.find( ".nmesh" ) == std::string::npos )
+						{
+							saveName += ".nmesh";
+						}
+
+						std::string errorMessage{};
+						if ( !it->loader.SaveByNative( saveName, &errorMessage ) )
+						{
+							MessageBoxA( hWnd, errorMessage.c_str(), "File Save Failed", MB_OK );
+						}
+					}
+				}
 
 				it->loader.EnumPreservingDataToImGui( ImGuiWindowName );
 				ImGui::TreePop();
@@ -1034,6 +1367,46 @@ void Framework::ShowModelInfo()
 		ImGui::End();
 	}
 
+#endif // USE_IMGUI && DEBUG_MODE
+}
+void Framework::ShowCullingInfo()
+{
+#if USE_IMGUI && DEBUG_MODE
+
+	if ( ImGui::BeginIfAllowed() )
+	{
+		ImGui::Checkbox( "Enable Frustum Culling", &isEnableCulling );
+		ImGui::Text( "Meshes:[Drawn:%d][Culled:%d]",	scast<int>( cullingStatistics.drawnMeshes ),	scast<int>( cullingStatistics.culledMeshes )	);
+		ImGui::Text( "Subsets:[Drawn:%d][Culled:%d]",	scast<int>( cullingStatistics.drawnSubsets ),	scast<int>( cullingStatistics.culledSubsets )	);
+
+		ImGui::End();
+	}
+
+#endif // USE_IMGUI && DEBUG_MODE
+}
+void Framework::ShowPickingInfo()
+{
+#if USE_IMGUI && DEBUG_MODE
+
+	if ( ImGui::BeginIfAllowed() )
+	{
+		ImGui::Checkbox( "Enable Mouse Picking", &isEnablePicking );
+		if ( pickResult.isHit && pickResult.modelIndex < meshes.size() )
+		{
+			ImGui::Text( "Model:[%s]", meshes[pickResult.modelIndex].loader.GetOnlyFileName().c_str() );
+			ImGui::Text( "Mesh:[%d][Subset:%d][Triangle:%d]", scast<int>( pickResult.meshIndex ), scast<int>( pickResult.subsetIndex ), scast<int>( pickResult.triangle ) );
+			ImGui::Text( "Barycentric:[U:%5.3f][V:%5.3f]", pickResult.u, pickResult.v );
+			ImGui::Text( "Distance:[%f]", pickResult.distance );
+		}
+		else
+		{
+			ImGui::Text( "Model:[None]" );
+		}
+		ImGui::Text( "Query:[%5.2f us]", pickResult.elapsedMicroseconds );
+
+		ImGui::End();
+	}
+
 #endif // USE_IMGUI && DEBUG_MODE
 }
 void Framework::ChangeLightByImGui()
@@ -10,15 +10,18 @@
 #include <vector>
 #include <wrl.h>
 
+#include <condition_variable>
 #include <mutex>
 #include <list>
 #include <thread>
 #include <queue>
+#include <unordered_set>
 
 #include "Camera.h"
 #include "Loader.h"
 #include "HighResolutionTimer.h"
 #include "SkinnedMesh.h"
+#include "TriangleBVH.h"
 #include "Vector.h"
 
 #define scast static_cast
@@ -41,35 +44,62 @@ private:
 		Donya::Vector4 direction{ 0.0f, 6.0f, 0.0f, 0.0f };
 	};
 	Light light;
-	struct MeshAndInfo
+	struct MeshAndInfo // It can only move.
 	{
-		Donya::Loader		loader;
-		Donya::SkinnedMesh	mesh;
+		Donya::Loader					loader;
+		Donya::SkinnedMesh				mesh;
+		std::vector<Donya::TriangleBVH>	bvhs;	// Per mesh, of the full resolution triangles. For the ray picking.
 	};
 	std::vector<MeshAndInfo> meshes;
+	Donya::SkinnedMesh::CullingStatistics cullingStatistics; // The sum of all models at the last Render().
+	bool isEnableCulling;
+	struct PickResult
+	{
+		bool			isHit{};
+		size_t			modelIndex{};
+		size_t			meshIndex{};
+		size_t			subsetIndex{};
+		std::uint32_t	triangle{};		// The position in the indices of mesh is "triangle * 3".
+		float			u{};			// The barycentric coordinates of the hit position.
+		float			v{};
+		float			distance{};		// In world space, from the near plane.
+		float			elapsedMicroseconds{};
+	};
+	PickResult pickResult; // The model under the mouse cursor, updated in Update().
+	bool isEnablePicking;
 private:
 	int pressMouseButton; // contain value is: None:0, Left:VK_LBUTTON, Middle:VK_MBUTTON, Right:VK_RBUTTON.
 	bool isCaptureWindow;
 	bool isSolidState;
 private:
-	std::unique_ptr<std::thread> pLoadThread{};
-	struct AsyncLoad
+	struct LoadTask
 	{
-		std::mutex	meshMutex{};
-		std::mutex	flagMutex{};
-		MeshAndInfo	meshInfo{};
-		bool		isFinished{};	// Is finished the loading process ?
-		bool		isSucceeded{};	// Is Succeeded the loading process ?
-	public:
-		AsyncLoad() : meshMutex(), flagMutex(),
-			meshInfo(),
-			isFinished( false ), isSucceeded( false )
-		{}
+		size_t		id{};			// Unique, and increases in reserved order.
+		int			priority{};		// The bigger is loaded earlier.
+		std::string	absFilePath{};
+		std::string	fileNameUTF8{};	// For UI.
 	};
-	std::unique_ptr<AsyncLoad>	pCurrentLoading;
-	std::string					currentLoadingFileNameUTF8;	// For UI.
-	std::queue<std::string>		reservedAbsFilePaths;
-	std::queue<std::string>		reservedFileNamesUTF8;		// For UI.
+	struct FinishedLoad
+	{
+		size_t							id{};
+		std::unique_ptr<MeshAndInfo>	pMeshInfo{};	// The result is passed to the main thread by move.
+		bool							isSucceeded{};
+	};
+	static bool IsLoadedEarlier( const LoadTask &L, const LoadTask &R );
+
+	/// <summary>
+	/// The workers take the task that has highest priority(then older) from reservedLoads, and push the result to finishedLoads.<para></para>
+	/// The members below the loadMutex are guarded by it.
+	/// </summary>
+	std::vector<std::thread>	loadWorkers;
+	std::mutex					loadMutex;
+	std::condition_variable		loadCondition;
+	std::vector<LoadTask>		reservedLoads;
+	std::vector<LoadTask>		runningLoads;		// For UI.
+	std::unordered_set<size_t>	canceledLoadIDs;	// The running tasks that are canceled. Their result will be discarded.
+	std::queue<FinishedLoad>	finishedLoads;		// The completion queue, consumed by the main thread.
+	size_t						nextLoadID;
+	bool						isStoppingLoad;
 public:
 	Framework( HWND hwnd );
 	~Framework();
@@ -84,12 +114,24 @@ private:
 	bool Init();
 	void Update( float elapsed_time/*Elapsed seconds from last frame*/ );
 	void Render( float elapsed_time/*Elapsed seconds from last frame*/ );
+	DirectX::XMMATRIX CalcWorldMatrix();
 private:
 	HighResolutionTimer highResoTimer;
 	void CalcFrameStats();
 private:
-	void ReserveLoadFile( std::string filePath );
-	void StartLoadIfVacant();
+	/// <summary>
+	/// The bigger priority is loaded earlier. The same priorities are loaded in reserved order.
+	/// </summary>
+	void ReserveLoadFile( std::string filePath, int priority = 0 );
+	/// <summary>
+	/// The reserved task is removed, the running task's result is discarded.
+	/// </summary>
+	void CancelLoad( size_t taskID );
+	void PrioritizeLoad( size_t taskID );
+	void StartLoadWorkers();
+	void StopLoadWorkers();
+	void LoadWorker();
+	static void BuildTriangleBVHs( const Donya::Loader &loader, std::vector<Donya::TriangleBVH> *pOutput );
 	void AppendModelIfLoadFinished();
 	void ShowNowLoadingModels();
 private:
@@ -97,9 +139,15 @@ private:
 	void SetMouseCapture();
 	void ReleaseMouseCapture();
 	void PutLimitMouseMoveArea();
+	/// <summary>
+	/// Finds the closest triangle of all models under the mouse cursor, then stores it to the pickResult.
+	/// </summary>
+	void PickModelByMouse();
 private:
 	void ShowMouseInfo();
 	void ShowModelInfo();
+	void ShowCullingInfo();
+	void ShowPickingInfo();
 	void ChangeLightByImGui();
 };
 
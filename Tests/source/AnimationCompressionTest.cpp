@@ -0,0 +1,192 @@
+#include "Test.h"
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "AnimationCompression.h"
+#include "Quaternion.h"
+
+namespace
+{
+	using namespace Donya::AnimationCompression;
+
+	Donya::Quaternion ToQuaternion( const Donya::Vector4 &rotation )
+	{
+		return Donya::Quaternion{ rotation.x, rotation.y, rotation.z, rotation.w };
+	}
+	/// <summary>
+	/// The same metric as the compression, from the chord length.
+	/// </summary>
+	float CalcAngleDegree( const Donya::Quaternion &L, const Donya::Quaternion &R )
+	{
+		const float sign = ( Donya::Quaternion::Dot( L, R ) < 0.0f ) ? -1.0f : 1.0f;
+		float halfChord = ( L - ( R * sign ) ).Length() * 0.5f;
+		if ( 1.0f < halfChord ) { halfChord = 1.0f; }
+		return ToDegree( 4.0f * asinf( halfChord ) );
+	}
+	void UpdateMax( float value, float *pMax )
+	{
+		if ( *pMax < value ) { *pMax = value; }
+	}
+
+	/// <summary>
+	/// The bones are swinging in the various speeds. Some channels are constant, and a translation moves too far for the UNORM16.
+	/// </summary>
+	Donya::Animation::Clip MakeClip( Test::Random &random )
+	{
+		constexpr int BONE_COUNT	= 20;
+		constexpr int FRAME_COUNT	= 301;
+
+		Donya::Animation::Clip clip{};
+		clip.name			= "Swing";
+		clip.samplingRate	= 30.0f;
+		clip.duration		= scast<float>( FRAME_COUNT - 1 ) / clip.samplingRate;
+		clip.tracks.resize( BONE_COUNT );
+		for ( int b = 0; b < BONE_COUNT; ++b )
+		{
+			Donya::Vector3 axis{ random.Range( -1.0f, 1.0f ), random.Range( -1.0f, 1.0f ), random.Range( -1.0f, 1.0f ) };
+			axis.Normalize();
+			const float speed = random.Range( -3.0f, 3.0f );
+			const float phase = random.Range( -1.0f, 1.0f );
+
+			auto &track = clip.tracks[b];
+			for ( int f = 0; f < FRAME_COUNT; ++f )
+			{
+				const float seconds = scast<float>( f ) / clip.samplingRate;
+
+				// The angle is in ( -PI, PI ), so the neighbors are in the same hemisphere.
+				const Donya::Quaternion rotation = Donya::Quaternion::Make( axis, 2.5f * sinf( speed * seconds + phase ) );
+				track.rotations.emplace_back( Donya::Vector4{ rotation.x, rotation.y, rotation.z, rotation.w } );
+
+				const float x = ( b == 3 ) ? 100.0f * seconds : 10.0f * sinf( speed * seconds );
+				const float y = ( b % 3 == 0 ) ? 5.0f : scast<float>( f ) * 0.01f;
+				track.translations.emplace_back( Donya::Vector3{ x, y, 0.0f } );
+
+				if ( b % 2 == 0 )
+				{
+					track.scales.emplace_back( Donya::Vector3{ 1.0f + 0.1f * sinf( scast<float>( f ) * 0.05f ), 1.0f, 1.0f } );
+				}
+			}
+			if ( b % 2 == 1 )
+			{
+				track.scales.emplace_back( Donya::Vector3{ 1.0f, 1.0f, 1.0f } );
+			}
+		}
+		return clip;
+	}
+}
+
+namespace Test
+{
+	bool AnimationCompressionRoundTrip()
+	{
+		Random random{ 5678U };
+		const Donya::Animation::Clip source = MakeClip( random );
+		if ( !CanCompress( source ) )
+		{
+			std::printf( "AnimationCompression: The test clip can not be compressed.\n" );
+			return false;
+		}
+		// else
+
+		const Tolerance		tolerance{};
+		const CompressedClip compressed = Compress( source, tolerance );
+		if ( !compressed.IsValid() )
+		{
+			std::printf( "AnimationCompression: The compressed clip is broken.\n" );
+			return false;
+		}
+		// else
+
+		const Report &report = compressed.report;
+		if ( report.sourceKeyCount <= report.keptKeyCount )
+		{
+			std::printf( "AnimationCompression: No key is dropped(%u keys).\n", report.sourceKeyCount );
+			return false;
+		}
+		// else
+
+		// The tolerance is also the bound of the decoding, so allow only the rounding of the measurement.
+		constexpr float SLACK = 1.001f;
+		auto IsInTolerance = [&]( float rotationError, float translationError, float scaleError )
+		{
+			return	rotationError		<= tolerance.rotation		* SLACK
+				&&	translationError	<= tolerance.translation	* SLACK
+				&&	scaleError			<= tolerance.scale			* SLACK;
+		};
+		if ( !IsInTolerance( report.rotationError, report.translationError, report.scaleError ) )
+		{
+			std::printf( "AnimationCompression: The report exceeds the tolerance(rotation %g, translation %g, scale %g).\n", report.rotationError, report.translationError, report.scaleError );
+			return false;
+		}
+		// else
+
+		const Donya::Animation::Clip decompressed = Decompress( compressed );
+		if ( decompressed.tracks.size() != source.tracks.size() )
+		{
+			std::printf( "AnimationCompression: The decompressed clip has %d tracks, the source has %d.\n", scast<int>( decompressed.tracks.size() ), scast<int>( source.tracks.size() ) );
+			return false;
+		}
+		// else
+
+		float rotationError		= 0.0f;
+		float translationError	= 0.0f;
+		float scaleError		= 0.0f;
+		for ( size_t b = 0; b < source.tracks.size(); ++b )
+		{
+			const auto &expected	= source.tracks[b];
+			const auto &actual		= decompressed.tracks[b];
+			if ( expected.rotations.size() != actual.rotations.size() || expected.translations.size() != actual.translations.size() || expected.scales.size() != actual.scales.size() )
+			{
+				std::printf( "AnimationCompression: The key counts of track[%d] are changed.\n", scast<int>( b ) );
+				return false;
+			}
+			// else
+
+			for ( size_t i = 0; i < expected.rotations.size(); ++i )
+			{
+				UpdateMax( CalcAngleDegree( ToQuaternion( expected.rotations[i] ), ToQuaternion( actual.rotations[i] ) ), &rotationError );
+			}
+			for ( size_t i = 0; i < expected.translations.size(); ++i )
+			{
+				UpdateMax( ( expected.translations[i] - actual.translations[i] ).Length(), &translationError );
+			}
+			for ( size_t i = 0; i < expected.scales.size(); ++i )
+			{
+				UpdateMax( ( expected.scales[i] - actual.scales[i] ).Length(), &scaleError );
+			}
+		}
+		if ( !IsInTolerance( rotationError, translationError, scaleError ) )
+		{
+			std::printf( "AnimationCompression: The decompressed keys exceed the tolerance(rotation %g, translation %g, scale %g).\n", rotationError, translationError, scaleError );
+			return false;
+		}
+		// else
+
+		// The runtime sampling must be same as the decompression at the frames.
+		std::vector<Donya::Animation::Transform> pose( compressed.tracks.size() );
+		float sampledError = 0.0f;
+		for ( std::uint32_t f = 0; f < compressed.frameCount; ++f )
+		{
+			const float seconds = scast<float>( f ) / compressed.samplingRate;
+			compressed.Sample( seconds, /* isLooping = */ false, pose.data() );
+			for ( size_t b = 0; b < pose.size(); ++b )
+			{
+				const auto &track = source.tracks[b];
+				UpdateMax( CalcAngleDegree( ToQuaternion( track.rotations[f] ), ToQuaternion( pose[b].rotation ) ) / tolerance.rotation, &sampledError );
+				UpdateMax( ( track.translations[f] - pose[b].translation ).Length() / tolerance.translation, &sampledError );
+				const Donya::Vector3 &scale = ( track.scales.size() == 1 ) ? track.scales.front() : track.scales[f];
+				UpdateMax( ( scale - pose[b].scale ).Length() / tolerance.scale, &sampledError );
+			}
+		}
+		if ( SLACK < sampledError )
+		{
+			std::printf( "AnimationCompression: The sampled pose exceeds the tolerance by %g times.\n", sampledError );
+			return false;
+		}
+		// else
+
+		return true;
+	}
+}
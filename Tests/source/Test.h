@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Common.h"
+
+/// <summary>
+/// The tests that do not need a window or a device. Each test prints the reason of failure to the standard output.
+/// </summary>
+namespace Test
+{
+	/// <summary>
+	/// The deterministic generator, the distributions of the standard library are not same between the compilers.
+	/// </summary>
+	class Random
+	{
+		std::uint32_t state;
+	public:
+		explicit Random( std::uint32_t seed ) : state( seed ? seed : 1U ) {}
+	public:
+		/// <summary>
+		/// Returns [min, max].
+		/// </summary>
+		float Range( float min, float max )
+		{
+			// Xorshift32.
+			state ^= state << 13;
+			state ^= state >> 17;
+			state ^= state << 5;
+			return min + ( max - min ) * ( scast<float>( state >> 8 ) / 16777215.0f );
+		}
+	};
+
+	/// <summary>
+	/// Compares the closest hits of TriangleBVH::Intersect() with the brute force over all triangles.
+	/// </summary>
+	bool TriangleBVHPicking();
+	/// <summary>
+	/// Compresses a clip, then checks the decompressed keys and the sampled poses are within the tolerance.
+	/// </summary>
+	bool AnimationCompressionRoundTrip();
+}
@@ -0,0 +1,31 @@
+#include <cstdio>
+
+#include "Test.h"
+
+/// <summary>
+/// Runs all tests, and returns non-zero if some test failed, so the build server can run it as it is.
+/// </summary>
+int main()
+{
+	struct Entry
+	{
+		const char	*name;
+		bool		( *pTest )();
+	};
+	const Entry tests[] =
+	{
+		{ "TriangleBVHPicking",				Test::TriangleBVHPicking			},
+		{ "AnimationCompressionRoundTrip",	Test::AnimationCompressionRoundTrip	},
+	};
+
+	int failedCount = 0;
+	for ( const auto &test : tests )
+	{
+		const bool isPassed = test.pTest();
+		std::printf( "[%s] %s\n", ( isPassed ) ? "PASS" : "FAIL", test.name );
+		if ( !isPassed ) { ++failedCount; }
+	}
+
+	std::printf( "%d / %d tests failed.\n", failedCount, scast<int>( ArraySize( tests ) ) );
+	return ( failedCount ) ? 1 : 0;
+}
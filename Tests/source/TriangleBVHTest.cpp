@@ -0,0 +1,157 @@
+#include "Test.h"
+
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "TriangleBVH.h"
+
+namespace
+{
+	/// <summary>
+	/// The same Moller-Trumbore as TriangleBVH::Intersect(), so the distances are expected to be equal.
+	/// </summary>
+	bool IntersectTriangle( const Donya::TriangleBVH::Ray &ray, const Donya::Vector3 &p0, const Donya::Vector3 &p1, const Donya::Vector3 &p2, float *pDistance )
+	{
+		const Donya::Vector3 edge1 = p1 - p0;
+		const Donya::Vector3 edge2 = p2 - p0;
+		const Donya::Vector3 pVec  = Donya::Vector3::Cross( ray.direction, edge2 );
+		const float determinant = Donya::Vector3::Dot( edge1, pVec );
+		if ( determinant == 0.0f ) { return false; }
+		// else
+
+		const float inverseDeterminant = 1.0f / determinant;
+		const Donya::Vector3 tVec = ray.origin - p0;
+		const float u = Donya::Vector3::Dot( tVec, pVec ) * inverseDeterminant;
+		if ( u < 0.0f || 1.0f < u ) { return false; }
+		// else
+
+		const Donya::Vector3 qVec = Donya::Vector3::Cross( tVec, edge1 );
+		const float v = Donya::Vector3::Dot( ray.direction, qVec ) * inverseDeterminant;
+		if ( v < 0.0f || 1.0f < u + v ) { return false; }
+		// else
+
+		const float distance = Donya::Vector3::Dot( edge2, qVec ) * inverseDeterminant;
+		if ( distance < 0.0f ) { return false; }
+		// else
+
+		*pDistance = distance;
+		return true;
+	}
+
+	bool IsNearlyEqual( float lhs, float rhs )
+	{
+		return std::fabs( lhs - rhs ) <= 1.0e-4f * ( 1.0f + std::fabs( rhs ) );
+	}
+
+	/// <summary>
+	/// Returns the count of rays that the result is different from the brute force.
+	/// </summary>
+	template<typename IndexType>
+	int CountMismatches( const std::vector<Donya::Vector3> &positions, const std::vector<IndexType> &indices, const std::vector<Donya::TriangleBVH::Ray> &rays, float maxDistance )
+	{
+		Donya::TriangleBVH bvh{};
+		bvh.Build( positions, indices );
+
+		const size_t triangleCount = indices.size() / 3;
+		int mismatchCount = 0;
+		for ( const auto &ray : rays )
+		{
+			float closest = maxDistance;
+			bool  isHit   = false;
+			for ( size_t i = 0; i < triangleCount; ++i )
+			{
+				float distance{};
+				if ( !IntersectTriangle( ray, positions[indices[i * 3 + 0]], positions[indices[i * 3 + 1]], positions[indices[i * 3 + 2]], &distance ) ) { continue; }
+				if ( closest < distance ) { continue; }
+				// else
+
+				closest	= distance;
+				isHit	= true;
+			}
+
+			Donya::TriangleBVH::Hit hit{};
+			const bool isHitBVH = bvh.Intersect( ray, maxDistance, &hit );
+			if ( isHit != isHitBVH )
+			{
+				++mismatchCount;
+				continue;
+			}
+			if ( !isHit ) { continue; }
+			// else
+
+			// The triangles at the same distance are tied, so check the returned triangle by its own distance and barycentric coordinates.
+			const Donya::Vector3 &p0 = positions[indices[hit.triangle * 3 + 0]];
+			const Donya::Vector3 &p1 = positions[indices[hit.triangle * 3 + 1]];
+			const Donya::Vector3 &p2 = positions[indices[hit.triangle * 3 + 2]];
+			float distance{};
+			const bool isValidTriangle = IntersectTriangle( ray, p0, p1, p2, &distance ) && IsNearlyEqual( distance, closest );
+			const Donya::Vector3 onTriangle	= p0 * ( 1.0f - hit.u - hit.v ) + p1 * hit.u + p2 * hit.v;
+			const Donya::Vector3 onRay		= ray.origin + ray.direction * hit.distance;
+			const bool isValidHit = IsNearlyEqual( hit.distance, closest ) && ( onTriangle - onRay ).Length() <= 1.0e-3f;
+			if ( !isValidTriangle || !isValidHit ) { ++mismatchCount; }
+		}
+		return mismatchCount;
+	}
+}
+
+namespace Test
+{
+	bool TriangleBVHPicking()
+	{
+		Random random{ 1234U };
+
+		// The soup of small triangles, it makes many overlapped boxes.
+		constexpr size_t TRIANGLE_COUNT = 3000;
+		std::vector<Donya::Vector3> positions{};
+		positions.reserve( TRIANGLE_COUNT * 3 );
+		for ( size_t i = 0; i < TRIANGLE_COUNT; ++i )
+		{
+			const Donya::Vector3 center{ random.Range( -10.0f, 10.0f ), random.Range( -10.0f, 10.0f ), random.Range( -10.0f, 10.0f ) };
+			for ( int j = 0; j < 3; ++j )
+			{
+				positions.emplace_back( center + Donya::Vector3{ random.Range( -1.0f, 1.0f ), random.Range( -1.0f, 1.0f ), random.Range( -1.0f, 1.0f ) } );
+			}
+		}
+		std::vector<std::uint32_t> indices32( positions.size() );
+		std::vector<std::uint16_t> indices16( positions.size() );
+		for ( size_t i = 0; i < positions.size(); ++i )
+		{
+			indices32[i] = scast<std::uint32_t>( i );
+			indices16[i] = scast<std::uint16_t>( i );
+		}
+
+		constexpr size_t RAY_COUNT = 2000;
+		std::vector<Donya::TriangleBVH::Ray> rays( RAY_COUNT );
+		for ( auto &ray : rays )
+		{
+			ray.origin		= Donya::Vector3{ random.Range( -15.0f, 15.0f ), random.Range( -15.0f, 15.0f ), random.Range( -15.0f, 15.0f ) };
+			ray.direction	= Donya::Vector3{ random.Range( -1.0f, 1.0f ), random.Range( -1.0f, 1.0f ), random.Range( -1.0f, 1.0f ) };
+		}
+		// The axis aligned directions make the infinity in the slab test.
+		rays[0].direction = Donya::Vector3{ 0.0f, 0.0f, 1.0f };
+		rays[1].direction = Donya::Vector3{ 0.0f, -1.0f, 0.0f };
+
+		const int mismatch32	= CountMismatches( positions, indices32, rays, FLT_MAX );
+		const int mismatch16	= CountMismatches( positions, indices16, rays, FLT_MAX );
+		const int mismatchNear	= CountMismatches( positions, indices32, rays, 5.0f );
+		if ( mismatch32 || mismatch16 || mismatchNear )
+		{
+			std::printf( "TriangleBVH: %d(32-bit indices), %d(16-bit indices), %d(max distance) of %d rays are different from the brute force.\n", mismatch32, mismatch16, mismatchNear, scast<int>( RAY_COUNT ) );
+			return false;
+		}
+		// else
+
+		Donya::TriangleBVH empty{};
+		Donya::TriangleBVH::Hit hit{};
+		if ( empty.Intersect( rays[0], FLT_MAX, &hit ) )
+		{
+			std::printf( "TriangleBVH: The empty hierarchy hit a ray.\n" );
+			return false;
+		}
+		// else
+
+		return true;
+	}
+}